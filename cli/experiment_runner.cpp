@@ -5,8 +5,17 @@
 #include "src/core/descriptor/factories/DescriptorFactory.hpp"
 #include "src/core/pooling/PoolingFactory.hpp"
 #include "src/core/matching/MatchingFactory.hpp"
+#include "src/core/matching/BruteForceMatching.hpp"
+#include "src/core/matching/DistanceKernels.hpp"
+#include "src/core/descriptor/quantization/ScalarQuantizer.hpp"
+#include "src/core/descriptor/quantization/ProductQuantizer.hpp"
+#include "src/core/descriptor/quantization/BinaryHasher.hpp"
 #include "src/core/metrics/ExperimentMetrics.hpp"
+#include "src/core/metrics/MetricsAccumulator.hpp"
 #include "src/core/metrics/TrueAveragePrecision.hpp"
+#include "src/core/metrics/PrecisionRecallCurve.hpp"
+#include "src/core/metrics/StratifiedEstimator.hpp"
+#include "src/core/metrics/HPatchesTasks.hpp"
 #include "thesis_project/types.hpp"
 #ifdef BUILD_DATABASE
 #include "thesis_project/database/DatabaseManager.hpp"
@@ -14,6 +23,7 @@
 #include <iostream>
 #include <filesystem>
 #include <numeric>
+#include <algorithm>
 #include <chrono>
 #include <fstream>
 
@@ -25,6 +35,33 @@ struct ProfilingSummary {
     double match_ms = 0.0;
     long total_images = 0;
     long total_kps = 0;
+    // Approximate matching vs brute-force reference (only when an ANN method is configured)
+    bool ann_evaluated = false;
+    double bf_match_ms = 0.0;
+    long ann_recall_hits = 0;    // brute-force matches reproduced by the approximate matcher
+    long ann_recall_total = 0;   // brute-force matches
+    // Reduced-precision descriptors: mAP of the float descriptors on the same queries
+    bool quantized = false;
+    double float_true_map_micro = 0.0;
+    double float_true_map_macro = 0.0;
+    int stored_bytes = 0;        // bytes per stored descriptor at this precision
+    int float_bytes = 0;         // bytes per float32 descriptor
+    long top1_disagreements = 0; // AP queries whose nearest neighbour differs from the float run
+    long top1_queries = 0;
+    // Dataset-level PR curve over each query's nearest neighbour (evaluation.ground_truth.pr_curve_points)
+    bool pr_evaluated = false;
+    PrecisionRecallCurve::Curve pr_curve;
+    // Stratified query subsampling (evaluation.sampling): mAP estimates over scenes / categories
+    bool sampled = false;
+    StratifiedEstimator::Estimate sample_all;
+    StratifiedEstimator::Estimate sample_viewpoint;      // scenes named v_*
+    StratifiedEstimator::Estimate sample_illumination;   // scenes named i_*
+    // HPatches-style tasks over keypoint tracks (evaluation.tasks)
+    long task_tracks = 0;
+    bool verification_evaluated = false;
+    HPatchesTasks::VerificationResult verification;
+    bool retrieval_evaluated = false;
+    HPatchesTasks::RetrievalResult retrieval;
 };
 // Create a simple SIFT detector for independent detection
 static cv::Ptr<cv::Feature2D> makeDetector(const thesis_project::config::ExperimentConfig& cfg) {
@@ -34,19 +71,230 @@ static cv::Ptr<cv::Feature2D> makeDetector(const thesis_project::config::Experim
     return cv::SIFT::create();
 }
 
+// One AP per image-1 keypoint against image 2..6 (homography ground truth).
+// Distances come from the tiled kernels (integer kernels for uint8 codes,
+// popcount for binary codes with NORM_HAMMING). Relevant keypoints are looked
+// up through a grid built once per pair. With ranking_top_k the kernel keeps
+// only each query's K nearest and the competitor counts of its ground truth,
+// so no query x train matrix is built: single-GT AP stays exact, multi-relevant
+// AP becomes AP@K. With sampling (sample_rate / max_queries_per_pair) only a
+// seeded subset of the queries that have a ground-truth keypoint gets distance
+// rows; the rest are not recorded, and the subset feeds sample_estimate (one
+// stratum per scene). With a PR stream, each query's nearest-neighbour
+// distance is recorded (relevant when it ranks first) and queries with a
+// ground-truth keypoint are added to pr_positives. Returns the nearest train
+// row per query (-1 for skipped queries).
+static std::vector<int> addQueryAPs(
+    MetricsAccumulator& metrics,
+    const std::string& scene_name,
+    int pair,
+    const std::vector<cv::KeyPoint>& keypoints1,
+    const cv::Mat& descriptors1,
+    const std::vector<cv::KeyPoint>& keypoints2,
+    const cv::Mat& descriptors2,
+    const cv::Mat& H,
+    const std::vector<uchar>& zero_query,
+    const thesis_project::EvaluationParams& gt,
+    PrecisionRecallCurve::Stream* pr_stream = nullptr,
+    long* pr_positives = nullptr,
+    StratifiedEstimator* sample_estimate = nullptr,
+    int norm_type = cv::NORM_L2SQR
+) {
+    const auto H_arr = TrueAveragePrecision::matToArray(H);
+    std::vector<TrueAveragePrecision::Point2D> points2(keypoints2.size());
+    for (size_t t = 0; t < keypoints2.size(); ++t) points2[t] = {keypoints2[t].pt.x, keypoints2[t].pt.y};
+    const TrueAveragePrecision::KeypointGrid grid2(points2, gt.gt_tau_px);
+    const bool multi = gt.relevance == thesis_project::RelevancePolicy::MULTI;
+    const int top_k = gt.ranking_top_k;
+    const int queries = static_cast<int>(keypoints1.size());
+    auto queryPoint = [&](int q) { return TrueAveragePrecision::Point2D{keypoints1[q].pt.x, keypoints1[q].pt.y}; };
+
+    // Queries that get a distance row; with sampling their descriptors are gathered into query_desc
+    std::vector<int> rows;
+    std::vector<uchar> skipped(queries, 0);
+    const bool sampling = gt.sample_rate < 1.0 || gt.max_queries_per_pair > 0;
+    cv::Mat query_desc = descriptors1;
+    if (sampling) {
+        std::vector<int> eligible;
+        for (int q = 0; q < queries; ++q) {
+            if (!zero_query[q] &&
+                TrueAveragePrecision::findSingleRelevantIndex(queryPoint(q), H_arr, grid2, gt.gt_tau_px) >= 0) {
+                eligible.push_back(q);
+                skipped[q] = 1;
+            }
+        }
+        const auto chosen = StratifiedEstimator::sampleIndices(
+            static_cast<int>(eligible.size()), gt.sample_rate, gt.max_queries_per_pair,
+            StratifiedEstimator::pairSeed(static_cast<uint64_t>(gt.sample_seed), scene_name, pair));
+        for (int i : chosen) {
+            rows.push_back(eligible[i]);
+            skipped[eligible[i]] = 0;
+        }
+        if (sample_estimate) sample_estimate->addPopulation(scene_name, static_cast<long>(eligible.size()));
+
+        query_desc.create(static_cast<int>(rows.size()), descriptors1.cols, descriptors1.type());
+        for (size_t i = 0; i < rows.size(); ++i) descriptors1.row(rows[i]).copyTo(query_desc.row(static_cast<int>(i)));
+    } else {
+        for (int q = 0; q < queries; ++q) if (!zero_query[q]) rows.push_back(q);
+    }
+    auto descRow = [&](size_t i) { return sampling ? static_cast<int>(i) : rows[i]; };
+
+    std::vector<int> nearest(queries, -1);
+    std::vector<float> nearest_dist(queries, 0.0f);
+    std::vector<TrueAveragePrecision::QueryAPResult> results(queries);
+
+    if (rows.empty() || keypoints2.empty()) {
+        // nothing to rank
+    } else if (top_k > 0) {
+        // Ground truth first, so the kernel can count each target's competitors as it scans
+        std::vector<int> targets;
+        if (!multi) {
+            targets.assign(query_desc.rows, -1);
+            for (size_t i = 0; i < rows.size(); ++i) {
+                targets[descRow(i)] = TrueAveragePrecision::findSingleRelevantIndex(queryPoint(rows[i]), H_arr, grid2, gt.gt_tau_px);
+            }
+        }
+        thesis_project::matching::kernels::TopK top;
+        thesis_project::matching::kernels::topKNeighbours(query_desc, descriptors2, norm_type, top_k, targets, top);
+
+        std::vector<int> relevant;
+        for (size_t i = 0; i < rows.size(); ++i) {
+            const int q = rows[i];
+            const int r = descRow(i);
+            const size_t row = static_cast<size_t>(r) * top_k;
+            nearest[q] = top.idx[row];
+            nearest_dist[q] = top.dist[row];
+            if (multi) {
+                TrueAveragePrecision::findRelevantIndices(queryPoint(q), H_arr, grid2, gt.gt_tau_px, relevant);
+                results[q] = TrueAveragePrecision::computeQueryAPFromTopK(top.idx.data() + row, top_k, relevant);
+            } else if (targets[r] >= 0) {
+                results[q] = TrueAveragePrecision::computeQueryAPFromCounts(top.better[r], top.ties[r]);
+            }
+        }
+    } else {
+        const cv::Mat dist = thesis_project::matching::kernels::distanceMatrix(query_desc, descriptors2, norm_type);
+        std::vector<double> dists(keypoints2.size());
+        for (size_t i = 0; i < rows.size(); ++i) {
+            const int q = rows[i];
+            const float* row = dist.ptr<float>(descRow(i));
+            for (int t = 0; t < (int)keypoints2.size(); ++t) dists[t] = row[t];
+            const auto best = std::min_element(dists.begin(), dists.end());
+            nearest[q] = static_cast<int>(best - dists.begin());
+            nearest_dist[q] = static_cast<float>(*best);
+            results[q] = multi
+                ? TrueAveragePrecision::computeQueryAPMultiRelevant(queryPoint(q), H_arr, grid2, dists, gt.gt_tau_px)
+                : TrueAveragePrecision::computeQueryAP(queryPoint(q), H_arr, grid2, dists, gt.gt_tau_px);
+        }
+    }
+
+    const int scene = metrics.sceneId(scene_name);
+    for (int q = 0; q < queries; ++q) {
+        if (zero_query[q]) {
+            auto dummy = TrueAveragePrecision::QueryAPResult{}; dummy.ap = 0.0; dummy.has_potential_match=false;
+            metrics.addQueryAP(scene, dummy);
+            continue;
+        }
+        if (skipped[q]) continue;
+        metrics.addQueryAP(scene, results[q]);
+        if (sample_estimate && results[q].has_potential_match) sample_estimate->addSample(scene_name, results[q].ap);
+        if (pr_stream && nearest[q] >= 0) {
+            pr_stream->add(nearest_dist[q], results[q].rank_of_true_match == 1);
+            if (results[q].has_potential_match && pr_positives) ++*pr_positives;
+        }
+    }
+    return nearest;
+}
+
+// Queries whose nearest train row differs between two runs (reduced
+// precision vs float32); all-zero and sampled-out queries are skipped.
+static long countTop1Disagreements(const std::vector<int>& nearest, const std::vector<int>& reference,
+                                   const std::vector<uchar>& zero_query, long& compared) {
+    long disagreements = 0;
+    for (size_t q = 0; q < nearest.size() && q < reference.size(); ++q) {
+        if (zero_query[q] || nearest[q] < 0 || reference[q] < 0) continue;
+        if (nearest[q] != reference[q]) ++disagreements;
+        ++compared;
+    }
+    return disagreements;
+}
+
+// Single ground-truth keypoint in image 2 for every image-1 keypoint (-1 when none within tau)
+static std::vector<int> findTrackTargets(const std::vector<cv::KeyPoint>& keypoints1,
+                                         const std::vector<cv::KeyPoint>& keypoints2,
+                                         const cv::Mat& H, double tau_px) {
+    const auto H_arr = TrueAveragePrecision::matToArray(H);
+    std::vector<TrueAveragePrecision::Point2D> points2(keypoints2.size());
+    for (size_t t = 0; t < keypoints2.size(); ++t) points2[t] = {keypoints2[t].pt.x, keypoints2[t].pt.y};
+    const TrueAveragePrecision::KeypointGrid grid2(points2, tau_px);
+    std::vector<int> targets(keypoints1.size(), -1);
+    for (size_t q = 0; q < keypoints1.size(); ++q) {
+        targets[q] = TrueAveragePrecision::findSingleRelevantIndex({keypoints1[q].pt.x, keypoints1[q].pt.y},
+                                                                   H_arr, grid2, tau_px);
+    }
+    return targets;
+}
+
+// Tracks are image-1 keypoints with a correspondence in every other image of the
+// scene; a seeded subset of at most tracks_per_scene of them joins the task pool.
+static void addSceneTracks(HPatchesTasks::Evaluator& tasks, const std::string& scene_name,
+                           const std::vector<cv::Mat>& scene_descriptors,
+                           const std::vector<std::vector<int>>& track_targets,
+                           const std::vector<uchar>& zero_query,
+                           const thesis_project::EvaluationParams& params) {
+    const cv::Mat& descriptors1 = scene_descriptors[0];
+    std::vector<int> complete;
+    for (int q = 0; q < descriptors1.rows && q < static_cast<int>(zero_query.size()); ++q) {
+        if (zero_query[q]) continue;
+        bool found = true;
+        for (size_t k = 1; k < track_targets.size() && found; ++k) {
+            found = q < static_cast<int>(track_targets[k].size()) && track_targets[k][q] >= 0 &&
+                    track_targets[k][q] < scene_descriptors[k].rows;
+        }
+        if (found) complete.push_back(q);
+    }
+    const auto chosen = StratifiedEstimator::sampleIndices(
+        static_cast<int>(complete.size()), 1.0, params.task_tracks_per_scene,
+        StratifiedEstimator::pairSeed(static_cast<uint64_t>(params.task_seed), scene_name, 0));
+    std::vector<cv::Mat> positives(track_targets.size() - 1);
+    for (int c : chosen) {
+        const int q = complete[c];
+        for (size_t k = 1; k < track_targets.size(); ++k) {
+            positives[k - 1] = scene_descriptors[k].row(track_targets[k][q]);
+        }
+        tasks.addTrack(scene_name, descriptors1.row(q), positives);
+    }
+}
+
+// DNN descriptor configs from index first on that warp patches with desc's geometry
+static int dnnPatchConsumers(const config::ExperimentConfig& cfg,
+                             const config::ExperimentConfig::DescriptorConfig& desc, size_t first) {
+    if (desc.type != thesis_project::DescriptorType::DNN_PATCH) return 0;
+    int count = 0;
+    for (size_t i = first; i < cfg.descriptors.size(); ++i) {
+        const auto& p = cfg.descriptors[i].params;
+        count += cfg.descriptors[i].type == thesis_project::DescriptorType::DNN_PATCH &&
+                 p.dnn_input_size == desc.params.dnn_input_size &&
+                 p.dnn_support_multiplier == desc.params.dnn_support_multiplier &&
+                 p.dnn_rotate_upright == desc.params.dnn_rotate_upright;
+    }
+    return count;
+}
+
 static ::ExperimentMetrics processDirectoryNew(
     const config::ExperimentConfig& yaml_config,
     const config::ExperimentConfig::DescriptorConfig& desc_config,
 #ifdef BUILD_DATABASE
     thesis_project::database::DatabaseManager* db_ptr,
+    const thesis_project::database::KeypointSetIndex* keypoint_index,
 #else
     void* db_ptr,
+    const void* keypoint_index,
 #endif
     ProfilingSummary& profile
 ) {
     namespace fs = std::filesystem;
-    ::ExperimentMetrics overall;
-    overall.success = true;
+    // Per-scene running sums; folded into ExperimentMetrics once at the end
+    MetricsAccumulator overall;
 
     try {
         if (!fs::exists(yaml_config.dataset.path) || !fs::is_directory(yaml_config.dataset.path)) {
@@ -61,7 +309,7 @@ static ::ExperimentMetrics processDirectoryNew(
             }
             try {
                 LOG_INFO("Creating DNNPatchWrapper with model: " + desc_config.params.dnn_model_path);
-                extractor = std::make_unique<thesis_project::wrappers::DNNPatchWrapper>(
+                auto dnn = std::make_unique<thesis_project::wrappers::DNNPatchWrapper>(
                     desc_config.params.dnn_model_path,
                     desc_config.params.dnn_input_size,
                     desc_config.params.dnn_support_multiplier,
@@ -70,6 +318,9 @@ static ::ExperimentMetrics processDirectoryNew(
                     desc_config.params.dnn_std,
                     desc_config.params.dnn_per_patch_standardize
                 );
+                // Caching raw patches only pays off when another config warps the same ones
+                dnn->setPatchCacheEnabled(dnnPatchConsumers(yaml_config, desc_config, 0) > 1);
+                extractor = std::move(dnn);
                 LOG_INFO("DNNPatchWrapper created successfully");
             } catch (const std::exception& e) {
                 LOG_WARNING("DNNPatchWrapper failed: " + std::string(e.what()));
@@ -77,7 +328,8 @@ static ::ExperimentMetrics processDirectoryNew(
                 extractor = std::make_unique<thesis_project::wrappers::PseudoDNNWrapper>(
                     desc_config.params.dnn_input_size,
                     desc_config.params.dnn_support_multiplier,
-                    desc_config.params.dnn_rotate_upright
+                    desc_config.params.dnn_rotate_upright,
+                    desc_config.params.dnn_fallback_pca
                 );
                 LOG_INFO("Lightweight CNN baseline created successfully");
             }
@@ -85,13 +337,44 @@ static ::ExperimentMetrics processDirectoryNew(
             extractor = thesis_project::factories::DescriptorFactory::create(desc_config.type);
         }
         auto pooling = thesis_project::pooling::PoolingFactory::createFromConfig(desc_config);
-        // Matching: use brute-force L2 with cross-check (current default)
-        auto matcher = thesis_project::matching::MatchingFactory::createStrategy(BRUTE_FORCE);
+        // Matching: configured via evaluation.matching (brute-force L2 with cross-check by default).
+        // Binary descriptor codes are always compared with Hamming distance.
+        const bool binarize = desc_config.params.precision == thesis_project::DescriptorPrecision::BINARY;
+        auto matching_params = yaml_config.evaluation.params;
+        if (binarize) matching_params.norm_type = cv::NORM_HAMMING;
+        auto matcher = thesis_project::matching::MatchingFactory::createFromConfig(matching_params);
+        // Approximate matchers are scored against exact brute-force on the same pairs
+        std::unique_ptr<thesis_project::matching::MatchingStrategy> reference_matcher;
+        if (matcher->isApproximate()) {
+            reference_matcher = std::make_unique<thesis_project::matching::BruteForceMatching>(
+                matching_params.norm_type, matching_params.cross_check);
+        }
 
         // Profiling accumulators
         double detect_ms = 0.0;
         double compute_ms = 0.0;
         double match_ms = 0.0;
+        double bf_match_ms = 0.0;
+        long ann_recall_hits = 0;
+        long ann_recall_total = 0;
+        const bool quantize = desc_config.params.precision == thesis_project::DescriptorPrecision::UINT8;
+        const bool product_quantize = desc_config.params.precision == thesis_project::DescriptorPrecision::PQ;
+        const bool half_precision = desc_config.params.precision == thesis_project::DescriptorPrecision::FP16 ||
+                                    desc_config.params.precision == thesis_project::DescriptorPrecision::BF16;
+        MetricsAccumulator float_overall;  // float-descriptor mAP, only filled when quantizing
+        thesis_project::quantization::ProductQuantizer run_codebook;  // descriptors[].pq.codebook, shared by all scenes
+        thesis_project::quantization::BinaryHasher run_hasher;        // descriptors[].hash.model, shared by all scenes
+        int stored_bytes = 0;
+        int float_bytes = 0;
+        long top1_disagreements = 0;
+        long top1_queries = 0;
+        const auto& eval_params = yaml_config.evaluation.params;
+        std::vector<PrecisionRecallCurve::Stream> pr_streams;  // one sorted stream per image pair
+        long pr_positives = 0;
+        const bool sampling = eval_params.sample_rate < 1.0 || eval_params.max_queries_per_pair > 0;
+        StratifiedEstimator sample_estimate;
+        const bool run_tasks = eval_params.task_verification || eval_params.task_retrieval;
+        HPatchesTasks::Evaluator tasks(binarize ? cv::NORM_HAMMING : cv::NORM_L2SQR);
         long total_images = 0;
         long total_kps = 0;
 
@@ -112,90 +395,171 @@ static ::ExperimentMetrics processDirectoryNew(
                 if (!scene_found) continue;
             }
 
-            ::ExperimentMetrics metrics;
-
-            // Load image1
-            std::string image1_path = scene_folder + "/1.ppm";
-            cv::Mat image1 = cv::imread(image1_path, cv::IMREAD_COLOR);
-            if (image1.empty()) continue;
-            if (!desc_config.params.use_color && image1.channels() > 1) {
-                cv::cvtColor(image1, image1, cv::COLOR_BGR2GRAY);
-            }
-
-            // Get keypoints for image1
-            std::vector<cv::KeyPoint> keypoints1;
-#ifdef BUILD_DATABASE
-            if (yaml_config.keypoints.params.source == thesis_project::KeypointSource::HOMOGRAPHY_PROJECTION && db_ptr) {
-                auto& db = *db_ptr;
-                keypoints1 = db.getLockedKeypoints(scene_name, "1.ppm");
-                if (keypoints1.empty()) {
-                    LOG_ERROR("No locked keypoints for " + scene_name + "/1.ppm");
+            // Load the whole scene (1.ppm .. 6.ppm) with its keypoints so descriptors
+            // can be extracted in a single batched call
+            std::vector<cv::Mat> scene_images;
+            std::vector<std::vector<cv::KeyPoint>> scene_keypoints;
+            std::vector<int> scene_indices;  // image number of each loaded entry
+            for (int i = 1; i <= 6; ++i) {
+                std::string image_name = std::to_string(i) + ".ppm";
+                cv::Mat image = cv::imread(scene_folder + "/" + image_name, cv::IMREAD_COLOR);
+                if (image.empty()) {
+                    if (i == 1) break;  // no reference image, skip scene
                     continue;
                 }
-            } else
-#endif
-            {
-                // Detect fresh keypoints
-                auto det = makeDetector(yaml_config);
-                auto t0 = std::chrono::high_resolution_clock::now();
-                det->detect(image1, keypoints1);
-                auto t1 = std::chrono::high_resolution_clock::now();
-                detect_ms += std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count();
-                LOG_INFO("Detected " + std::to_string(keypoints1.size()) + " keypoints for " + scene_name + "/1.ppm");
-            }
-
-            // Compute descriptors1 via new interface + pooling
-            cv::Mat descriptors1;
-            {
-                auto t0 = std::chrono::high_resolution_clock::now();
-                try {
-                    descriptors1 = pooling->computeDescriptors(image1, keypoints1, *extractor, desc_config);
-                    LOG_INFO("Computed descriptors1: " + std::to_string(descriptors1.rows) + "x" + std::to_string(descriptors1.cols));
-                } catch (const std::exception& e) {
-                    LOG_ERROR("Failed to compute descriptors for " + scene_name + "/1.ppm: " + std::string(e.what()));
-                    continue;
+                if (!desc_config.params.use_color && image.channels() > 1) {
+                    cv::cvtColor(image, image, cv::COLOR_BGR2GRAY);
                 }
-                auto t1 = std::chrono::high_resolution_clock::now();
-                compute_ms += std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count();
-            }
 
-            for (int i = 2; i <= 6; ++i) {
-                std::string image_name = std::to_string(i) + ".ppm";
-                std::string image2_path = scene_folder + "/" + image_name;
-                cv::Mat image2 = cv::imread(image2_path, cv::IMREAD_COLOR);
-                if (image2.empty()) continue;
-            if (!desc_config.params.use_color && image2.channels() > 1) {
-                cv::cvtColor(image2, image2, cv::COLOR_BGR2GRAY);
-            }
-
-                // Get keypoints2
-                std::vector<cv::KeyPoint> keypoints2;
+                std::vector<cv::KeyPoint> keypoints;
 #ifdef BUILD_DATABASE
-                if (yaml_config.keypoints.params.source == thesis_project::KeypointSource::HOMOGRAPHY_PROJECTION && db_ptr) {
+                if (yaml_config.keypoints.params.source == thesis_project::KeypointSource::HOMOGRAPHY_PROJECTION && keypoint_index) {
+                    const auto locked = keypoint_index->find(scene_name, image_name);
+                    keypoints.assign(locked.begin(), locked.end());
+                    if (keypoints.empty()) {
+                        LOG_ERROR("No locked keypoints in set '" + yaml_config.keypoints.params.keypoint_set_name +
+                                  "' for " + scene_name + "/" + image_name);
+                        if (i == 1) break;
+                        continue;
+                    }
+                } else if (yaml_config.keypoints.params.source == thesis_project::KeypointSource::HOMOGRAPHY_PROJECTION && db_ptr) {
                     auto& db = *db_ptr;
-                    keypoints2 = db.getLockedKeypoints(scene_name, image_name);
-                    if (keypoints2.empty()) {
+                    keypoints = db.getLockedKeypoints(scene_name, image_name);
+                    if (keypoints.empty()) {
                         LOG_ERROR("No locked keypoints for " + scene_name + "/" + image_name);
+                        if (i == 1) break;
                         continue;
                     }
                 } else
 #endif
                 {
+                    // Detect fresh keypoints
                     auto det = makeDetector(yaml_config);
                     auto t0 = std::chrono::high_resolution_clock::now();
-                    det->detect(image2, keypoints2);
+                    det->detect(image, keypoints);
                     auto t1 = std::chrono::high_resolution_clock::now();
                     detect_ms += std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count();
+                    if (i == 1) {
+                        LOG_INFO("Detected " + std::to_string(keypoints.size()) + " keypoints for " + scene_name + "/1.ppm");
+                    }
                 }
 
-                // Compute descriptors2
-                cv::Mat descriptors2;
-                {
-                    auto t0 = std::chrono::high_resolution_clock::now();
-                    descriptors2 = pooling->computeDescriptors(image2, keypoints2, *extractor, desc_config);
-                    auto t1 = std::chrono::high_resolution_clock::now();
-                    compute_ms += std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count();
+                scene_images.push_back(image);
+                scene_keypoints.push_back(std::move(keypoints));
+                scene_indices.push_back(i);
+            }
+            if (scene_indices.empty() || scene_indices.front() != 1) continue;
+
+            // Compute descriptors for all images of the scene via new interface + pooling
+            std::vector<cv::Mat> scene_descriptors;
+            {
+                auto t0 = std::chrono::high_resolution_clock::now();
+                try {
+                    scene_descriptors = pooling->computeDescriptorsBatch(scene_images, scene_keypoints, *extractor, desc_config);
+                    LOG_INFO("Computed descriptors1: " + std::to_string(scene_descriptors[0].rows) + "x" + std::to_string(scene_descriptors[0].cols));
+                } catch (const std::exception& e) {
+                    LOG_ERROR("Failed to compute descriptors for " + scene_name + ": " + std::string(e.what()));
+                    continue;
+                }
+                auto t1 = std::chrono::high_resolution_clock::now();
+                compute_ms += std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count();
+            }
+
+            // uint8 mode: quantize with a scale fitted on image 1, keep the float
+            // descriptors to report the accuracy cost of quantization
+            std::vector<cv::Mat> float_descriptors;
+            if (quantize && !scene_descriptors[0].empty()) {
+                const auto quantizer = thesis_project::quantization::ScalarQuantizer::fit(scene_descriptors[0]);
+                float_descriptors = scene_descriptors;
+                for (auto& d : scene_descriptors) d = quantizer.quantize(d);
+                stored_bytes = scene_descriptors[0].cols;
+                float_bytes = scene_descriptors[0].cols * static_cast<int>(sizeof(float));
+            }
+            // pq mode: image 1 stays float (queries), images 2..6 are PQ-encoded and
+            // reconstructed, so AP distances are exactly the asymmetric PQ distances.
+            // Codebooks come from descriptors[].pq.codebook (fitted on the first
+            // scene and written there if missing) or are fitted per scene on image 1.
+            if (product_quantize && !scene_descriptors[0].empty()) {
+                thesis_project::quantization::ProductQuantizer pq = run_codebook;
+                if (!pq.fitted()) {
+                    const std::string& codebook = desc_config.params.pq_codebook;
+                    if (!codebook.empty() && fs::exists(codebook)) {
+                        if (!pq.load(codebook)) throw std::runtime_error("Failed to load PQ codebook: " + codebook);
+                    } else {
+                        thesis_project::quantization::PQParams pq_params;
+                        pq_params.m = desc_config.params.pq_m;
+                        pq_params.bits = desc_config.params.pq_bits;
+                        pq = thesis_project::quantization::ProductQuantizer::fit(scene_descriptors[0], pq_params);
+                        if (!codebook.empty() && !pq.save(codebook)) {
+                            LOG_WARNING("Failed to write PQ codebook to " + codebook);
+                        }
+                    }
+                    if (!codebook.empty()) run_codebook = pq;
+                }
+                float_descriptors = scene_descriptors;
+                for (size_t k = 1; k < scene_descriptors.size(); ++k) {
+                    scene_descriptors[k] = pq.decode(pq.encode(scene_descriptors[k]));
+                }
+                stored_bytes = pq.codeBytes();
+                float_bytes = pq.dims() * static_cast<int>(sizeof(float));
+            }
+            // binary mode: every image is hashed to packed bits (hasher fitted on
+            // image 1, or loaded from / written to descriptors[].hash.model)
+            if (binarize && !scene_descriptors[0].empty()) {
+                thesis_project::quantization::BinaryHasher hasher = run_hasher;
+                if (!hasher.fitted()) {
+                    const std::string& model = desc_config.params.hash_model;
+                    if (!model.empty() && fs::exists(model)) {
+                        if (!hasher.load(model)) throw std::runtime_error("Failed to load binary hasher: " + model);
+                    } else {
+                        thesis_project::quantization::BinaryHashParams hash_params;
+                        hash_params.bits = desc_config.params.hash_bits;
+                        hash_params.projection = desc_config.params.hash_projection;
+                        hasher = thesis_project::quantization::BinaryHasher::fit(scene_descriptors[0], hash_params);
+                        if (!model.empty() && !hasher.save(model)) {
+                            LOG_WARNING("Failed to write binary hasher to " + model);
+                        }
+                    }
+                    if (!model.empty()) run_hasher = hasher;
                 }
+                float_descriptors = scene_descriptors;
+                for (auto& d : scene_descriptors) d = hasher.encode(d);
+                stored_bytes = hasher.codeBytes();
+                float_bytes = hasher.dims() * static_cast<int>(sizeof(float));
+            }
+            // fp16 / bf16 mode: descriptors are stored at 16 bits; the distance kernels
+            // widen them tile by tile and accumulate in float32
+            if (half_precision && !scene_descriptors[0].empty()) {
+                float_descriptors = scene_descriptors;
+                for (auto& d : scene_descriptors) {
+                    if (desc_config.params.precision == thesis_project::DescriptorPrecision::BF16) {
+                        d = thesis_project::matching::kernels::toBFloat16(d);
+                    } else {
+                        cv::Mat half;
+                        d.convertTo(half, CV_16F);
+                        d = half;
+                    }
+                }
+                stored_bytes = scene_descriptors[0].cols * 2;
+                float_bytes = scene_descriptors[0].cols * static_cast<int>(sizeof(float));
+            }
+            const std::vector<cv::KeyPoint>& keypoints1 = scene_keypoints[0];
+            const cv::Mat& descriptors1 = scene_descriptors[0];
+
+            // All-zero float descriptors carry no information; their queries score AP=0
+            const cv::Mat& reference_float = float_descriptors.empty() ? descriptors1 : float_descriptors[0];
+            std::vector<uchar> zero_query(keypoints1.size(), 0);
+            for (int q = 0; q < (int)keypoints1.size() && q < reference_float.rows; ++q) {
+                zero_query[q] = cv::countNonZero(reference_float.row(q)) == 0;
+            }
+
+            // Image-1 keypoint -> ground-truth keypoint in image k (evaluation.tasks)
+            std::vector<std::vector<int>> track_targets(run_tasks ? scene_indices.size() : 0);
+
+            for (size_t k = 1; k < scene_indices.size(); ++k) {
+                const int i = scene_indices[k];
+                const std::vector<cv::KeyPoint>& keypoints2 = scene_keypoints[k];
+                const cv::Mat& descriptors2 = scene_descriptors[k];
                 if (descriptors1.empty() || descriptors2.empty()) continue;
 
                 // Match descriptors
@@ -207,12 +571,24 @@ static ::ExperimentMetrics processDirectoryNew(
                     match_ms += std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count();
                 }
 
+                if (reference_matcher) {
+                    auto t0 = std::chrono::high_resolution_clock::now();
+                    const auto exact = reference_matcher->matchDescriptors(descriptors1, descriptors2);
+                    auto t1 = std::chrono::high_resolution_clock::now();
+                    bf_match_ms += std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count();
+
+                    std::vector<int> approx_nn(descriptors1.rows, -1);
+                    for (const auto& m : matches) approx_nn[m.queryIdx] = m.trainIdx;
+                    for (const auto& m : exact) if (approx_nn[m.queryIdx] == m.trainIdx) ++ann_recall_hits;
+                    ann_recall_total += static_cast<long>(exact.size());
+                }
+
                 // Legacy precision using index equality (if locked)
                 int correctMatches = 0;
                 if (yaml_config.keypoints.params.source == thesis_project::KeypointSource::HOMOGRAPHY_PROJECTION && !matches.empty()) {
                     for (const auto& m : matches) if (m.queryIdx == m.trainIdx) ++correctMatches;
                     double precision = matches.empty() ? 0.0 : (double)correctMatches / matches.size();
-                    metrics.addImageResult(scene_name, precision, (int)matches.size(), (int)keypoints2.size());
+                    overall.addImageResult(overall.sceneId(scene_name), precision, (int)matches.size(), (int)keypoints2.size());
                 }
 
                 // True mAP via homography if available
@@ -225,44 +601,92 @@ static ::ExperimentMetrics processDirectoryNew(
                     hfile.close();
                 }
                 if (!H.empty() && !keypoints1.empty() && !keypoints2.empty()) {
-                    for (int q = 0; q < (int)keypoints1.size(); ++q) {
-                        cv::Mat qdesc = descriptors1.row(q);
-                        if (qdesc.empty() || cv::norm(qdesc) == 0.0) {
-                            auto dummy = TrueAveragePrecision::QueryAPResult{}; dummy.ap = 0.0; dummy.has_potential_match=false;
-                            metrics.addQueryAP(scene_name, dummy);
-                            continue;
-                        }
-                        std::vector<double> dists; dists.reserve(keypoints2.size());
-                        for (int t = 0; t < (int)keypoints2.size(); ++t) {
-                            cv::Mat tdesc = descriptors2.row(t);
-                            if (tdesc.empty()) { dists.push_back(std::numeric_limits<double>::infinity()); continue; }
-                            double dist = cv::norm(qdesc, tdesc, cv::NORM_L2SQR);
-                            dists.push_back(dist);
-                        }
-                        auto ap = TrueAveragePrecision::computeQueryAP(
-                            keypoints1[q], H, keypoints2, dists, 3.0
-                        );
-                        metrics.addQueryAP(scene_name, ap);
+                    PrecisionRecallCurve::Stream* pr_stream = nullptr;
+                    if (eval_params.pr_curve_points > 0) {
+                        pr_streams.emplace_back();
+                        pr_stream = &pr_streams.back();
                     }
+                    const std::vector<int> nearest = addQueryAPs(overall, scene_name, static_cast<int>(k), keypoints1,
+                                                                 descriptors1, keypoints2, descriptors2, H, zero_query,
+                                                                 eval_params, pr_stream, &pr_positives,
+                                                                 sampling ? &sample_estimate : nullptr,
+                                                                 binarize ? cv::NORM_HAMMING : cv::NORM_L2SQR);
+                    if (pr_stream) pr_stream->finish();
+                    if (!float_descriptors.empty()) {
+                        const std::vector<int> float_nearest = addQueryAPs(float_overall, scene_name, static_cast<int>(k),
+                                                                           keypoints1, float_descriptors[0], keypoints2,
+                                                                           float_descriptors[k], H, zero_query, eval_params);
+                        top1_disagreements += countTop1Disagreements(nearest, float_nearest, zero_query, top1_queries);
+                    }
+                    if (run_tasks) track_targets[k] = findTrackTargets(keypoints1, keypoints2, H, eval_params.gt_tau_px);
                 }
             }
+            if (run_tasks && !descriptors1.empty()) {
+                addSceneTracks(tasks, scene_name, scene_descriptors, track_targets, zero_query, eval_params);
+            }
 
-            // finalize per-scene
-            metrics.calculateMeanPrecision();
-            overall.merge(metrics);
             total_images += 5;
             total_kps += static_cast<long>(keypoints1.size());
         }
 
-        overall.calculateMeanPrecision();
-        overall.success = true;
+        if (desc_config.type == thesis_project::DescriptorType::DNN_PATCH) {
+            const auto cs = thesis_project::extractors::PatchCache::instance().stats();
+            LOG_INFO("Patch cache: " + std::to_string(cs.hits) + " hits, " + std::to_string(cs.misses) +
+                     " misses, " + std::to_string(cs.entries) + " entries (" +
+                     std::to_string(cs.bytes / (1024 * 1024)) + " MiB)");
+        }
+
+        ::ExperimentMetrics metrics = overall.toExperimentMetrics();
+        if (yaml_config.evaluation.params.bootstrap_resamples > 0) {
+            metrics.computeBootstrapCI(yaml_config.evaluation.params.bootstrap_resamples,
+                                       yaml_config.evaluation.params.bootstrap_confidence,
+                                       static_cast<uint64_t>(yaml_config.evaluation.params.bootstrap_seed));
+        }
         // Export profiling to caller
         profile.detect_ms = detect_ms;
         profile.compute_ms = compute_ms;
         profile.match_ms = match_ms;
+        profile.ann_evaluated = static_cast<bool>(reference_matcher);
+        profile.bf_match_ms = bf_match_ms;
+        profile.ann_recall_hits = ann_recall_hits;
+        profile.ann_recall_total = ann_recall_total;
+        if (quantize || product_quantize || binarize || half_precision) {
+            const ::ExperimentMetrics float_metrics = float_overall.toExperimentMetrics();
+            profile.quantized = true;
+            profile.float_true_map_micro = float_metrics.true_map_micro;
+            profile.float_true_map_macro = float_metrics.true_map_macro_by_scene;
+            profile.stored_bytes = stored_bytes;
+            profile.float_bytes = float_bytes;
+            profile.top1_disagreements = top1_disagreements;
+            profile.top1_queries = top1_queries;
+        }
+        if (eval_params.pr_curve_points > 0) {
+            profile.pr_evaluated = true;
+            profile.pr_curve = PrecisionRecallCurve::merge(pr_streams, pr_positives, eval_params.pr_curve_points);
+        }
+        if (sampling) {
+            profile.sampled = true;
+            profile.sample_all = sample_estimate.estimate();
+            profile.sample_viewpoint = sample_estimate.estimate("v_");
+            profile.sample_illumination = sample_estimate.estimate("i_");
+        }
+        profile.task_tracks = static_cast<long>(tasks.tracks());
+        if (eval_params.task_verification) {
+            profile.verification_evaluated = true;
+            profile.verification = tasks.evaluateVerification(static_cast<uint64_t>(eval_params.task_seed));
+        }
+        if (eval_params.task_retrieval) {
+            thesis_project::matching::HnswParams ann;
+            ann.M = eval_params.hnsw_m;
+            ann.ef_construction = eval_params.hnsw_ef_construction;
+            ann.ef_search = eval_params.hnsw_ef_search;
+            profile.retrieval_evaluated = true;
+            profile.retrieval = tasks.evaluateRetrieval(eval_params.retrieval_top_k,
+                                                        eval_params.retrieval_ann ? &ann : nullptr);
+        }
         profile.total_images = total_images;
         profile.total_kps = total_kps;
-        return overall;
+        return metrics;
     } catch (const std::exception& e) {
         return ::ExperimentMetrics::createError(e.what());
     }
@@ -307,13 +731,37 @@ int main(int argc, char** argv) {
             db_enabled = true;
         }
 
-        thesis_project::database::DatabaseManager db(db_path, db_enabled);
+        auto db_config = db_enabled ? thesis_project::database::DatabaseConfig::sqlite(db_path)
+                                    : thesis_project::database::DatabaseConfig::disabled();
+        db_config.async_writes = yaml_config.database.async_writes;
+        db_config.write_queue_capacity = static_cast<size_t>(yaml_config.database.write_queue_capacity);
+        db_config.concurrent_reads = true;  // runs in WAL mode anyway (optimizeForBulkOperations)
+        thesis_project::database::DatabaseManager db(db_config);
         if (db.isEnabled()) {
             db.optimizeForBulkOperations();
             LOG_INFO("Database tracking enabled");
         } else {
             LOG_INFO("Database tracking disabled");
         }
+
+        // Locked keypoints of keypoints.keypoint_set_name, loaded once and shared by every descriptor
+        thesis_project::database::KeypointSetIndex keypoint_index;
+        const bool preload_keypoints = db.isEnabled() &&
+            yaml_config.keypoints.params.source == thesis_project::KeypointSource::HOMOGRAPHY_PROJECTION &&
+            !yaml_config.keypoints.params.keypoint_set_name.empty();
+        if (preload_keypoints) {
+            const std::string& set_name = yaml_config.keypoints.params.keypoint_set_name;
+            const int set_id = db.getKeypointSetId(set_name);
+            if (set_id < 0) {
+                throw std::runtime_error("Keypoint set not found in database: " + set_name);
+            }
+            auto t0 = std::chrono::high_resolution_clock::now();
+            keypoint_index = db.loadKeypointSet(set_id);
+            auto t1 = std::chrono::high_resolution_clock::now();
+            LOG_INFO("Loaded keypoint set '" + set_name + "': " + std::to_string(keypoint_index.size()) +
+                     " keypoints over " + std::to_string(keypoint_index.images()) + " images in " +
+                     std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count()) + " ms");
+        }
 #endif
 
         LOG_INFO("Experiment: " + yaml_config.experiment.name);
@@ -357,10 +805,20 @@ int main(int argc, char** argv) {
             auto experiment_metrics = processDirectoryNew(yaml_config, desc_config,
 #ifdef BUILD_DATABASE
                 &db,
+                preload_keypoints ? &keypoint_index : nullptr,
 #else
                 nullptr,
+                nullptr,
 #endif
                 profile);
+
+            // The last DNN config with this patch geometry releases the shared patches
+            if (desc_config.type == thesis_project::DescriptorType::DNN_PATCH &&
+                dnnPatchConsumers(yaml_config, desc_config, i + 1) == 0) {
+                thesis_project::extractors::PatchCache::instance().releaseGeometry(
+                    desc_config.params.dnn_input_size, desc_config.params.dnn_support_multiplier,
+                    desc_config.params.dnn_rotate_upright);
+            }
             
 #ifdef BUILD_DATABASE
             if (experiment_id != -1) {
@@ -389,6 +847,40 @@ int main(int argc, char** argv) {
                 results.metadata["detect_time_ms"] = std::to_string(profile.detect_ms);
                 results.metadata["compute_time_ms"] = std::to_string(profile.compute_ms);
                 results.metadata["match_time_ms"] = std::to_string(profile.match_ms);
+                results.metadata["matching_method"] = toString(yaml_config.evaluation.params.matching_method);
+                results.metadata["descriptor_precision"] = toString(desc_config.params.precision);
+                if (profile.quantized) {
+                    results.metadata["float_true_map_micro"] = std::to_string(profile.float_true_map_micro);
+                    results.metadata["float_true_map_macro"] = std::to_string(profile.float_true_map_macro);
+                    results.metadata["precision_map_delta"] =
+                        std::to_string(experiment_metrics.true_map_micro - profile.float_true_map_micro);
+                    if (profile.stored_bytes > 0) {
+                        results.metadata["descriptor_bytes"] = std::to_string(profile.stored_bytes);
+                        results.metadata["compression_ratio"] =
+                            std::to_string(static_cast<double>(profile.float_bytes) / profile.stored_bytes);
+                    }
+                    if (profile.top1_queries > 0) {
+                        results.metadata["top1_disagreements"] = std::to_string(profile.top1_disagreements);
+                        results.metadata["top1_disagreement_rate"] = std::to_string(
+                            static_cast<double>(profile.top1_disagreements) / profile.top1_queries);
+                    }
+                    LOG_INFO(toString(desc_config.params.precision) + " descriptors: true mAP " +
+                             std::to_string(experiment_metrics.true_map_micro) + " vs float " +
+                             std::to_string(profile.float_true_map_micro));
+                }
+                if (profile.ann_evaluated) {
+                    const double recall = profile.ann_recall_total > 0
+                        ? static_cast<double>(profile.ann_recall_hits) / profile.ann_recall_total : 0.0;
+                    results.metadata["ann_recall_at_1"] = std::to_string(recall);
+                    results.metadata["ann_match_ms"] = std::to_string(profile.match_ms);
+                    results.metadata["bf_match_ms"] = std::to_string(profile.bf_match_ms);
+                    if (profile.match_ms > 0.0) {
+                        results.metadata["ann_speedup"] = std::to_string(profile.bf_match_ms / profile.match_ms);
+                    }
+                    LOG_INFO("ANN vs brute-force: recall@1=" + std::to_string(recall) +
+                             ", match " + std::to_string(profile.match_ms) + " ms vs " +
+                             std::to_string(profile.bf_match_ms) + " ms");
+                }
                 results.metadata["total_images"] = std::to_string(profile.total_images);
                 results.metadata["total_keypoints"] = std::to_string(profile.total_kps);
                 double total_sec = duration.count() > 0 ? (duration.count() / 1000.0) : 0.0;
@@ -412,26 +904,88 @@ int main(int argc, char** argv) {
                 results.metadata["recall_at_1"] = std::to_string(experiment_metrics.recall_at_1);
                 results.metadata["recall_at_5"] = std::to_string(experiment_metrics.recall_at_5);
                 results.metadata["recall_at_10"] = std::to_string(experiment_metrics.recall_at_10);
+                // Scene-level bootstrap confidence intervals
+                if (experiment_metrics.bootstrap_resamples > 0) {
+                    results.metadata["bootstrap_resamples"] = std::to_string(experiment_metrics.bootstrap_resamples);
+                    results.metadata["bootstrap_confidence"] = std::to_string(experiment_metrics.bootstrap_confidence);
+                    results.metadata["true_map_micro_ci_low"] = std::to_string(experiment_metrics.true_map_micro_ci.lower);
+                    results.metadata["true_map_micro_ci_high"] = std::to_string(experiment_metrics.true_map_micro_ci.upper);
+                    results.metadata["true_map_macro_ci_low"] = std::to_string(experiment_metrics.true_map_macro_ci.lower);
+                    results.metadata["true_map_macro_ci_high"] = std::to_string(experiment_metrics.true_map_macro_ci.upper);
+                    results.metadata["precision_at_1_ci_low"] = std::to_string(experiment_metrics.precision_at_1_ci.lower);
+                    results.metadata["precision_at_1_ci_high"] = std::to_string(experiment_metrics.precision_at_1_ci.upper);
+                }
+                results.metadata["relevance_policy"] = toString(yaml_config.evaluation.params.relevance);
+                if (profile.sampled) {
+                    results.metadata["sample_rate"] = std::to_string(yaml_config.evaluation.params.sample_rate);
+                    results.metadata["max_queries_per_pair"] = std::to_string(yaml_config.evaluation.params.max_queries_per_pair);
+                    results.metadata["sampled_queries"] = std::to_string(profile.sample_all.sampled);
+                    results.metadata["sampling_population"] = std::to_string(profile.sample_all.population);
+                    results.metadata["estimated_true_map"] = std::to_string(profile.sample_all.mean);
+                    results.metadata["estimated_true_map_se"] = std::to_string(profile.sample_all.standard_error);
+                    if (profile.sample_viewpoint.sampled > 0) {
+                        results.metadata["estimated_true_map_viewpoint"] = std::to_string(profile.sample_viewpoint.mean);
+                        results.metadata["estimated_true_map_viewpoint_se"] = std::to_string(profile.sample_viewpoint.standard_error);
+                    }
+                    if (profile.sample_illumination.sampled > 0) {
+                        results.metadata["estimated_true_map_illumination"] = std::to_string(profile.sample_illumination.mean);
+                        results.metadata["estimated_true_map_illumination_se"] = std::to_string(profile.sample_illumination.standard_error);
+                    }
+                    LOG_INFO("Sampled " + std::to_string(profile.sample_all.sampled) + " of " +
+                             std::to_string(profile.sample_all.population) + " queries: estimated true mAP " +
+                             std::to_string(profile.sample_all.mean) + " +/- " +
+                             std::to_string(profile.sample_all.standard_error));
+                }
+                if (profile.verification_evaluated || profile.retrieval_evaluated) {
+                    results.metadata["task_tracks"] = std::to_string(profile.task_tracks);
+                }
+                if (profile.verification_evaluated) {
+                    results.metadata["verification_ap_intra"] = std::to_string(profile.verification.ap_intra);
+                    results.metadata["verification_ap_inter"] = std::to_string(profile.verification.ap_inter);
+                    results.metadata["verification_auc"] = std::to_string(profile.verification.roc_auc);
+                    results.metadata["verification_fpr95"] = std::to_string(profile.verification.fpr95);
+                    results.metadata["verification_pairs"] = std::to_string(profile.verification.positive_pairs +
+                                                                            profile.verification.negative_pairs);
+                }
+                if (profile.retrieval_evaluated) {
+                    results.metadata["retrieval_map"] = std::to_string(profile.retrieval.map);
+                    results.metadata["retrieval_queries"] = std::to_string(profile.retrieval.queries);
+                    results.metadata["retrieval_pool"] = std::to_string(profile.retrieval.pool_size);
+                    results.metadata["retrieval_top_k"] = std::to_string(profile.retrieval.top_k);
+                    results.metadata["retrieval_search"] = profile.retrieval.approximate ? "hnsw" : "exact";
+                    LOG_INFO("Retrieval over " + std::to_string(profile.task_tracks) + " tracks: mAP@" +
+                             std::to_string(profile.retrieval.top_k) + " " + std::to_string(profile.retrieval.map));
+                }
+                if (profile.pr_evaluated) {
+                    // "threshold:precision:recall" points, ascending threshold
+                    std::string curve;
+                    for (const auto& p : profile.pr_curve.points) {
+                        if (!curve.empty()) curve += ";";
+                        curve += std::to_string(p.threshold) + ":" + std::to_string(p.precision) + ":" +
+                                 std::to_string(p.recall);
+                    }
+                    results.metadata["pr_curve"] = curve;
+                    results.metadata["pr_average_precision"] = std::to_string(profile.pr_curve.average_precision);
+                    results.metadata["pr_positives"] = std::to_string(profile.pr_curve.positives);
+                }
                 // R=0 rate for transparency
                 int total_all = experiment_metrics.total_queries_processed + experiment_metrics.total_queries_excluded;
                 double r0_rate = total_all > 0 ? (double)experiment_metrics.total_queries_excluded / total_all : 0.0;
                 results.metadata["r0_rate"] = std::to_string(r0_rate);
                 
                 // Per-scene True mAP breakdown
-                for (const auto& [scene_name, scene_aps] : experiment_metrics.per_scene_ap) {
-                    if (scene_aps.empty()) continue;
+                for (const auto& [scene_name, scene_ap] : experiment_metrics.per_scene_ap) {
+                    if (scene_ap.queries == 0) continue;
                     
-                    double scene_ap_sum = std::accumulate(scene_aps.begin(), scene_aps.end(), 0.0);
-                    double scene_true_map = scene_ap_sum / static_cast<double>(scene_aps.size());
-                    results.metadata[scene_name + "_true_map"] = std::to_string(scene_true_map);
-                    results.metadata[scene_name + "_query_count"] = std::to_string(scene_aps.size());
+                    results.metadata[scene_name + "_true_map"] = std::to_string(scene_ap.mean());
+                    results.metadata[scene_name + "_query_count"] = std::to_string(scene_ap.queries);
                     
                     // Per-scene with zeros (punitive)
                     int excluded_count = experiment_metrics.per_scene_excluded.count(scene_name) ? 
                                        experiment_metrics.per_scene_excluded.at(scene_name) : 0;
-                    int total_scene_queries = static_cast<int>(scene_aps.size()) + excluded_count;
+                    int total_scene_queries = scene_ap.queries + excluded_count;
                     if (total_scene_queries > 0) {
-                        double scene_true_map_with_zeros = scene_ap_sum / static_cast<double>(total_scene_queries);
+                        double scene_true_map_with_zeros = scene_ap.ap_sum / static_cast<double>(total_scene_queries);
                         results.metadata[scene_name + "_true_map_with_zeros"] = std::to_string(scene_true_map_with_zeros);
                         results.metadata[scene_name + "_excluded_count"] = std::to_string(excluded_count);
                     }
@@ -448,6 +1002,11 @@ int main(int argc, char** argv) {
             }
         }
 
+#ifdef BUILD_DATABASE
+        if (!db.flush()) {
+            LOG_ERROR("Some queued database writes failed; see messages above");
+        }
+#endif
         LOG_INFO("🎉 Experiment completed: " + yaml_config.experiment.name);
         LOG_INFO("📊 Experiment results saved to database");
 
@@ -0,0 +1,119 @@
+#include "src/core/descriptor/extractors/wrappers/PseudoDNNWrapper.hpp"
+#include "thesis_project/logging.hpp"
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace thesis_project;
+
+/**
+ * @brief Offline PCA training for the PseudoDNN fallback descriptor
+ *
+ * Samples images across the dataset (deterministically: scenes in sorted
+ * order, evenly strided), detects SIFT keypoints, computes the pre-PCA
+ * PseudoDNN features and writes the fitted projection to disk. Point
+ * descriptors[].dnn.fallback_pca at the output file to use it.
+ */
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cout << "Usage: " << argv[0] << " <data_folder> <output.yml> [options]" << std::endl;
+        std::cout << "Options:" << std::endl;
+        std::cout << "  --input-size <n>          Patch size (default 32)" << std::endl;
+        std::cout << "  --support-multiplier <f>  Support window relative to keypoint size (default 1.0)" << std::endl;
+        std::cout << "  --no-rotate               Do not rotate patches to upright" << std::endl;
+        std::cout << "  --max-images <n>          Images sampled across the dataset (default 60)" << std::endl;
+        std::cout << "  --max-keypoints <n>       SIFT keypoints per sampled image (default 500)" << std::endl;
+        std::cout << "Example: " << argv[0] << " ../data ../models/pseudo_dnn_pca.yml --support-multiplier 3.0" << std::endl;
+        return 1;
+    }
+
+    const std::string data_folder = argv[1];
+    const std::string output_path = argv[2];
+    int input_size = 32;
+    float support_multiplier = 1.0f;
+    bool rotate_upright = true;
+    int max_images = 60;
+    int max_keypoints = 500;
+
+    for (int a = 3; a < argc; ++a) {
+        const std::string opt = argv[a];
+        const bool has_value = a + 1 < argc;
+        if (opt == "--input-size" && has_value) input_size = std::stoi(argv[++a]);
+        else if (opt == "--support-multiplier" && has_value) support_multiplier = std::stof(argv[++a]);
+        else if (opt == "--no-rotate") rotate_upright = false;
+        else if (opt == "--max-images" && has_value) max_images = std::stoi(argv[++a]);
+        else if (opt == "--max-keypoints" && has_value) max_keypoints = std::stoi(argv[++a]);
+        else {
+            std::cerr << "❌ Unknown or incomplete option: " << opt << std::endl;
+            return 1;
+        }
+    }
+
+    namespace fs = std::filesystem;
+    if (!fs::exists(data_folder) || !fs::is_directory(data_folder)) {
+        std::cerr << "❌ Data folder does not exist: " << data_folder << std::endl;
+        return 1;
+    }
+
+    // Collect all candidate images in a stable order
+    std::vector<std::string> scenes;
+    for (const auto& entry : fs::directory_iterator(data_folder)) {
+        if (entry.is_directory()) scenes.push_back(entry.path().string());
+    }
+    std::sort(scenes.begin(), scenes.end());
+
+    std::vector<std::string> images;
+    for (const auto& scene : scenes) {
+        for (int i = 1; i <= 6; ++i) {
+            const std::string path = scene + "/" + std::to_string(i) + ".ppm";
+            if (fs::exists(path)) images.push_back(path);
+        }
+    }
+    if (images.empty()) {
+        std::cerr << "❌ No .ppm images found under " << data_folder << std::endl;
+        return 1;
+    }
+
+    const size_t stride = std::max<size_t>(1, images.size() / static_cast<size_t>(std::max(1, max_images)));
+    wrappers::PseudoDNNWrapper wrapper(input_size, support_multiplier, rotate_upright);
+    auto detector = cv::SIFT::create(max_keypoints);
+
+    std::vector<cv::Mat> per_image;
+    int used_images = 0;
+    for (size_t idx = 0; idx < images.size() && used_images < max_images; idx += stride) {
+        cv::Mat image = cv::imread(images[idx], cv::IMREAD_GRAYSCALE);
+        if (image.empty()) continue;
+
+        std::vector<cv::KeyPoint> keypoints;
+        detector->detect(image, keypoints);
+        if (keypoints.empty()) continue;
+
+        per_image.push_back(wrapper.computeRawFeatures(image, keypoints));
+        ++used_images;
+    }
+
+    if (per_image.empty()) {
+        std::cerr << "❌ No keypoints detected in sampled images" << std::endl;
+        return 1;
+    }
+    cv::Mat samples;
+    cv::vconcat(per_image, samples);
+    if (samples.rows < wrapper.descriptorSize()) {
+        std::cerr << "❌ Not enough samples for PCA: " << samples.rows << std::endl;
+        return 1;
+    }
+
+    LOG_INFO("Fitting PseudoDNN PCA on " + std::to_string(samples.rows) + " patches from " +
+             std::to_string(used_images) + " images");
+    wrapper.fitPCA(samples);
+
+    if (!wrapper.savePCA(output_path)) {
+        std::cerr << "❌ Failed to write PCA to " << output_path << std::endl;
+        return 1;
+    }
+    LOG_INFO("✅ PseudoDNN PCA written to " + output_path);
+    return 0;
+}
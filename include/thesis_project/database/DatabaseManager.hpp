@@ -4,6 +4,8 @@
 #include <string>
 #include <memory>
 #include <map>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include <opencv2/opencv.hpp>
 #include <opencv2/features2d.hpp>
@@ -16,12 +18,61 @@ struct ExperimentResults;
 struct ExperimentConfig;
 struct DatabaseConfig;
 
+/**
+ * @brief Locked keypoints of one keypoint set held in memory (DatabaseManager::loadKeypointSet)
+ *
+ * All keypoints sit in one array ordered by scene, image and insertion
+ * order. Each image maps to a contiguous range of it, so find() is a hash
+ * lookup that returns a view, with no query and no copy.
+ */
+class KeypointSetIndex {
+public:
+    struct Range {
+        const cv::KeyPoint* data = nullptr;
+        size_t size = 0;
+
+        const cv::KeyPoint* begin() const { return data; }
+        const cv::KeyPoint* end() const { return data + size; }
+        bool empty() const { return size == 0; }
+    };
+
+    /**
+     * @brief Keypoints of scene_name/image_name (empty range if the set has none)
+     */
+    Range find(const std::string& scene_name, const std::string& image_name) const;
+
+    size_t size() const { return keypoints_.size(); }
+    size_t images() const;
+    bool empty() const { return keypoints_.empty(); }
+
+private:
+    friend class DatabaseManager;
+
+    std::vector<cv::KeyPoint> keypoints_;
+    // scene -> image -> (offset, count) into keypoints_
+    std::unordered_map<std::string, std::unordered_map<std::string, std::pair<size_t, size_t>>> ranges_;
+};
+
 /**
  * @brief Optional database manager for experiment tracking
  *
  * This class provides experiment tracking capabilities without disrupting
  * the existing workflow. All methods are safe to call - if database is
  * disabled, they silently do nothing.
+ *
+ * With DatabaseConfig::async_writes, recordExperiment, storeDescriptors and
+ * the keypoint store methods copy their input onto a bounded queue and
+ * return once it is queued. A writer thread commits queued writes in
+ * batches (one transaction per batch) through statements prepared once.
+ * Callers block only while the queue is full. Every other method, and the
+ * destructor, first waits for queued writes to land, so reads always see
+ * earlier writes. Call flush() to learn whether queued writes succeeded.
+ *
+ * Every query is prepared once per connection and cached by its SQL text.
+ * With DatabaseConfig::concurrent_reads the database switches to WAL mode and
+ * read methods (getLockedKeypoints and the other getters) run on a read-only
+ * connection owned by the calling thread, so parallel workers read without
+ * serialising on the writer's connection.
  */
 class DatabaseManager {
 public:
@@ -61,10 +112,16 @@ public:
      */
     bool optimizeForBulkOperations() const;
 
+    /**
+     * @brief Wait until all queued writes are committed (no-op for synchronous writes)
+     * @return true if no queued write failed since the previous flush
+     */
+    bool flush() const;
+
     /**
      * @brief Record experiment results
      * @param results Results from descriptor comparison experiment
-     * @return true if successfully recorded (or disabled), false on error
+     * @return true if successfully recorded or queued (or disabled), false on error
      */
     bool recordExperiment(const ExperimentResults& results) const;
 
@@ -185,6 +242,19 @@ public:
      */
     std::vector<std::tuple<int, std::string, std::string>> getAvailableKeypointSets() const;
 
+    /**
+     * @brief Look up a keypoint set by name
+     * @return keypoint_set_id, or -1 if there is no such set (or disabled)
+     */
+    int getKeypointSetId(const std::string& name) const;
+
+    /**
+     * @brief Load a whole keypoint set in one ordered scan
+     * @param keypoint_set_id ID of the keypoint set
+     * @return Index of every scene/image in the set (empty if not found or disabled)
+     */
+    KeypointSetIndex loadKeypointSet(int keypoint_set_id) const;
+
     /**
      * @brief Store descriptors for keypoints in an experiment
      * @param experiment_id ID of the experiment these descriptors belong to
@@ -256,6 +326,9 @@ struct DatabaseConfig {
     bool enabled = false;
     int connection_timeout = 30;
     bool create_if_missing = true;
+    bool async_writes = false;           // write-behind queue with a dedicated writer thread
+    size_t write_queue_capacity = 256;   // queued writes before producers block
+    bool concurrent_reads = false;       // WAL mode plus one read-only connection per calling thread
 
     // Factory methods
     static DatabaseConfig disabled() {
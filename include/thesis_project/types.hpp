@@ -105,7 +105,11 @@ namespace thesis_project {
      */
     enum class MatchingMethod {
         BRUTE_FORCE,
-        FLANN
+        FLANN,
+        RATIO_TEST,
+        HNSW,
+        PQ,
+        HASH
     };
 
     /**
@@ -117,6 +121,34 @@ namespace thesis_project {
         NONE
     };
 
+    /**
+     * @brief Storage precision of descriptors used for matching and evaluation
+     */
+    enum class DescriptorPrecision {
+        FLOAT32,
+        UINT8,      // scalar-quantized codes, integer distance kernels
+        PQ,         // product-quantized train side, reconstructed for evaluation
+        BINARY,     // sign-of-projection bit codes, Hamming distances
+        FP16,       // IEEE half storage, float32 accumulation
+        BF16        // bfloat16 storage (CV_16U bit pattern), float32 accumulation
+    };
+
+    /**
+     * @brief Projection used to binarize float descriptors
+     */
+    enum class BinaryProjection {
+        RANDOM,     // centered random Gaussian hyperplanes (SimHash)
+        ITQ         // PCA + learned rotation (iterative quantization)
+    };
+
+    /**
+     * @brief Which keypoints in image B count as relevant for a query in A
+     */
+    enum class RelevancePolicy {
+        SINGLE,     // nearest keypoint within tau_px only (R=1, AP = 1/rank)
+        MULTI       // every keypoint within tau_px (R >= 1)
+    };
+
     // ================================
     // CONVERSION FUNCTIONS FOR COMPATIBILITY
     // ================================
@@ -243,6 +275,10 @@ namespace thesis_project {
         switch (method) {
             case MatchingMethod::BRUTE_FORCE: return "brute_force";
             case MatchingMethod::FLANN: return "flann";
+            case MatchingMethod::RATIO_TEST: return "ratio_test";
+            case MatchingMethod::HNSW: return "hnsw";
+            case MatchingMethod::PQ: return "pq";
+            case MatchingMethod::HASH: return "hash";
             default: return "unknown";
         }
     }
@@ -256,6 +292,34 @@ namespace thesis_project {
         }
     }
 
+    inline std::string toString(DescriptorPrecision precision) {
+        switch (precision) {
+            case DescriptorPrecision::FLOAT32: return "float32";
+            case DescriptorPrecision::UINT8: return "uint8";
+            case DescriptorPrecision::PQ: return "pq";
+            case DescriptorPrecision::BINARY: return "binary";
+            case DescriptorPrecision::FP16: return "fp16";
+            case DescriptorPrecision::BF16: return "bf16";
+            default: return "unknown";
+        }
+    }
+
+    inline std::string toString(BinaryProjection projection) {
+        switch (projection) {
+            case BinaryProjection::RANDOM: return "random";
+            case BinaryProjection::ITQ: return "itq";
+            default: return "unknown";
+        }
+    }
+
+    inline std::string toString(RelevancePolicy policy) {
+        switch (policy) {
+            case RelevancePolicy::SINGLE: return "single";
+            case RelevancePolicy::MULTI: return "multi";
+            default: return "unknown";
+        }
+    }
+
     // ================================
     // DSP SCALE WEIGHTING
     // ================================
@@ -292,6 +356,13 @@ namespace thesis_project {
         bool normalize_after_pooling = true;
         int norm_type = cv::NORM_L2;
         bool use_color = false;
+        DescriptorPrecision precision = DescriptorPrecision::FLOAT32; // applied after pooling
+        int pq_m = 16;                 // PQ subspaces (precision: pq)
+        int pq_bits = 8;               // bits per PQ sub-code
+        std::string pq_codebook;       // codebook file to load / write (empty = fit per scene)
+        int hash_bits = 256;           // code length (precision: binary)
+        BinaryProjection hash_projection = BinaryProjection::ITQ;
+        std::string hash_model;        // hasher file to load / write (empty = fit per scene)
 
         // For stacking
         DescriptorType secondary_descriptor = DescriptorType::SIFT;
@@ -305,17 +376,57 @@ namespace thesis_project {
         float dnn_mean = 0.0f;        // simple mean/std normalization
         float dnn_std = 1.0f;
         bool dnn_per_patch_standardize = false; // if true, standardize each patch (zero mean, unit var)
+        std::string dnn_fallback_pca;  // PCA file for the PseudoDNN fallback (train_pseudo_dnn_pca)
     };
 
     struct EvaluationParams {
         MatchingMethod matching_method = MatchingMethod::BRUTE_FORCE;
         int norm_type = cv::NORM_L2;
         bool cross_check = true;
-        float match_threshold = 0.8f;
+        float match_threshold = 0.8f;   // Lowe ratio for ratio_test
+        int flann_trees = 4;    // randomized k-d trees (FLANN, float descriptors)
+        int flann_checks = 32;  // leaves visited per query (FLANN)
+        int hnsw_m = 16;                 // graph links per node (HNSW)
+        int hnsw_ef_construction = 200;  // build-time candidate list (HNSW)
+        int hnsw_ef_search = 64;         // query-time candidate list (HNSW)
+        std::string hnsw_index_dir;      // persist built graphs here (empty = off)
+        int pq_m = 16;                   // subspaces (PQ)
+        int pq_bits = 8;                 // bits per sub-code (PQ)
+        std::string pq_codebook;         // codebook file to load / write (empty = train in memory)
+        int hash_bits = 256;             // code length (hash)
+        BinaryProjection hash_projection = BinaryProjection::ITQ;
+        int hash_rerank = 8;             // Hamming candidates re-scored with float distance (0 = off)
+        std::string hash_model;          // hasher file to load / write (empty = fit in memory)
+        bool reuse_query_index = false;  // index descriptors1 once per scene, query from descriptors2 (flann/hnsw/pq/hash)
+        int match_threads = 1;           // query-chunk workers for matching (1 = off, 0 = all OpenCV threads)
 
         ValidationMethod validation_method = ValidationMethod::HOMOGRAPHY;
         float validation_threshold = 0.05f; // pixels
         int min_matches_for_homography = 10;
+
+        // Scene-level bootstrap confidence intervals for true mAP / P@1 (0 resamples = off)
+        int bootstrap_resamples = 0;
+        double bootstrap_confidence = 0.95;
+        int bootstrap_seed = 42;
+
+        // Homography ground truth for true mAP
+        RelevancePolicy relevance = RelevancePolicy::SINGLE;
+        double gt_tau_px = 3.0;          // reprojection radius that makes a keypoint relevant
+        int pr_curve_points = 0;         // dataset-level PR curve resolution (0 = off)
+        int ranking_top_k = 0;           // keep only the K nearest per query instead of full distance rows (0 = off)
+
+        // Stratified query subsampling for screening runs (rate 1 and no cap = every query)
+        double sample_rate = 1.0;        // fraction of ground-truth queries evaluated per image pair
+        int max_queries_per_pair = 0;    // cap on evaluated queries per image pair (0 = no cap)
+        int sample_seed = 42;
+
+        // HPatches-style verification / retrieval tasks over keypoint tracks (off by default)
+        bool task_verification = false;
+        bool task_retrieval = false;
+        int task_tracks_per_scene = 200; // image-1 keypoints with a correspondence in every other image
+        int retrieval_top_k = 100;       // AP@K cut-off for retrieval
+        bool retrieval_ann = false;      // HNSW candidate search instead of exact top-K
+        int task_seed = 42;
     };
 
     struct DatabaseParams {
@@ -325,6 +436,8 @@ namespace thesis_project {
         bool save_descriptors = false;
         bool save_matches = false;
         bool save_visualizations = true;
+        bool async_writes = false;       // batched write-behind queue on a writer thread
+        int write_queue_capacity = 256;  // queued writes before producers block
     };
 
     // ================================
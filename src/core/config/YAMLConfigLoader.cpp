@@ -185,6 +185,31 @@ namespace config {
                 else desc_config.params.norm_type = cv::NORM_L2; // default
             }
             
+            if (desc_node["precision"]) {
+                const std::string precision = desc_node["precision"].as<std::string>();
+                if (precision == "float32") desc_config.params.precision = DescriptorPrecision::FLOAT32;
+                else if (precision == "uint8") desc_config.params.precision = DescriptorPrecision::UINT8;
+                else if (precision == "pq") desc_config.params.precision = DescriptorPrecision::PQ;
+                else if (precision == "binary") desc_config.params.precision = DescriptorPrecision::BINARY;
+                else if (precision == "fp16") desc_config.params.precision = DescriptorPrecision::FP16;
+                else if (precision == "bf16") desc_config.params.precision = DescriptorPrecision::BF16;
+                else throw std::runtime_error("Unknown descriptor precision: " + precision);
+            }
+
+            if (desc_node["pq"]) {
+                const auto& pq = desc_node["pq"];
+                if (pq["m"]) desc_config.params.pq_m = pq["m"].as<int>();
+                if (pq["bits"]) desc_config.params.pq_bits = pq["bits"].as<int>();
+                if (pq["codebook"]) desc_config.params.pq_codebook = pq["codebook"].as<std::string>();
+            }
+
+            if (desc_node["hash"]) {
+                const auto& hash = desc_node["hash"];
+                if (hash["bits"]) desc_config.params.hash_bits = hash["bits"].as<int>();
+                if (hash["projection"]) desc_config.params.hash_projection = stringToBinaryProjection(hash["projection"].as<std::string>());
+                if (hash["model"]) desc_config.params.hash_model = hash["model"].as<std::string>();
+            }
+
             if (desc_node["secondary_descriptor"]) {
                 desc_config.params.secondary_descriptor = stringToDescriptorType(desc_node["secondary_descriptor"].as<std::string>());
             }
@@ -203,6 +228,7 @@ namespace config {
                 if (dnn["mean"]) desc_config.params.dnn_mean = dnn["mean"].as<float>();
                 if (dnn["std"]) desc_config.params.dnn_std = dnn["std"].as<float>();
                 if (dnn["per_patch_standardize"]) desc_config.params.dnn_per_patch_standardize = dnn["per_patch_standardize"].as<bool>();
+                if (dnn["fallback_pca"]) desc_config.params.dnn_fallback_pca = dnn["fallback_pca"].as<std::string>();
             }
             
             descriptors.push_back(desc_config);
@@ -286,6 +312,52 @@ namespace config {
         if (config.evaluation.params.match_threshold < 0.0f || config.evaluation.params.match_threshold > 1.0f) {
             throw std::runtime_error("YAML validation error: evaluation.matching.threshold must be in [0,1]");
         }
+        if (config.evaluation.params.flann_trees <= 0 || config.evaluation.params.flann_checks <= 0) {
+            throw std::runtime_error("YAML validation error: evaluation.matching.flann trees/checks must be > 0");
+        }
+        if (config.evaluation.params.hnsw_m < 2 || config.evaluation.params.hnsw_ef_construction <= 0 ||
+            config.evaluation.params.hnsw_ef_search <= 0) {
+            throw std::runtime_error("YAML validation error: evaluation.matching.hnsw requires m >= 2 and ef_construction/ef_search > 0");
+        }
+        if (config.evaluation.params.pq_m <= 0 || config.evaluation.params.pq_bits < 1 ||
+            config.evaluation.params.pq_bits > 8) {
+            throw std::runtime_error("YAML validation error: evaluation.matching.pq requires m > 0 and bits in [1,8]");
+        }
+        if (config.evaluation.params.hash_bits <= 0 || config.evaluation.params.hash_bits % 8 != 0 ||
+            config.evaluation.params.hash_rerank < 0) {
+            throw std::runtime_error("YAML validation error: evaluation.matching.hash requires bits as a positive multiple of 8 and rerank >= 0");
+        }
+        if (config.evaluation.params.match_threads < 0) {
+            throw std::runtime_error("YAML validation error: evaluation.matching.threads must be >= 0");
+        }
+        if (config.evaluation.params.bootstrap_resamples < 0 ||
+            config.evaluation.params.bootstrap_confidence <= 0.0 || config.evaluation.params.bootstrap_confidence >= 1.0) {
+            throw std::runtime_error("YAML validation error: evaluation.bootstrap requires resamples >= 0 and confidence in (0,1)");
+        }
+        if (config.evaluation.params.gt_tau_px <= 0.0 || config.evaluation.params.pr_curve_points < 0 ||
+            config.evaluation.params.ranking_top_k < 0) {
+            throw std::runtime_error("YAML validation error: evaluation.ground_truth requires tau_px > 0, pr_curve_points >= 0 and top_k >= 0");
+        }
+        if (config.evaluation.params.sample_rate <= 0.0 || config.evaluation.params.sample_rate > 1.0 ||
+            config.evaluation.params.max_queries_per_pair < 0) {
+            throw std::runtime_error("YAML validation error: evaluation.sampling requires rate in (0,1] and max_queries_per_pair >= 0");
+        }
+        if (config.evaluation.params.task_tracks_per_scene <= 0 || config.evaluation.params.retrieval_top_k <= 0) {
+            throw std::runtime_error("YAML validation error: evaluation.tasks requires tracks_per_scene > 0 and retrieval_top_k > 0");
+        }
+        if (config.database.write_queue_capacity <= 0) {
+            throw std::runtime_error("YAML validation error: database.write_queue_capacity must be > 0");
+        }
+        for (const auto& desc : config.descriptors) {
+            if (desc.params.pq_m <= 0 || desc.params.pq_bits < 1 || desc.params.pq_bits > 8) {
+                throw std::runtime_error("YAML validation error: descriptor '" + desc.name +
+                                         "' pq requires m > 0 and bits in [1,8]");
+            }
+            if (desc.params.hash_bits <= 0 || desc.params.hash_bits % 8 != 0) {
+                throw std::runtime_error("YAML validation error: descriptor '" + desc.name +
+                                         "' hash.bits must be a positive multiple of 8");
+            }
+        }
     }
     
     void YAMLConfigLoader::parseEvaluation(const YAML::Node& node, ExperimentConfig::Evaluation& evaluation) {
@@ -301,6 +373,7 @@ namespace config {
                 std::string norm_str = matching["norm"].as<std::string>();
                 if (norm_str == "l1") evaluation.params.norm_type = cv::NORM_L1;
                 else if (norm_str == "l2") evaluation.params.norm_type = cv::NORM_L2;
+                else if (norm_str == "hamming") evaluation.params.norm_type = cv::NORM_HAMMING;
                 else evaluation.params.norm_type = cv::NORM_L2; // default
             }
             
@@ -311,6 +384,43 @@ namespace config {
             if (matching["threshold"]) {
                 evaluation.params.match_threshold = matching["threshold"].as<float>();
             }
+
+            if (matching["reuse_query_index"]) {
+                evaluation.params.reuse_query_index = matching["reuse_query_index"].as<bool>();
+            }
+
+            if (matching["threads"]) {
+                evaluation.params.match_threads = matching["threads"].as<int>();
+            }
+
+            if (matching["flann"]) {
+                const auto& flann = matching["flann"];
+                if (flann["trees"]) evaluation.params.flann_trees = flann["trees"].as<int>();
+                if (flann["checks"]) evaluation.params.flann_checks = flann["checks"].as<int>();
+            }
+
+            if (matching["hnsw"]) {
+                const auto& hnsw = matching["hnsw"];
+                if (hnsw["m"]) evaluation.params.hnsw_m = hnsw["m"].as<int>();
+                if (hnsw["ef_construction"]) evaluation.params.hnsw_ef_construction = hnsw["ef_construction"].as<int>();
+                if (hnsw["ef_search"]) evaluation.params.hnsw_ef_search = hnsw["ef_search"].as<int>();
+                if (hnsw["index_dir"]) evaluation.params.hnsw_index_dir = hnsw["index_dir"].as<std::string>();
+            }
+
+            if (matching["pq"]) {
+                const auto& pq = matching["pq"];
+                if (pq["m"]) evaluation.params.pq_m = pq["m"].as<int>();
+                if (pq["bits"]) evaluation.params.pq_bits = pq["bits"].as<int>();
+                if (pq["codebook"]) evaluation.params.pq_codebook = pq["codebook"].as<std::string>();
+            }
+
+            if (matching["hash"]) {
+                const auto& hash = matching["hash"];
+                if (hash["bits"]) evaluation.params.hash_bits = hash["bits"].as<int>();
+                if (hash["projection"]) evaluation.params.hash_projection = stringToBinaryProjection(hash["projection"].as<std::string>());
+                if (hash["rerank"]) evaluation.params.hash_rerank = hash["rerank"].as<int>();
+                if (hash["model"]) evaluation.params.hash_model = hash["model"].as<std::string>();
+            }
         }
         
         // Parse validation parameters
@@ -329,6 +439,38 @@ namespace config {
                 evaluation.params.min_matches_for_homography = validation["min_matches"].as<int>();
             }
         }
+
+        if (node["bootstrap"]) {
+            const auto& bootstrap = node["bootstrap"];
+            if (bootstrap["resamples"]) evaluation.params.bootstrap_resamples = bootstrap["resamples"].as<int>();
+            if (bootstrap["confidence"]) evaluation.params.bootstrap_confidence = bootstrap["confidence"].as<double>();
+            if (bootstrap["seed"]) evaluation.params.bootstrap_seed = bootstrap["seed"].as<int>();
+        }
+
+        if (node["ground_truth"]) {
+            const auto& gt = node["ground_truth"];
+            if (gt["relevance"]) evaluation.params.relevance = stringToRelevancePolicy(gt["relevance"].as<std::string>());
+            if (gt["tau_px"]) evaluation.params.gt_tau_px = gt["tau_px"].as<double>();
+            if (gt["pr_curve_points"]) evaluation.params.pr_curve_points = gt["pr_curve_points"].as<int>();
+            if (gt["top_k"]) evaluation.params.ranking_top_k = gt["top_k"].as<int>();
+        }
+
+        if (node["sampling"]) {
+            const auto& sampling = node["sampling"];
+            if (sampling["rate"]) evaluation.params.sample_rate = sampling["rate"].as<double>();
+            if (sampling["max_queries_per_pair"]) evaluation.params.max_queries_per_pair = sampling["max_queries_per_pair"].as<int>();
+            if (sampling["seed"]) evaluation.params.sample_seed = sampling["seed"].as<int>();
+        }
+
+        if (node["tasks"]) {
+            const auto& tasks = node["tasks"];
+            if (tasks["verification"]) evaluation.params.task_verification = tasks["verification"].as<bool>();
+            if (tasks["retrieval"]) evaluation.params.task_retrieval = tasks["retrieval"].as<bool>();
+            if (tasks["tracks_per_scene"]) evaluation.params.task_tracks_per_scene = tasks["tracks_per_scene"].as<int>();
+            if (tasks["retrieval_top_k"]) evaluation.params.retrieval_top_k = tasks["retrieval_top_k"].as<int>();
+            if (tasks["retrieval_ann"]) evaluation.params.retrieval_ann = tasks["retrieval_ann"].as<bool>();
+            if (tasks["seed"]) evaluation.params.task_seed = tasks["seed"].as<int>();
+        }
         
         // Legacy keys removed in Schema v1 (no parsing of matching_threshold / validation_method)
     }
@@ -348,6 +490,8 @@ namespace config {
         if (node["save_descriptors"]) database.save_descriptors = node["save_descriptors"].as<bool>();
         if (node["save_matches"]) database.save_matches = node["save_matches"].as<bool>();
         if (node["save_visualizations"]) database.save_visualizations = node["save_visualizations"].as<bool>();
+        if (node["async_writes"]) database.async_writes = node["async_writes"].as<bool>();
+        if (node["write_queue_capacity"]) database.write_queue_capacity = node["write_queue_capacity"].as<int>();
     }
 
     // Migration removed
@@ -382,6 +526,10 @@ namespace config {
     MatchingMethod YAMLConfigLoader::stringToMatchingMethod(const std::string& str) {
         if (str == "brute_force") return MatchingMethod::BRUTE_FORCE;
         if (str == "flann") return MatchingMethod::FLANN;
+        if (str == "ratio_test") return MatchingMethod::RATIO_TEST;
+        if (str == "hnsw") return MatchingMethod::HNSW;
+        if (str == "pq") return MatchingMethod::PQ;
+        if (str == "hash") return MatchingMethod::HASH;
         throw std::runtime_error("Unknown matching method: " + str);
     }
     
@@ -391,6 +539,18 @@ namespace config {
         if (str == "none") return ValidationMethod::NONE;
         throw std::runtime_error("Unknown validation method: " + str);
     }
+
+    BinaryProjection YAMLConfigLoader::stringToBinaryProjection(const std::string& str) {
+        if (str == "random") return BinaryProjection::RANDOM;
+        if (str == "itq") return BinaryProjection::ITQ;
+        throw std::runtime_error("Unknown binary projection: " + str);
+    }
+
+    RelevancePolicy YAMLConfigLoader::stringToRelevancePolicy(const std::string& str) {
+        if (str == "single") return RelevancePolicy::SINGLE;
+        if (str == "multi") return RelevancePolicy::MULTI;
+        throw std::runtime_error("Unknown relevance policy: " + str);
+    }
     
     void YAMLConfigLoader::saveToFile(const ExperimentConfig& config, const std::string& yaml_path) {
         YAML::Emitter out;
@@ -421,6 +581,9 @@ namespace config {
         out << YAML::Key << "max_features" << YAML::Value << config.keypoints.params.max_features;
         out << YAML::Key << "contrast_threshold" << YAML::Value << config.keypoints.params.contrast_threshold;
         out << YAML::Key << "edge_threshold" << YAML::Value << config.keypoints.params.edge_threshold;
+        if (!config.keypoints.params.keypoint_set_name.empty()) {
+            out << YAML::Key << "keypoint_set_name" << YAML::Value << config.keypoints.params.keypoint_set_name;
+        }
         out << YAML::EndMap;
         
         // Descriptors section
@@ -436,6 +599,27 @@ namespace config {
             }
             out << YAML::Key << "normalize_after_pooling" << YAML::Value << desc.params.normalize_after_pooling;
             out << YAML::Key << "use_color" << YAML::Value << desc.params.use_color;
+            if (desc.params.precision != DescriptorPrecision::FLOAT32) {
+                out << YAML::Key << "precision" << YAML::Value << toString(desc.params.precision);
+            }
+            if (desc.params.precision == DescriptorPrecision::PQ) {
+                out << YAML::Key << "pq" << YAML::Value << YAML::BeginMap;
+                out << YAML::Key << "m" << YAML::Value << desc.params.pq_m;
+                out << YAML::Key << "bits" << YAML::Value << desc.params.pq_bits;
+                if (!desc.params.pq_codebook.empty()) {
+                    out << YAML::Key << "codebook" << YAML::Value << desc.params.pq_codebook;
+                }
+                out << YAML::EndMap;
+            }
+            if (desc.params.precision == DescriptorPrecision::BINARY) {
+                out << YAML::Key << "hash" << YAML::Value << YAML::BeginMap;
+                out << YAML::Key << "bits" << YAML::Value << desc.params.hash_bits;
+                out << YAML::Key << "projection" << YAML::Value << toString(desc.params.hash_projection);
+                if (!desc.params.hash_model.empty()) {
+                    out << YAML::Key << "model" << YAML::Value << desc.params.hash_model;
+                }
+                out << YAML::EndMap;
+            }
             out << YAML::EndMap;
         }
         out << YAML::EndSeq;
@@ -447,11 +631,86 @@ namespace config {
         out << YAML::Key << "method" << YAML::Value << toString(config.evaluation.params.matching_method);
         out << YAML::Key << "threshold" << YAML::Value << config.evaluation.params.match_threshold;
         out << YAML::Key << "cross_check" << YAML::Value << config.evaluation.params.cross_check;
+        if (config.evaluation.params.reuse_query_index) {
+            out << YAML::Key << "reuse_query_index" << YAML::Value << true;
+        }
+        if (config.evaluation.params.match_threads != 1) {
+            out << YAML::Key << "threads" << YAML::Value << config.evaluation.params.match_threads;
+        }
+        if (config.evaluation.params.matching_method == MatchingMethod::FLANN) {
+            out << YAML::Key << "flann" << YAML::Value << YAML::BeginMap;
+            out << YAML::Key << "trees" << YAML::Value << config.evaluation.params.flann_trees;
+            out << YAML::Key << "checks" << YAML::Value << config.evaluation.params.flann_checks;
+            out << YAML::EndMap;
+        }
+        if (config.evaluation.params.matching_method == MatchingMethod::HNSW) {
+            out << YAML::Key << "hnsw" << YAML::Value << YAML::BeginMap;
+            out << YAML::Key << "m" << YAML::Value << config.evaluation.params.hnsw_m;
+            out << YAML::Key << "ef_construction" << YAML::Value << config.evaluation.params.hnsw_ef_construction;
+            out << YAML::Key << "ef_search" << YAML::Value << config.evaluation.params.hnsw_ef_search;
+            if (!config.evaluation.params.hnsw_index_dir.empty()) {
+                out << YAML::Key << "index_dir" << YAML::Value << config.evaluation.params.hnsw_index_dir;
+            }
+            out << YAML::EndMap;
+        }
+        if (config.evaluation.params.matching_method == MatchingMethod::PQ) {
+            out << YAML::Key << "pq" << YAML::Value << YAML::BeginMap;
+            out << YAML::Key << "m" << YAML::Value << config.evaluation.params.pq_m;
+            out << YAML::Key << "bits" << YAML::Value << config.evaluation.params.pq_bits;
+            if (!config.evaluation.params.pq_codebook.empty()) {
+                out << YAML::Key << "codebook" << YAML::Value << config.evaluation.params.pq_codebook;
+            }
+            out << YAML::EndMap;
+        }
+        if (config.evaluation.params.matching_method == MatchingMethod::HASH) {
+            out << YAML::Key << "hash" << YAML::Value << YAML::BeginMap;
+            out << YAML::Key << "bits" << YAML::Value << config.evaluation.params.hash_bits;
+            out << YAML::Key << "projection" << YAML::Value << toString(config.evaluation.params.hash_projection);
+            out << YAML::Key << "rerank" << YAML::Value << config.evaluation.params.hash_rerank;
+            if (!config.evaluation.params.hash_model.empty()) {
+                out << YAML::Key << "model" << YAML::Value << config.evaluation.params.hash_model;
+            }
+            out << YAML::EndMap;
+        }
         out << YAML::EndMap;
         out << YAML::Key << "validation" << YAML::Value << YAML::BeginMap;
         out << YAML::Key << "method" << YAML::Value << toString(config.evaluation.params.validation_method);
         out << YAML::Key << "threshold" << YAML::Value << config.evaluation.params.validation_threshold;
         out << YAML::EndMap;
+        if (config.evaluation.params.bootstrap_resamples > 0) {
+            out << YAML::Key << "bootstrap" << YAML::Value << YAML::BeginMap;
+            out << YAML::Key << "resamples" << YAML::Value << config.evaluation.params.bootstrap_resamples;
+            out << YAML::Key << "confidence" << YAML::Value << config.evaluation.params.bootstrap_confidence;
+            out << YAML::Key << "seed" << YAML::Value << config.evaluation.params.bootstrap_seed;
+            out << YAML::EndMap;
+        }
+        if (config.evaluation.params.relevance != RelevancePolicy::SINGLE ||
+            config.evaluation.params.gt_tau_px != 3.0 || config.evaluation.params.pr_curve_points > 0 ||
+            config.evaluation.params.ranking_top_k > 0) {
+            out << YAML::Key << "ground_truth" << YAML::Value << YAML::BeginMap;
+            out << YAML::Key << "relevance" << YAML::Value << toString(config.evaluation.params.relevance);
+            out << YAML::Key << "tau_px" << YAML::Value << config.evaluation.params.gt_tau_px;
+            out << YAML::Key << "pr_curve_points" << YAML::Value << config.evaluation.params.pr_curve_points;
+            out << YAML::Key << "top_k" << YAML::Value << config.evaluation.params.ranking_top_k;
+            out << YAML::EndMap;
+        }
+        if (config.evaluation.params.sample_rate < 1.0 || config.evaluation.params.max_queries_per_pair > 0) {
+            out << YAML::Key << "sampling" << YAML::Value << YAML::BeginMap;
+            out << YAML::Key << "rate" << YAML::Value << config.evaluation.params.sample_rate;
+            out << YAML::Key << "max_queries_per_pair" << YAML::Value << config.evaluation.params.max_queries_per_pair;
+            out << YAML::Key << "seed" << YAML::Value << config.evaluation.params.sample_seed;
+            out << YAML::EndMap;
+        }
+        if (config.evaluation.params.task_verification || config.evaluation.params.task_retrieval) {
+            out << YAML::Key << "tasks" << YAML::Value << YAML::BeginMap;
+            out << YAML::Key << "verification" << YAML::Value << config.evaluation.params.task_verification;
+            out << YAML::Key << "retrieval" << YAML::Value << config.evaluation.params.task_retrieval;
+            out << YAML::Key << "tracks_per_scene" << YAML::Value << config.evaluation.params.task_tracks_per_scene;
+            out << YAML::Key << "retrieval_top_k" << YAML::Value << config.evaluation.params.retrieval_top_k;
+            out << YAML::Key << "retrieval_ann" << YAML::Value << config.evaluation.params.retrieval_ann;
+            out << YAML::Key << "seed" << YAML::Value << config.evaluation.params.task_seed;
+            out << YAML::EndMap;
+        }
         out << YAML::EndMap;
         
         // Output section
@@ -465,6 +724,10 @@ namespace config {
         out << YAML::Key << "database";
         out << YAML::Value << YAML::BeginMap;
         out << YAML::Key << "enabled" << YAML::Value << config.database.enabled;
+        if (config.database.async_writes) {
+            out << YAML::Key << "async_writes" << YAML::Value << config.database.async_writes;
+            out << YAML::Key << "write_queue_capacity" << YAML::Value << config.database.write_queue_capacity;
+        }
         out << YAML::EndMap;
         
         out << YAML::EndMap;
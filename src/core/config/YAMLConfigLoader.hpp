@@ -58,6 +58,8 @@ namespace config {
         static KeypointGenerator stringToKeypointGenerator(const std::string& str);
         static MatchingMethod stringToMatchingMethod(const std::string& str);
         static ValidationMethod stringToValidationMethod(const std::string& str);
+        static BinaryProjection stringToBinaryProjection(const std::string& str);
+        static RelevancePolicy stringToRelevancePolicy(const std::string& str);
 
         // Basic schema/range validation
         static void validate(const ExperimentConfig& config);
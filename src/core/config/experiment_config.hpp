@@ -40,8 +40,8 @@ enum RootingStage {
  */
 enum MatchingStrategy {
     BRUTE_FORCE, ///< Brute-force matching with cross-check
-    FLANN,       ///< FLANN-based approximate matching (future)
-    RATIO_TEST   ///< Lowe's ratio test (future)
+    FLANN,       ///< FLANN-based approximate matching
+    RATIO_TEST   ///< Lowe's ratio test
 };
 
 /**
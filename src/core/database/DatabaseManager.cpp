@@ -3,49 +3,326 @@
 #include <iostream>
 #include <sstream>
 #include <chrono>
+#include <ctime>
 #include <iomanip>
 #include <vector>
 #include <tuple>
 #include <map>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 namespace thesis_project::database {
 
+namespace {
+
+// Write statements, cached on the primary connection like every other query
+constexpr const char* INSERT_RESULT_SQL = R"(
+    INSERT INTO results (experiment_id, mean_average_precision, precision_at_1,
+                         precision_at_5, recall_at_1, recall_at_5, total_matches,
+                         total_keypoints, processing_time_ms, timestamp, metadata)
+    VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?))";
+constexpr const char* DELETE_IMAGE_KEYPOINTS_SQL =
+    "DELETE FROM locked_keypoints WHERE scene_name = ? AND image_name = ?";
+constexpr const char* INSERT_KEYPOINT_SQL = R"(
+    INSERT INTO locked_keypoints (scene_name, image_name, x, y, size, angle, response, octave, class_id)
+    VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?))";
+constexpr const char* INSERT_SET_KEYPOINT_SQL = R"(
+    INSERT OR IGNORE INTO locked_keypoints
+    (keypoint_set_id, scene_name, image_name, x, y, size, angle, response, octave, class_id, valid_bounds)
+    VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?))";
+constexpr const char* INSERT_DESCRIPTOR_SQL = R"(
+    INSERT OR REPLACE INTO descriptors
+    (experiment_id, scene_name, image_name, keypoint_x, keypoint_y,
+     descriptor_vector, descriptor_dimension, processing_method,
+     normalization_applied, rooting_applied, pooling_applied)
+    VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?))";
+
+/**
+ * @brief One SQLite connection and its prepared statements, keyed by SQL text
+ *
+ * Used by one thread at a time (the caller holds db_mutex for the primary,
+ * read connections belong to a single thread).
+ */
+struct Connection {
+    sqlite3* db = nullptr;
+    std::unordered_map<std::string, sqlite3_stmt*> statements;
+
+    Connection() = default;
+    Connection(const Connection&) = delete;
+    Connection& operator=(const Connection&) = delete;
+    ~Connection() { close(); }
+
+    bool open(const std::string& path, int flags, int timeout_seconds) {
+        if (sqlite3_open_v2(path.c_str(), &db, flags, nullptr) != SQLITE_OK) {
+            std::cerr << "DatabaseManager: Failed to open database: " << sqlite3_errmsg(db) << std::endl;
+            close();
+            return false;
+        }
+        sqlite3_busy_timeout(db, timeout_seconds * 1000);
+        return true;
+    }
+
+    void close() {
+        for (auto& [sql, stmt] : statements) sqlite3_finalize(stmt);
+        statements.clear();
+        if (db) {
+            sqlite3_close(db);
+            db = nullptr;
+        }
+    }
+
+    /**
+     * @brief Cached statement for sql, prepared on first use (nullptr on error)
+     */
+    sqlite3_stmt* statement(const std::string& sql) {
+        auto it = statements.find(sql);
+        if (it != statements.end()) return it->second;
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) return nullptr;
+        statements.emplace(sql, stmt);
+        return stmt;
+    }
+};
+
+/**
+ * @brief Borrow a cached statement for one call; reset with bindings cleared on scope exit
+ *
+ * The reset matters in WAL mode: a SELECT left mid-step keeps its read
+ * snapshot open and would hide later commits from that connection.
+ */
+class ScopedStatement {
+public:
+    ScopedStatement(Connection& connection, const std::string& sql) : stmt_(connection.statement(sql)) {}
+    ScopedStatement(ScopedStatement&& other) noexcept : stmt_(other.stmt_) { other.stmt_ = nullptr; }
+    ScopedStatement(const ScopedStatement&) = delete;
+    ScopedStatement& operator=(const ScopedStatement&) = delete;
+    ScopedStatement& operator=(ScopedStatement&&) = delete;
+    ~ScopedStatement() {
+        if (stmt_) {
+            sqlite3_reset(stmt_);
+            sqlite3_clear_bindings(stmt_);
+        }
+    }
+
+    operator sqlite3_stmt*() const { return stmt_; }
+
+private:
+    sqlite3_stmt* stmt_;
+};
+
+} // namespace
+
 // PIMPL implementation to hide SQLite details
 class DatabaseManager::Impl {
 public:
-    sqlite3* db = nullptr;
+    Connection primary;  // read-write; every write and DDL statement goes through it
     bool enabled = false;
     DatabaseConfig config;
 
+    // Guards the primary connection: the writer thread holds it for a whole batch
+    std::mutex db_mutex;
+
+    // Read-only connections, one per calling thread (config.concurrent_reads in WAL mode)
+    bool wal = false;
+    std::mutex pool_mutex;
+    std::unordered_map<std::thread::id, std::unique_ptr<Connection>> readers;
+
+    // Write-behind queue (config.async_writes): one writer thread commits queued
+    // writes in batches, one transaction per batch and one savepoint per write
+    using PendingWrite = std::function<bool()>;
+    std::deque<PendingWrite> queue;
+    std::mutex queue_mutex;
+    std::condition_variable queue_ready;    // writer: work or stop
+    std::condition_variable queue_space;    // producers: below capacity
+    std::condition_variable queue_drained;  // flush(): queue empty and nothing in flight
+    size_t in_flight = 0;
+    size_t failed_writes = 0;
+    bool stopping = false;
+    std::thread writer;
+
     explicit Impl(const DatabaseConfig& cfg) : config(cfg), enabled(cfg.enabled) {
         if (!enabled) {
             std::cout << "DatabaseManager: Disabled - no experiment tracking" << std::endl;
             return;
         }
 
-        // Try to open database
-        int rc = sqlite3_open(config.connection_string.c_str(), &db);
-        if (rc != SQLITE_OK) {
-            std::cerr << "DatabaseManager: Failed to open database: "
-                      << sqlite3_errmsg(db) << std::endl;
+        const int flags = SQLITE_OPEN_READWRITE | (config.create_if_missing ? SQLITE_OPEN_CREATE : 0);
+        if (!primary.open(config.connection_string, flags, config.connection_timeout)) {
             enabled = false;
-            if (db) {
-                sqlite3_close(db);
-                db = nullptr;
+            return;
+        }
+        std::cout << "DatabaseManager: Connected to " << config.connection_string << std::endl;
+
+        if (config.concurrent_reads) {
+            // Readers need WAL to run beside the writer; in-memory databases stay on the primary
+            ScopedStatement journal(primary, "PRAGMA journal_mode = WAL;");
+            if (journal && sqlite3_step(journal) == SQLITE_ROW) {
+                const auto mode = reinterpret_cast<const char*>(sqlite3_column_text(journal, 0));
+                wal = mode && std::string(mode) == "wal";
             }
-        } else {
-            std::cout << "DatabaseManager: Connected to " << config.connection_string << std::endl;
+            if (!wal) {
+                std::cerr << "DatabaseManager: WAL unavailable, reads share the primary connection" << std::endl;
+            }
+        }
+        if (config.async_writes) {
+            writer = std::thread([this] { writerLoop(); });
         }
     }
 
     ~Impl() {
-        if (db) {
-            sqlite3_close(db);
+        if (writer.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(queue_mutex);
+                stopping = true;
+            }
+            queue_ready.notify_all();
+            writer.join();  // the writer drains the queue before exiting
         }
+        readers.clear();
+        primary.close();
     }
 
-    bool initializeTables() const {
-        if (!enabled || !db) return !enabled; // Success if disabled
+    /**
+     * @brief Cached write statement on the primary connection (call with db_mutex held)
+     */
+    ScopedStatement writeStatement(const char* sql) {
+        ScopedStatement stmt(primary, sql);
+        if (!stmt) {
+            std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(primary.db) << std::endl;
+        }
+        return stmt;
+    }
+
+    /**
+     * @brief Run writes in one transaction; a failed write rolls back to its savepoint only
+     * @return Number of failed writes
+     */
+    size_t runBatch(std::vector<PendingWrite>& batch) {
+        std::lock_guard<std::mutex> lock(db_mutex);
+        size_t failed = 0;
+        sqlite3_exec(primary.db, "BEGIN TRANSACTION", nullptr, nullptr, nullptr);
+        for (auto& write : batch) {
+            sqlite3_exec(primary.db, "SAVEPOINT pending_write", nullptr, nullptr, nullptr);
+            if (write()) {
+                sqlite3_exec(primary.db, "RELEASE pending_write", nullptr, nullptr, nullptr);
+            } else {
+                sqlite3_exec(primary.db, "ROLLBACK TO pending_write", nullptr, nullptr, nullptr);
+                sqlite3_exec(primary.db, "RELEASE pending_write", nullptr, nullptr, nullptr);
+                failed++;
+            }
+        }
+        if (sqlite3_exec(primary.db, "COMMIT", nullptr, nullptr, nullptr) != SQLITE_OK) {
+            std::cerr << "Failed to commit write batch: " << sqlite3_errmsg(primary.db) << std::endl;
+            sqlite3_exec(primary.db, "ROLLBACK", nullptr, nullptr, nullptr);
+            failed = batch.size();
+        }
+        return failed;
+    }
+
+    /**
+     * @brief Queue a write (blocks while the queue is full) or run it now when writes are synchronous
+     * @return Write result when synchronous; true once queued otherwise
+     */
+    bool submit(PendingWrite write) {
+        if (!writer.joinable()) {
+            std::vector<PendingWrite> batch;
+            batch.push_back(std::move(write));
+            return runBatch(batch) == 0;
+        }
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            queue_space.wait(lock, [this] { return queue.size() < std::max<size_t>(1, config.write_queue_capacity); });
+            queue.push_back(std::move(write));
+        }
+        queue_ready.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Wait until every queued write is committed
+     * @return true if no queued write failed since the previous flush
+     */
+    bool flush() {
+        if (!writer.joinable()) return true;
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        queue_drained.wait(lock, [this] { return queue.empty() && in_flight == 0; });
+        const bool ok = failed_writes == 0;
+        failed_writes = 0;
+        return ok;
+    }
+
+    /**
+     * @brief A connection for one direct call, after pending writes land
+     *
+     * The lock is held only when the call uses the shared primary connection.
+     */
+    struct Access {
+        std::unique_lock<std::mutex> lock;
+        Connection* connection;
+        sqlite3* db() const { return connection->db; }
+    };
+
+    Access writeAccess() {
+        flush();
+        return {std::unique_lock<std::mutex>(db_mutex), &primary};
+    }
+
+    Access readAccess() {
+        flush();
+        if (Connection* reader = readConnection()) return {std::unique_lock<std::mutex>(), reader};
+        return writeAccess();
+    }
+
+    /**
+     * @brief This thread's read-only connection, opened on first use (nullptr outside WAL mode)
+     */
+    Connection* readConnection() {
+        if (!wal) return nullptr;
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        auto& reader = readers[std::this_thread::get_id()];
+        if (!reader) {
+            auto connection = std::make_unique<Connection>();
+            if (!connection->open(config.connection_string, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX,
+                                  config.connection_timeout)) {
+                readers.erase(std::this_thread::get_id());
+                return nullptr;
+            }
+            reader = std::move(connection);
+        }
+        return reader.get();
+    }
+
+    void writerLoop() {
+        std::vector<PendingWrite> batch;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(queue_mutex);
+                queue_ready.wait(lock, [this] { return stopping || !queue.empty(); });
+                if (queue.empty()) return;
+                // Everything queued so far goes into one transaction
+                batch.assign(std::make_move_iterator(queue.begin()), std::make_move_iterator(queue.end()));
+                queue.clear();
+                in_flight = batch.size();
+            }
+            queue_space.notify_all();
+
+            const size_t failed = runBatch(batch);
+            batch.clear();
+            {
+                std::lock_guard<std::mutex> lock(queue_mutex);
+                failed_writes += failed;
+                in_flight = 0;
+            }
+            queue_drained.notify_all();
+        }
+    }
+
+    bool initializeTables() {
+        if (!enabled || !primary.db) return !enabled; // Success if disabled
 
         const auto create_experiments_table = R"(
             CREATE TABLE IF NOT EXISTS experiments (
@@ -146,49 +423,49 @@ public:
 
         char* error_msg = nullptr;
 
-        int rc1 = sqlite3_exec(db, create_experiments_table, nullptr, nullptr, &error_msg);
+        int rc1 = sqlite3_exec(primary.db, create_experiments_table, nullptr, nullptr, &error_msg);
         if (rc1 != SQLITE_OK) {
             std::cerr << "Failed to create experiments table: " << error_msg << std::endl;
             sqlite3_free(error_msg);
             return false;
         }
 
-        int rc2 = sqlite3_exec(db, create_results_table, nullptr, nullptr, &error_msg);
+        int rc2 = sqlite3_exec(primary.db, create_results_table, nullptr, nullptr, &error_msg);
         if (rc2 != SQLITE_OK) {
             std::cerr << "Failed to create results table: " << error_msg << std::endl;
             sqlite3_free(error_msg);
             return false;
         }
 
-        int rc3 = sqlite3_exec(db, create_keypoint_sets_table, nullptr, nullptr, &error_msg);
+        int rc3 = sqlite3_exec(primary.db, create_keypoint_sets_table, nullptr, nullptr, &error_msg);
         if (rc3 != SQLITE_OK) {
             std::cerr << "Failed to create keypoint_sets table: " << error_msg << std::endl;
             sqlite3_free(error_msg);
             return false;
         }
 
-        int rc4 = sqlite3_exec(db, create_keypoints_table, nullptr, nullptr, &error_msg);
+        int rc4 = sqlite3_exec(primary.db, create_keypoints_table, nullptr, nullptr, &error_msg);
         if (rc4 != SQLITE_OK) {
             std::cerr << "Failed to create locked_keypoints table: " << error_msg << std::endl;
             sqlite3_free(error_msg);
             return false;
         }
 
-        int rc5 = sqlite3_exec(db, create_descriptors_table, nullptr, nullptr, &error_msg);
+        int rc5 = sqlite3_exec(primary.db, create_descriptors_table, nullptr, nullptr, &error_msg);
         if (rc5 != SQLITE_OK) {
             std::cerr << "Failed to create descriptors table: " << error_msg << std::endl;
             sqlite3_free(error_msg);
             return false;
         }
 
-        int rc6 = sqlite3_exec(db, create_keypoint_indexes, nullptr, nullptr, &error_msg);
+        int rc6 = sqlite3_exec(primary.db, create_keypoint_indexes, nullptr, nullptr, &error_msg);
         if (rc6 != SQLITE_OK) {
             std::cerr << "Failed to create keypoint indexes: " << error_msg << std::endl;
             sqlite3_free(error_msg);
             return false;
         }
 
-        int rc7 = sqlite3_exec(db, create_descriptor_indexes, nullptr, nullptr, &error_msg);
+        int rc7 = sqlite3_exec(primary.db, create_descriptor_indexes, nullptr, nullptr, &error_msg);
         if (rc7 != SQLITE_OK) {
             std::cerr << "Failed to create descriptor indexes: " << error_msg << std::endl;
             sqlite3_free(error_msg);
@@ -201,12 +478,32 @@ public:
     static std::string getCurrentTimestamp() {
         const auto now = std::chrono::system_clock::now();
         const auto time_t = std::chrono::system_clock::to_time_t(now);
+        std::tm local{};
+#ifdef _WIN32
+        localtime_s(&local, &time_t);
+#else
+        localtime_r(&time_t, &local);  // producers may stamp writes concurrently
+#endif
         std::stringstream ss;
-        ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
+        ss << std::put_time(&local, "%Y-%m-%d %H:%M:%S");
         return ss.str();
     }
 };
 
+KeypointSetIndex::Range KeypointSetIndex::find(const std::string& scene_name, const std::string& image_name) const {
+    const auto scene = ranges_.find(scene_name);
+    if (scene == ranges_.end()) return {};
+    const auto image = scene->second.find(image_name);
+    if (image == scene->second.end()) return {};
+    return {keypoints_.data() + image->second.first, image->second.second};
+}
+
+size_t KeypointSetIndex::images() const {
+    size_t count = 0;
+    for (const auto& [scene, images] : ranges_) count += images.size();
+    return count;
+}
+
 // DatabaseManager implementation
 DatabaseManager::DatabaseManager(const DatabaseConfig& config)
     : impl_(std::make_unique<Impl>(config)) {
@@ -222,11 +519,12 @@ DatabaseManager::DatabaseManager(const std::string& db_path, bool enabled)
 DatabaseManager::~DatabaseManager() = default;
 
 bool DatabaseManager::isEnabled() const {
-    return impl_->enabled && impl_->db != nullptr;
+    return impl_->enabled && impl_->primary.db != nullptr;
 }
 
 bool DatabaseManager::optimizeForBulkOperations() const {
     if (!isEnabled()) return true; // Success if disabled
+    auto access = impl_->writeAccess();
 
     char* error_msg = nullptr;
     
@@ -241,7 +539,7 @@ bool DatabaseManager::optimizeForBulkOperations() const {
     };
 
     for (const char* pragma : optimizations) {
-        int rc = sqlite3_exec(impl_->db, pragma, nullptr, nullptr, &error_msg);
+        int rc = sqlite3_exec(access.db(), pragma, nullptr, nullptr, &error_msg);
         if (rc != SQLITE_OK) {
             std::cerr << "Failed to apply optimization: " << pragma 
                       << " Error: " << error_msg << std::endl;
@@ -255,11 +553,17 @@ bool DatabaseManager::optimizeForBulkOperations() const {
 }
 
 bool DatabaseManager::initializeTables() const {
+    auto access = impl_->writeAccess();
     return impl_->initializeTables();
 }
 
+bool DatabaseManager::flush() const {
+    return impl_->flush();
+}
+
 int DatabaseManager::recordConfiguration(const ExperimentConfig& config) const {
     if (!isEnabled()) return -1;
+    auto access = impl_->writeAccess();
 
     const char* sql = R"(
         INSERT INTO experiments (descriptor_type, dataset_name, pooling_strategy,
@@ -267,10 +571,9 @@ int DatabaseManager::recordConfiguration(const ExperimentConfig& config) const {
         VALUES (?, ?, ?, ?, ?, ?, ?);
     )";
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(impl_->db, sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(impl_->db) << std::endl;
+    ScopedStatement stmt(*access.connection, sql);
+    if (!stmt) {
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(access.db()) << std::endl;
         return -1;
     }
 
@@ -280,6 +583,7 @@ int DatabaseManager::recordConfiguration(const ExperimentConfig& config) const {
         params_ss << key << "=" << value << ";";
     }
     std::string params_str = params_ss.str();
+    const std::string timestamp = impl_->getCurrentTimestamp();
 
     // Bind parameters
     sqlite3_bind_text(stmt, 1, config.descriptor_type.c_str(), -1, SQLITE_STATIC);
@@ -287,77 +591,65 @@ int DatabaseManager::recordConfiguration(const ExperimentConfig& config) const {
     sqlite3_bind_text(stmt, 3, config.pooling_strategy.c_str(), -1, SQLITE_STATIC);
     sqlite3_bind_double(stmt, 4, config.similarity_threshold);
     sqlite3_bind_int(stmt, 5, config.max_features);
-    sqlite3_bind_text(stmt, 6, impl_->getCurrentTimestamp().c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 6, timestamp.c_str(), -1, SQLITE_STATIC);
     sqlite3_bind_text(stmt, 7, params_str.c_str(), -1, SQLITE_STATIC);
 
-    rc = sqlite3_step(stmt);
+    const int rc = sqlite3_step(stmt);
     int experiment_id = -1;
 
     if (rc == SQLITE_DONE) {
-        experiment_id = static_cast<int>(sqlite3_last_insert_rowid(impl_->db));
+        experiment_id = static_cast<int>(sqlite3_last_insert_rowid(access.db()));
         std::cout << "Recorded experiment config with ID: " << experiment_id << std::endl;
     } else {
-        std::cerr << "Failed to insert experiment: " << sqlite3_errmsg(impl_->db) << std::endl;
+        std::cerr << "Failed to insert experiment: " << sqlite3_errmsg(access.db()) << std::endl;
     }
 
-    sqlite3_finalize(stmt);
     return experiment_id;
 }
 
 bool DatabaseManager::recordExperiment(const ExperimentResults& results) const {
     if (!isEnabled()) return true; // Success if disabled
 
-    const auto sql = R"(
-        INSERT INTO results (experiment_id, mean_average_precision, precision_at_1,
-                           precision_at_5, recall_at_1, recall_at_5, total_matches,
-                           total_keypoints, processing_time_ms, timestamp, metadata)
-        VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);
-    )";
-
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(impl_->db, sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(impl_->db) << std::endl;
-        return false;
-    }
-
     // Build metadata string
     std::stringstream metadata_ss;
     for (const auto& [key, value] : results.metadata) {
         metadata_ss << key << "=" << value << ";";
     }
-    std::string metadata_str = metadata_ss.str();
-
-    // Bind parameters
-    sqlite3_bind_int(stmt, 1, results.experiment_id);
-    sqlite3_bind_double(stmt, 2, results.mean_average_precision);
-    sqlite3_bind_double(stmt, 3, results.precision_at_1);
-    sqlite3_bind_double(stmt, 4, results.precision_at_5);
-    sqlite3_bind_double(stmt, 5, results.recall_at_1);
-    sqlite3_bind_double(stmt, 6, results.recall_at_5);
-    sqlite3_bind_int(stmt, 7, results.total_matches);
-    sqlite3_bind_int(stmt, 8, results.total_keypoints);
-    sqlite3_bind_double(stmt, 9, results.processing_time_ms);
-    sqlite3_bind_text(stmt, 10, impl_->getCurrentTimestamp().c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 11, metadata_str.c_str(), -1, SQLITE_STATIC);
-
-    rc = sqlite3_step(stmt);
-    const bool success = (rc == SQLITE_DONE);
 
-    if (success) {
-        std::cout << "Recorded experiment results (MAP: "
-                  << results.mean_average_precision << ")" << std::endl;
-    } else {
-        std::cerr << "Failed to insert results: " << sqlite3_errmsg(impl_->db) << std::endl;
-    }
+    Impl* impl = impl_.get();
+    return impl->submit([impl, results, metadata_str = metadata_ss.str(),
+                         timestamp = impl->getCurrentTimestamp()]() {
+        auto stmt = impl->writeStatement(INSERT_RESULT_SQL);
+        if (!stmt) return false;
 
-    sqlite3_finalize(stmt);
-    return success;
+        // Bind parameters
+        sqlite3_bind_int(stmt, 1, results.experiment_id);
+        sqlite3_bind_double(stmt, 2, results.mean_average_precision);
+        sqlite3_bind_double(stmt, 3, results.precision_at_1);
+        sqlite3_bind_double(stmt, 4, results.precision_at_5);
+        sqlite3_bind_double(stmt, 5, results.recall_at_1);
+        sqlite3_bind_double(stmt, 6, results.recall_at_5);
+        sqlite3_bind_int(stmt, 7, results.total_matches);
+        sqlite3_bind_int(stmt, 8, results.total_keypoints);
+        sqlite3_bind_double(stmt, 9, results.processing_time_ms);
+        sqlite3_bind_text(stmt, 10, timestamp.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 11, metadata_str.c_str(), -1, SQLITE_STATIC);
+
+        const bool success = (sqlite3_step(stmt) == SQLITE_DONE);
+        if (success) {
+            std::cout << "Recorded experiment results (MAP: "
+                      << results.mean_average_precision << ")" << std::endl;
+        } else {
+            std::cerr << "Failed to insert results: " << sqlite3_errmsg(impl->primary.db) << std::endl;
+        }
+        return success;
+    });
 }
 
 std::vector<ExperimentResults> DatabaseManager::getRecentResults(int limit) const {
     std::vector<ExperimentResults> results;
     if (!isEnabled()) return results;
+    auto access = impl_->readAccess();
 
     const auto sql = R"(
         SELECT r.experiment_id, e.descriptor_type, e.dataset_name,
@@ -370,9 +662,8 @@ std::vector<ExperimentResults> DatabaseManager::getRecentResults(int limit) cons
         LIMIT ?;
     )";
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(impl_->db, sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
+    ScopedStatement stmt(*access.connection, sql);
+    if (!stmt) {
         return results;
     }
 
@@ -396,13 +687,13 @@ std::vector<ExperimentResults> DatabaseManager::getRecentResults(int limit) cons
         results.push_back(result);
     }
 
-    sqlite3_finalize(stmt);
     return results;
 }
 
 std::map<std::string, double> DatabaseManager::getStatistics() const {
     std::map<std::string, double> stats;
     if (!isEnabled()) return stats;
+    auto access = impl_->readAccess();
 
     const char* sql = R"(
         SELECT
@@ -413,9 +704,8 @@ std::map<std::string, double> DatabaseManager::getStatistics() const {
         FROM results;
     )";
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(impl_->db, sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
+    ScopedStatement stmt(*access.connection, sql);
+    if (!stmt) {
         return stats;
     }
 
@@ -426,7 +716,6 @@ std::map<std::string, double> DatabaseManager::getStatistics() const {
         stats["average_time_ms"] = sqlite3_column_double(stmt, 3);
     }
 
-    sqlite3_finalize(stmt);
     return stats;
 }
 
@@ -438,76 +727,49 @@ bool DatabaseManager::storeLockedKeypoints(const std::string& scene_name, const
         return true;
     }
 
-    // Start transaction for massive performance improvement
-    sqlite3_exec(impl_->db, "BEGIN TRANSACTION", nullptr, nullptr, nullptr);
-
-    // First, clear existing keypoints for this scene/image
-    const auto clear_sql = "DELETE FROM locked_keypoints WHERE scene_name = ? AND image_name = ?";
-    sqlite3_stmt* clear_stmt;
-    int rc = sqlite3_prepare_v2(impl_->db, clear_sql, -1, &clear_stmt, nullptr);
-    if (rc == SQLITE_OK) {
-        sqlite3_bind_text(clear_stmt, 1, scene_name.c_str(), -1, SQLITE_STATIC);
-        sqlite3_bind_text(clear_stmt, 2, image_name.c_str(), -1, SQLITE_STATIC);
-        sqlite3_step(clear_stmt);
-    }
-    sqlite3_finalize(clear_stmt);
-
-    // Use optimized batch insert with prepared statement
-    const auto sql = R"(
-        INSERT INTO locked_keypoints (scene_name, image_name, x, y, size, angle, response, octave, class_id)
-        VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?);
-    )";
-
-    sqlite3_stmt* stmt;
-    rc = sqlite3_prepare_v2(impl_->db, sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        std::cerr << "Failed to prepare keypoint insert statement: " << sqlite3_errmsg(impl_->db) << std::endl;
-        sqlite3_exec(impl_->db, "ROLLBACK", nullptr, nullptr, nullptr);
-        return false;
-    }
-
-    int stored_count = 0;
-    bool success = true;
-
-    // Batch insert all keypoints within single transaction
-    for (const auto& kp : keypoints) {
-        sqlite3_bind_text(stmt, 1, scene_name.c_str(), -1, SQLITE_STATIC);
-        sqlite3_bind_text(stmt, 2, image_name.c_str(), -1, SQLITE_STATIC);
-        sqlite3_bind_double(stmt, 3, kp.pt.x);
-        sqlite3_bind_double(stmt, 4, kp.pt.y);
-        sqlite3_bind_double(stmt, 5, kp.size);
-        sqlite3_bind_double(stmt, 6, kp.angle);
-        sqlite3_bind_double(stmt, 7, kp.response);
-        sqlite3_bind_int(stmt, 8, kp.octave);
-        sqlite3_bind_int(stmt, 9, kp.class_id);
+    Impl* impl = impl_.get();
+    return impl->submit([impl, scene_name, image_name, keypoints]() {
+        // First, clear existing keypoints for this scene/image
+        auto clear_stmt = impl->writeStatement(DELETE_IMAGE_KEYPOINTS_SQL);
+        if (clear_stmt) {
+            sqlite3_bind_text(clear_stmt, 1, scene_name.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_text(clear_stmt, 2, image_name.c_str(), -1, SQLITE_STATIC);
+            sqlite3_step(clear_stmt);
+        }
 
-        rc = sqlite3_step(stmt);
-        if (rc == SQLITE_DONE) {
+        auto stmt = impl->writeStatement(INSERT_KEYPOINT_SQL);
+        if (!stmt) return false;
+
+        size_t stored_count = 0;
+        for (const auto& kp : keypoints) {
+            sqlite3_bind_text(stmt, 1, scene_name.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_text(stmt, 2, image_name.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_double(stmt, 3, kp.pt.x);
+            sqlite3_bind_double(stmt, 4, kp.pt.y);
+            sqlite3_bind_double(stmt, 5, kp.size);
+            sqlite3_bind_double(stmt, 6, kp.angle);
+            sqlite3_bind_double(stmt, 7, kp.response);
+            sqlite3_bind_int(stmt, 8, kp.octave);
+            sqlite3_bind_int(stmt, 9, kp.class_id);
+
+            if (sqlite3_step(stmt) != SQLITE_DONE) {
+                std::cerr << "Failed to insert keypoint: " << sqlite3_errmsg(impl->primary.db) << std::endl;
+                std::cerr << "Failed to store keypoints for " << scene_name << "/" << image_name << std::endl;
+                return false;
+            }
             stored_count++;
-        } else {
-            std::cerr << "Failed to insert keypoint: " << sqlite3_errmsg(impl_->db) << std::endl;
-            success = false;
-            break;
+            sqlite3_reset(stmt);
         }
-        sqlite3_reset(stmt);
-    }
 
-    sqlite3_finalize(stmt);
-
-    if (success) {
-        sqlite3_exec(impl_->db, "COMMIT", nullptr, nullptr, nullptr);
         std::cout << "Stored " << stored_count << " keypoints for " << scene_name << "/" << image_name << std::endl;
-    } else {
-        sqlite3_exec(impl_->db, "ROLLBACK", nullptr, nullptr, nullptr);
-        std::cerr << "Failed to store keypoints for " << scene_name << "/" << image_name << std::endl;
-    }
-    
-    return success && (stored_count == keypoints.size());
+        return true;
+    });
 }
 
 std::vector<cv::KeyPoint> DatabaseManager::getLockedKeypoints(const std::string& scene_name, const std::string& image_name) const {
     std::vector<cv::KeyPoint> keypoints;
     if (!isEnabled()) return keypoints;
+    auto access = impl_->readAccess();
 
     const char* sql = R"(
         SELECT x, y, size, angle, response, octave, class_id
@@ -516,9 +778,8 @@ std::vector<cv::KeyPoint> DatabaseManager::getLockedKeypoints(const std::string&
         ORDER BY id;
     )";
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(impl_->db, sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
+    ScopedStatement stmt(*access.connection, sql);
+    if (!stmt) {
         return keypoints;
     }
 
@@ -537,19 +798,18 @@ std::vector<cv::KeyPoint> DatabaseManager::getLockedKeypoints(const std::string&
         keypoints.push_back(kp);
     }
 
-    sqlite3_finalize(stmt);
     return keypoints;
 }
 
 std::vector<std::string> DatabaseManager::getAvailableScenes() const {
     std::vector<std::string> scenes;
     if (!isEnabled()) return scenes;
+    auto access = impl_->readAccess();
 
     const char* sql = "SELECT DISTINCT scene_name FROM locked_keypoints ORDER BY scene_name;";
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(impl_->db, sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
+    ScopedStatement stmt(*access.connection, sql);
+    if (!stmt) {
         return scenes;
     }
 
@@ -557,19 +817,18 @@ std::vector<std::string> DatabaseManager::getAvailableScenes() const {
         scenes.push_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)));
     }
 
-    sqlite3_finalize(stmt);
     return scenes;
 }
 
 std::vector<std::string> DatabaseManager::getAvailableImages(const std::string& scene_name) const {
     std::vector<std::string> images;
     if (!isEnabled()) return images;
+    auto access = impl_->readAccess();
 
     const char* sql = "SELECT DISTINCT image_name FROM locked_keypoints WHERE scene_name = ? ORDER BY image_name;";
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(impl_->db, sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
+    ScopedStatement stmt(*access.connection, sql);
+    if (!stmt) {
         return images;
     }
 
@@ -579,32 +838,30 @@ std::vector<std::string> DatabaseManager::getAvailableImages(const std::string&
         images.emplace_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)));
     }
 
-    sqlite3_finalize(stmt);
     return images;
 }
 
 bool DatabaseManager::clearSceneKeypoints(const std::string& scene_name) const {
     if (!isEnabled()) return true; // Success if disabled
+    auto access = impl_->writeAccess();
 
     const auto sql = "DELETE FROM locked_keypoints WHERE scene_name = ?;";
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(impl_->db, sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        std::cerr << "Failed to prepare clear statement: " << sqlite3_errmsg(impl_->db) << std::endl;
+    ScopedStatement stmt(*access.connection, sql);
+    if (!stmt) {
+        std::cerr << "Failed to prepare clear statement: " << sqlite3_errmsg(access.db()) << std::endl;
         return false;
     }
 
     sqlite3_bind_text(stmt, 1, scene_name.c_str(), -1, SQLITE_STATIC);
-    rc = sqlite3_step(stmt);
+    const int rc = sqlite3_step(stmt);
     
     bool success = (rc == SQLITE_DONE);
     if (success) {
-        int deleted_count = sqlite3_changes(impl_->db);
+        int deleted_count = sqlite3_changes(access.db());
         std::cout << "Cleared " << deleted_count << " keypoints for scene: " << scene_name << std::endl;
     }
 
-    sqlite3_finalize(stmt);
     return success;
 }
 
@@ -617,7 +874,7 @@ bool DatabaseManager::storeDescriptors(int experiment_id,
                                       const std::string& normalization_applied,
                                       const std::string& rooting_applied,
                                       const std::string& pooling_applied) const {
-    if (!impl_->enabled || !impl_->db) return !impl_->enabled;
+    if (!impl_->enabled || !impl_->primary.db) return !impl_->enabled;
 
     if (keypoints.size() != descriptors.rows) {
         std::cerr << "Error: Keypoints count (" << keypoints.size() 
@@ -625,72 +882,52 @@ bool DatabaseManager::storeDescriptors(int experiment_id,
         return false;
     }
 
-    const auto sql = R"(
-        INSERT OR REPLACE INTO descriptors 
-        (experiment_id, scene_name, image_name, keypoint_x, keypoint_y, 
-         descriptor_vector, descriptor_dimension, processing_method, 
-         normalization_applied, rooting_applied, pooling_applied) 
-        VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
-    )";
-
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(impl_->db, sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        std::cerr << "Failed to prepare descriptor insert statement: " << sqlite3_errmsg(impl_->db) << std::endl;
-        return false;
-    }
-
-    // Begin transaction for efficiency
-    sqlite3_exec(impl_->db, "BEGIN TRANSACTION", nullptr, nullptr, nullptr);
-
-    bool success = true;
-    for (size_t i = 0; i < keypoints.size(); ++i) {
-        const cv::KeyPoint& kp = keypoints[i];
-        cv::Mat descriptor_row = descriptors.row(i);
-
-        // Bind parameters
-        sqlite3_bind_int(stmt, 1, experiment_id);
-        sqlite3_bind_text(stmt, 2, scene_name.c_str(), -1, SQLITE_STATIC);
-        sqlite3_bind_text(stmt, 3, image_name.c_str(), -1, SQLITE_STATIC);
-        sqlite3_bind_double(stmt, 4, kp.pt.x);
-        sqlite3_bind_double(stmt, 5, kp.pt.y);
-
-        // Store descriptor as binary blob
-        sqlite3_bind_blob(stmt, 6, descriptor_row.data, 
-                         descriptor_row.total() * descriptor_row.elemSize(), SQLITE_STATIC);
-        sqlite3_bind_int(stmt, 7, descriptor_row.cols);
-        sqlite3_bind_text(stmt, 8, processing_method.c_str(), -1, SQLITE_STATIC);
-        sqlite3_bind_text(stmt, 9, normalization_applied.c_str(), -1, SQLITE_STATIC);
-        sqlite3_bind_text(stmt, 10, rooting_applied.c_str(), -1, SQLITE_STATIC);
-        sqlite3_bind_text(stmt, 11, pooling_applied.c_str(), -1, SQLITE_STATIC);
-
-        rc = sqlite3_step(stmt);
-        if (rc != SQLITE_DONE) {
-            std::cerr << "Failed to insert descriptor " << i << ": " << sqlite3_errmsg(impl_->db) << std::endl;
-            success = false;
-            break;
+    // Queued writes outlive the caller's buffer, so they get their own copy
+    Impl* impl = impl_.get();
+    const cv::Mat rows = impl->config.async_writes ? descriptors.clone() : descriptors;
+    return impl->submit([impl, experiment_id, scene_name, image_name, keypoints, rows, processing_method,
+                         normalization_applied, rooting_applied, pooling_applied]() {
+        auto stmt = impl->writeStatement(INSERT_DESCRIPTOR_SQL);
+        if (!stmt) return false;
+
+        for (size_t i = 0; i < keypoints.size(); ++i) {
+            const cv::KeyPoint& kp = keypoints[i];
+            cv::Mat descriptor_row = rows.row(static_cast<int>(i));
+
+            // Bind parameters
+            sqlite3_bind_int(stmt, 1, experiment_id);
+            sqlite3_bind_text(stmt, 2, scene_name.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_text(stmt, 3, image_name.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_double(stmt, 4, kp.pt.x);
+            sqlite3_bind_double(stmt, 5, kp.pt.y);
+
+            // Store descriptor as binary blob
+            sqlite3_bind_blob(stmt, 6, descriptor_row.data, 
+                             descriptor_row.total() * descriptor_row.elemSize(), SQLITE_STATIC);
+            sqlite3_bind_int(stmt, 7, descriptor_row.cols);
+            sqlite3_bind_text(stmt, 8, processing_method.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_text(stmt, 9, normalization_applied.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_text(stmt, 10, rooting_applied.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_text(stmt, 11, pooling_applied.c_str(), -1, SQLITE_STATIC);
+
+            if (sqlite3_step(stmt) != SQLITE_DONE) {
+                std::cerr << "Failed to insert descriptor " << i << ": " << sqlite3_errmsg(impl->primary.db) << std::endl;
+                return false;
+            }
+            sqlite3_reset(stmt);
         }
 
-        sqlite3_reset(stmt);
-    }
-
-    sqlite3_finalize(stmt);
-
-    if (success) {
-        sqlite3_exec(impl_->db, "COMMIT", nullptr, nullptr, nullptr);
         std::cout << "Stored " << keypoints.size() << " descriptors for " 
                   << scene_name << "/" << image_name << " (experiment " << experiment_id << ")" << std::endl;
-    } else {
-        sqlite3_exec(impl_->db, "ROLLBACK", nullptr, nullptr, nullptr);
-    }
-
-    return success;
+        return true;
+    });
 }
 
 cv::Mat DatabaseManager::getDescriptors(int experiment_id,
                                        const std::string& scene_name,
                                        const std::string& image_name) const {
-    if (!impl_->enabled || !impl_->db) return cv::Mat();
+    if (!impl_->enabled || !impl_->primary.db) return cv::Mat();
+    auto access = impl_->readAccess();
 
     const char* sql = R"(
         SELECT descriptor_vector, descriptor_dimension 
@@ -699,10 +936,9 @@ cv::Mat DatabaseManager::getDescriptors(int experiment_id,
         ORDER BY keypoint_x, keypoint_y
     )";
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(impl_->db, sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        std::cerr << "Failed to prepare descriptor select statement: " << sqlite3_errmsg(impl_->db) << std::endl;
+    ScopedStatement stmt(*access.connection, sql);
+    if (!stmt) {
+        std::cerr << "Failed to prepare descriptor select statement: " << sqlite3_errmsg(access.db()) << std::endl;
         return {};
     }
 
@@ -713,19 +949,21 @@ cv::Mat DatabaseManager::getDescriptors(int experiment_id,
     std::vector<cv::Mat> descriptor_rows;
     int descriptor_dim = 0;
 
-    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
         const void* blob_data = sqlite3_column_blob(stmt, 0);
         int blob_size = sqlite3_column_bytes(stmt, 0);
         descriptor_dim = sqlite3_column_int(stmt, 1);
 
-        // Create cv::Mat from blob data
-        cv::Mat row(1, descriptor_dim, CV_32F);
+        // Create cv::Mat from blob data; element size tells float32 from uint8 (quantized) rows
+        if (descriptor_dim <= 0 || blob_size % descriptor_dim != 0) continue;
+        const int elem_size = blob_size / descriptor_dim;
+        const int type = elem_size == 1 ? CV_8U : CV_32F;
+        if (elem_size != 1 && elem_size != 4) continue;
+        cv::Mat row(1, descriptor_dim, type);
         memcpy(row.data, blob_data, blob_size);
         descriptor_rows.push_back(row);
     }
 
-    sqlite3_finalize(stmt);
-
     if (descriptor_rows.empty()) {
         return {};
     }
@@ -742,7 +980,7 @@ std::vector<std::tuple<std::string, std::string, cv::Mat>> DatabaseManager::getD
     const std::string& rooting_applied) const {
     
     std::vector<std::tuple<std::string, std::string, cv::Mat>> results;
-    if (!impl_->enabled || !impl_->db) return results;
+    if (!impl_->enabled || !impl_->primary.db) return results;
 
     std::string sql = "SELECT DISTINCT scene_name, image_name FROM descriptors WHERE processing_method = ?";
     std::vector<std::string> params = {processing_method};
@@ -756,51 +994,53 @@ std::vector<std::tuple<std::string, std::string, cv::Mat>> DatabaseManager::getD
         params.push_back(rooting_applied);
     }
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(impl_->db, sql.c_str(), -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        std::cerr << "Failed to prepare descriptor method query: " << sqlite3_errmsg(impl_->db) << std::endl;
-        return results;
-    }
+    std::vector<std::pair<std::string, std::string>> scene_images;
+    {
+        auto access = impl_->readAccess();
+        ScopedStatement stmt(*access.connection, sql);
+        if (!stmt) {
+            std::cerr << "Failed to prepare descriptor method query: " << sqlite3_errmsg(access.db()) << std::endl;
+            return results;
+        }
+
+        for (size_t i = 0; i < params.size(); ++i) {
+            sqlite3_bind_text(stmt, i + 1, params[i].c_str(), -1, SQLITE_STATIC);
+        }
 
-    for (size_t i = 0; i < params.size(); ++i) {
-        sqlite3_bind_text(stmt, i + 1, params[i].c_str(), -1, SQLITE_STATIC);
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            scene_images.emplace_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)),
+                                      reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)));
+        }
     }
 
-    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
-        std::string scene = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-        std::string image = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-        
-        // Get descriptors for this scene/image combination
+    // Get descriptors for each scene/image combination (getDescriptors takes the connection itself)
+    for (const auto& [scene, image] : scene_images) {
         cv::Mat descriptors = getDescriptors(-1, scene, image); // Use -1 to get latest
         results.emplace_back(scene, image, descriptors);
     }
-
-    sqlite3_finalize(stmt);
     return results;
 }
 
 std::vector<std::string> DatabaseManager::getAvailableProcessingMethods() const {
     std::vector<std::string> methods;
-    if (!impl_->enabled || !impl_->db) return methods;
+    if (!impl_->enabled || !impl_->primary.db) return methods;
+    auto access = impl_->readAccess();
 
     const char* sql = "SELECT DISTINCT processing_method FROM descriptors ORDER BY processing_method";
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(impl_->db, sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        std::cerr << "Failed to prepare processing methods query: " << sqlite3_errmsg(impl_->db) << std::endl;
+    ScopedStatement stmt(*access.connection, sql);
+    if (!stmt) {
+        std::cerr << "Failed to prepare processing methods query: " << sqlite3_errmsg(access.db()) << std::endl;
         return methods;
     }
 
-    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
         const auto method = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
         if (method) {
             methods.emplace_back(method);
         }
     }
 
-    sqlite3_finalize(stmt);
     return methods;
 }
 
@@ -811,17 +1051,17 @@ int DatabaseManager::createKeypointSet(const std::string& name,
                                       const std::string& dataset_path,
                                       const std::string& description,
                                       int boundary_filter_px) const {
-    if (!impl_->enabled || !impl_->db) return -1;
+    if (!impl_->enabled || !impl_->primary.db) return -1;
+    auto access = impl_->writeAccess();
 
     const auto sql = R"(
         INSERT INTO keypoint_sets (name, generator_type, generation_method, max_features, dataset_path, description, boundary_filter_px)
         VALUES (?, ?, ?, ?, ?, ?, ?)
     )";
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(impl_->db, sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        std::cerr << "Failed to prepare keypoint set insert: " << sqlite3_errmsg(impl_->db) << std::endl;
+    ScopedStatement stmt(*access.connection, sql);
+    if (!stmt) {
+        std::cerr << "Failed to prepare keypoint set insert: " << sqlite3_errmsg(access.db()) << std::endl;
         return -1;
     }
 
@@ -833,68 +1073,55 @@ int DatabaseManager::createKeypointSet(const std::string& name,
     sqlite3_bind_text(stmt, 6, description.c_str(), -1, SQLITE_STATIC);
     sqlite3_bind_int(stmt, 7, boundary_filter_px);
 
-    rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
+    const int rc = sqlite3_step(stmt);
 
     if (rc != SQLITE_DONE) {
-        std::cerr << "Failed to insert keypoint set: " << sqlite3_errmsg(impl_->db) << std::endl;
+        std::cerr << "Failed to insert keypoint set: " << sqlite3_errmsg(access.db()) << std::endl;
         return -1;
     }
 
-    return static_cast<int>(sqlite3_last_insert_rowid(impl_->db));
+    return static_cast<int>(sqlite3_last_insert_rowid(access.db()));
 }
 
 bool DatabaseManager::storeLockedKeypointsForSet(int keypoint_set_id, const std::string& scene_name,
                                                  const std::string& image_name, const std::vector<cv::KeyPoint>& keypoints) const {
-    if (!impl_->enabled || !impl_->db) return true;
-
-    const auto sql = R"(
-        INSERT OR IGNORE INTO locked_keypoints 
-        (keypoint_set_id, scene_name, image_name, x, y, size, angle, response, octave, class_id, valid_bounds)
-        VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
-    )";
-
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(impl_->db, sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        std::cerr << "Failed to prepare keypoint insert: " << sqlite3_errmsg(impl_->db) << std::endl;
-        return false;
-    }
-
-    // Begin transaction for better performance
-    sqlite3_exec(impl_->db, "BEGIN TRANSACTION", nullptr, nullptr, nullptr);
-
-    bool success = true;
-    for (const auto& kp : keypoints) {
-        sqlite3_bind_int(stmt, 1, keypoint_set_id);
-        sqlite3_bind_text(stmt, 2, scene_name.c_str(), -1, SQLITE_STATIC);
-        sqlite3_bind_text(stmt, 3, image_name.c_str(), -1, SQLITE_STATIC);
-        sqlite3_bind_double(stmt, 4, kp.pt.x);
-        sqlite3_bind_double(stmt, 5, kp.pt.y);
-        sqlite3_bind_double(stmt, 6, kp.size);
-        sqlite3_bind_double(stmt, 7, kp.angle);
-        sqlite3_bind_double(stmt, 8, kp.response);
-        sqlite3_bind_int(stmt, 9, kp.octave);
-        sqlite3_bind_int(stmt, 10, kp.class_id);
-        sqlite3_bind_int(stmt, 11, 1); // valid_bounds = true
-
-        int step_rc = sqlite3_step(stmt);
-        if (step_rc != SQLITE_DONE) {
-            std::cerr << "Failed to insert keypoint: " << sqlite3_errmsg(impl_->db) << std::endl;
-            success = false;
+    if (!impl_->enabled || !impl_->primary.db) return true;
+
+    Impl* impl = impl_.get();
+    return impl->submit([impl, keypoint_set_id, scene_name, image_name, keypoints]() {
+        auto stmt = impl->writeStatement(INSERT_SET_KEYPOINT_SQL);
+        if (!stmt) return false;
+
+        bool success = true;
+        for (const auto& kp : keypoints) {
+            sqlite3_bind_int(stmt, 1, keypoint_set_id);
+            sqlite3_bind_text(stmt, 2, scene_name.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_text(stmt, 3, image_name.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_double(stmt, 4, kp.pt.x);
+            sqlite3_bind_double(stmt, 5, kp.pt.y);
+            sqlite3_bind_double(stmt, 6, kp.size);
+            sqlite3_bind_double(stmt, 7, kp.angle);
+            sqlite3_bind_double(stmt, 8, kp.response);
+            sqlite3_bind_int(stmt, 9, kp.octave);
+            sqlite3_bind_int(stmt, 10, kp.class_id);
+            sqlite3_bind_int(stmt, 11, 1); // valid_bounds = true
+
+            int step_rc = sqlite3_step(stmt);
+            if (step_rc != SQLITE_DONE) {
+                std::cerr << "Failed to insert keypoint: " << sqlite3_errmsg(impl->primary.db) << std::endl;
+                success = false;
+            }
+            sqlite3_reset(stmt);
         }
-        sqlite3_reset(stmt);
-    }
-
-    sqlite3_finalize(stmt);
-    sqlite3_exec(impl_->db, "COMMIT", nullptr, nullptr, nullptr);
-    return success;
+        return success;
+    });
 }
 
 std::vector<cv::KeyPoint> DatabaseManager::getLockedKeypointsFromSet(int keypoint_set_id, const std::string& scene_name,
                                                                      const std::string& image_name) const {
     std::vector<cv::KeyPoint> keypoints;
-    if (!impl_->enabled || !impl_->db) return keypoints;
+    if (!impl_->enabled || !impl_->primary.db) return keypoints;
+    auto access = impl_->readAccess();
 
     const auto sql = R"(
         SELECT x, y, size, angle, response, octave, class_id
@@ -903,10 +1130,9 @@ std::vector<cv::KeyPoint> DatabaseManager::getLockedKeypointsFromSet(int keypoin
         ORDER BY response DESC
     )";
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(impl_->db, sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        std::cerr << "Failed to prepare keypoint query: " << sqlite3_errmsg(impl_->db) << std::endl;
+    ScopedStatement stmt(*access.connection, sql);
+    if (!stmt) {
+        std::cerr << "Failed to prepare keypoint query: " << sqlite3_errmsg(access.db()) << std::endl;
         return keypoints;
     }
 
@@ -914,7 +1140,7 @@ std::vector<cv::KeyPoint> DatabaseManager::getLockedKeypointsFromSet(int keypoin
     sqlite3_bind_text(stmt, 2, scene_name.c_str(), -1, SQLITE_STATIC);
     sqlite3_bind_text(stmt, 3, image_name.c_str(), -1, SQLITE_STATIC);
 
-    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
         cv::KeyPoint kp;
         kp.pt.x = sqlite3_column_double(stmt, 0);
         kp.pt.y = sqlite3_column_double(stmt, 1);
@@ -926,13 +1152,13 @@ std::vector<cv::KeyPoint> DatabaseManager::getLockedKeypointsFromSet(int keypoin
         keypoints.push_back(kp);
     }
 
-    sqlite3_finalize(stmt);
     return keypoints;
 }
 
 std::vector<std::tuple<int, std::string, std::string>> DatabaseManager::getAvailableKeypointSets() const {
     std::vector<std::tuple<int, std::string, std::string>> sets;
-    if (!impl_->enabled || !impl_->db) return sets;
+    if (!impl_->enabled || !impl_->primary.db) return sets;
+    auto access = impl_->readAccess();
 
     const auto sql = R"(
         SELECT id, name, generation_method
@@ -940,14 +1166,13 @@ std::vector<std::tuple<int, std::string, std::string>> DatabaseManager::getAvail
         ORDER BY created_at DESC
     )";
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(impl_->db, sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        std::cerr << "Failed to prepare keypoint sets query: " << sqlite3_errmsg(impl_->db) << std::endl;
+    ScopedStatement stmt(*access.connection, sql);
+    if (!stmt) {
+        std::cerr << "Failed to prepare keypoint sets query: " << sqlite3_errmsg(access.db()) << std::endl;
         return sets;
     }
 
-    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
         int id = sqlite3_column_int(stmt, 0);
         const auto name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
         const auto method = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
@@ -957,8 +1182,70 @@ std::vector<std::tuple<int, std::string, std::string>> DatabaseManager::getAvail
         }
     }
 
-    sqlite3_finalize(stmt);
     return sets;
 }
 
+int DatabaseManager::getKeypointSetId(const std::string& name) const {
+    if (!impl_->enabled || !impl_->primary.db) return -1;
+    auto access = impl_->readAccess();
+
+    ScopedStatement stmt(*access.connection, "SELECT id FROM keypoint_sets WHERE name = ?");
+    if (!stmt) {
+        std::cerr << "Failed to prepare keypoint set lookup: " << sqlite3_errmsg(access.db()) << std::endl;
+        return -1;
+    }
+
+    sqlite3_bind_text(stmt, 1, name.c_str(), -1, SQLITE_STATIC);
+    return sqlite3_step(stmt) == SQLITE_ROW ? sqlite3_column_int(stmt, 0) : -1;
+}
+
+KeypointSetIndex DatabaseManager::loadKeypointSet(int keypoint_set_id) const {
+    KeypointSetIndex index;
+    if (!impl_->enabled || !impl_->primary.db) return index;
+    auto access = impl_->readAccess();
+
+    // Walks idx_locked_keypoints_scene, so rows arrive grouped without a sort
+    const auto sql = R"(
+        SELECT scene_name, image_name, x, y, size, angle, response, octave, class_id
+        FROM locked_keypoints
+        WHERE keypoint_set_id = ?
+        ORDER BY scene_name, image_name, id
+    )";
+
+    ScopedStatement stmt(*access.connection, sql);
+    if (!stmt) {
+        std::cerr << "Failed to prepare keypoint set scan: " << sqlite3_errmsg(access.db()) << std::endl;
+        return index;
+    }
+
+    sqlite3_bind_int(stmt, 1, keypoint_set_id);
+
+    std::string scene, image;
+    std::pair<size_t, size_t>* range = nullptr;  // current image's (offset, count)
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        const auto row_scene = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        const auto row_image = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+        if (!row_scene || !row_image) continue;
+        if (!range || scene != row_scene || image != row_image) {
+            scene = row_scene;
+            image = row_image;
+            range = &index.ranges_[scene][image];
+            range->first = index.keypoints_.size();
+        }
+
+        cv::KeyPoint kp;
+        kp.pt.x = sqlite3_column_double(stmt, 2);
+        kp.pt.y = sqlite3_column_double(stmt, 3);
+        kp.size = sqlite3_column_double(stmt, 4);
+        kp.angle = sqlite3_column_double(stmt, 5);
+        kp.response = sqlite3_column_double(stmt, 6);
+        kp.octave = sqlite3_column_int(stmt, 7);
+        kp.class_id = sqlite3_column_int(stmt, 8);
+        index.keypoints_.push_back(kp);
+        range->second++;
+    }
+
+    return index;
+}
+
 } // namespace thesis_project::database
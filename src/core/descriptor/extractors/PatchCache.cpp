@@ -0,0 +1,173 @@
+#include "PatchCache.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace thesis_project {
+namespace extractors {
+
+namespace {
+
+// FNV-1a, 64-bit
+constexpr uint64_t kFnvOffset = 1469598103934665603ULL;
+constexpr uint64_t kFnvPrime = 1099511628211ULL;
+
+inline uint64_t fnv1a(uint64_t h, const void* data, size_t len) {
+    const auto* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < len; ++i) {
+        h ^= p[i];
+        h *= kFnvPrime;
+    }
+    return h;
+}
+
+template <typename T>
+inline uint64_t fnv1a(uint64_t h, const T& v) {
+    return fnv1a(h, &v, sizeof(T));
+}
+
+constexpr int kSampledRows = 64;  // image rows hashed per key
+
+// FNV-1a over 64-bit words (byte tail folded in), for bulk pixel data
+inline uint64_t fnv1aWords(uint64_t h, const unsigned char* p, size_t len) {
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+        uint64_t w;
+        std::memcpy(&w, p + i, sizeof(w));
+        h ^= w;
+        h *= kFnvPrime;
+    }
+    return fnv1a(h, p + i, len - i);
+}
+
+// Dimensions, type and up to kSampledRows evenly spaced rows; the keypoint hash
+// and the key's equality check cover the rest
+uint64_t hashImage(const cv::Mat& image) {
+    uint64_t h = kFnvOffset;
+    h = fnv1a(h, image.rows);
+    h = fnv1a(h, image.cols);
+    const int t = image.type();
+    h = fnv1a(h, t);
+    if (image.rows <= 0) return h;
+    const size_t rowBytes = static_cast<size_t>(image.cols) * image.elemSize();
+    const int step = std::max(1, image.rows / kSampledRows);
+    for (int r = 0; r < image.rows; r += step) {
+        h = fnv1aWords(h, image.ptr(r), rowBytes);
+    }
+    return fnv1aWords(h, image.ptr(image.rows - 1), rowBytes);
+}
+
+uint64_t hashKeypoints(const std::vector<cv::KeyPoint>& keypoints) {
+    uint64_t h = kFnvOffset;
+    const size_t n = keypoints.size();
+    h = fnv1a(h, n);
+    for (const auto& kp : keypoints) {
+        h = fnv1a(h, kp.pt.x);
+        h = fnv1a(h, kp.pt.y);
+        h = fnv1a(h, kp.size);
+        h = fnv1a(h, kp.angle);
+    }
+    return h;
+}
+
+} // namespace
+
+PatchCache& PatchCache::instance() {
+    static PatchCache cache;
+    return cache;
+}
+
+PatchCache::Key PatchCache::makeKey(const cv::Mat& imageGray,
+                                    const std::vector<cv::KeyPoint>& keypoints,
+                                    int input_size,
+                                    float support_multiplier,
+                                    bool rotate_upright) {
+    Key key;
+    key.image_hash = hashImage(imageGray);
+    key.keypoints_hash = hashKeypoints(keypoints);
+    key.image_rows = imageGray.rows;
+    key.image_cols = imageGray.cols;
+    key.image_type = imageGray.type();
+    key.keypoint_count = keypoints.size();
+    key.input_size = input_size;
+    key.support_multiplier = support_multiplier;
+    key.rotate_upright = rotate_upright;
+    return key;
+}
+
+size_t PatchCache::KeyHash::operator()(const Key& k) const {
+    uint64_t h = kFnvOffset;
+    h = fnv1a(h, k.image_hash);
+    h = fnv1a(h, k.keypoints_hash);
+    h = fnv1a(h, k.input_size);
+    h = fnv1a(h, k.support_multiplier);
+    h = fnv1a(h, k.rotate_upright);
+    return static_cast<size_t>(h);
+}
+
+std::shared_ptr<const cv::Mat> PatchCache::get(const Key& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        ++stats_.misses;
+        return nullptr;
+    }
+    ++stats_.hits;
+    return it->second;
+}
+
+std::shared_ptr<const cv::Mat> PatchCache::put(const Key& key, const cv::Mat& patches) {
+    auto entry = std::make_shared<const cv::Mat>(patches);
+    const size_t bytes = patches.total() * patches.elemSize();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) return it->second;  // another consumer got there first
+
+    if (stats_.bytes + bytes > capacity_bytes_) {
+        ++stats_.rejected;
+        return entry;
+    }
+    entries_.emplace(key, entry);
+    stats_.bytes += bytes;
+    stats_.entries = entries_.size();
+    return entry;
+}
+
+void PatchCache::releaseGeometry(int input_size, float support_multiplier, bool rotate_upright) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        const Key& k = it->first;
+        if (k.input_size == input_size && k.support_multiplier == support_multiplier &&
+            k.rotate_upright == rotate_upright) {
+            stats_.bytes -= it->second->total() * it->second->elemSize();
+            it = entries_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    stats_.entries = entries_.size();
+}
+
+void PatchCache::setCapacityBytes(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_bytes_ = bytes;
+}
+
+size_t PatchCache::capacityBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return capacity_bytes_;
+}
+
+void PatchCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    stats_ = Stats{};
+}
+
+PatchCache::Stats PatchCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+} // namespace extractors
+} // namespace thesis_project
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <opencv2/features2d.hpp>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace thesis_project {
+namespace extractors {
+
+/**
+ * @brief Process-wide cache of raw 8-bit keypoint patches
+ *
+ * Warped patches depend only on the image, the keypoint set and the patch
+ * geometry (input size, support multiplier, upright rotation). Several DNN
+ * descriptor configs in one run (different models, normalizations) therefore
+ * share the same patches; each consumer applies its own normalization on top.
+ *
+ * Entries are stored as a CV_8U matrix of shape [K, N*N] (one row per keypoint).
+ * The cache is bounded by a byte budget. Once full, new entries are not
+ * admitted: runs sweep scenes in the same order for every descriptor, and
+ * LRU eviction under that cyclic access pattern would evict every entry
+ * before it is reused. Consumers opt in only when another config will warp
+ * the same patches, and releaseGeometry() drops a geometry's entries once
+ * its last consumer is done.
+ *
+ * The image part of the key hashes the image dimensions, type and an evenly
+ * spaced sample of rows, not every byte. The keypoints are hashed in full.
+ * Dimensions, type and keypoint count are also compared on every hit.
+ */
+class PatchCache {
+public:
+    struct Key {
+        uint64_t image_hash = 0;
+        uint64_t keypoints_hash = 0;
+        int image_rows = 0;
+        int image_cols = 0;
+        int image_type = -1;
+        size_t keypoint_count = 0;
+        int input_size = 0;
+        float support_multiplier = 0.0f;
+        bool rotate_upright = false;
+
+        bool operator==(const Key& o) const {
+            return image_hash == o.image_hash && keypoints_hash == o.keypoints_hash &&
+                   image_rows == o.image_rows && image_cols == o.image_cols && image_type == o.image_type &&
+                   keypoint_count == o.keypoint_count &&
+                   input_size == o.input_size && support_multiplier == o.support_multiplier &&
+                   rotate_upright == o.rotate_upright;
+        }
+    };
+
+    struct Stats {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t rejected = 0;   // entries not admitted because the budget was exhausted
+        size_t entries = 0;
+        size_t bytes = 0;
+    };
+
+    static PatchCache& instance();
+
+    static Key makeKey(const cv::Mat& imageGray,
+                       const std::vector<cv::KeyPoint>& keypoints,
+                       int input_size,
+                       float support_multiplier,
+                       bool rotate_upright);
+
+    /// @return cached [K, N*N] CV_8U patches, or nullptr on miss
+    std::shared_ptr<const cv::Mat> get(const Key& key);
+
+    /// Store patches (takes a reference to the matrix data, no copy). Returns the stored entry.
+    std::shared_ptr<const cv::Mat> put(const Key& key, const cv::Mat& patches);
+
+    /// Drop every entry warped with this geometry (its last consumer has finished)
+    void releaseGeometry(int input_size, float support_multiplier, bool rotate_upright);
+
+    void setCapacityBytes(size_t bytes);
+    size_t capacityBytes() const;
+    void clear();
+    Stats stats() const;
+
+private:
+    PatchCache() = default;
+
+    struct KeyHash {
+        size_t operator()(const Key& k) const;
+    };
+
+    mutable std::mutex mutex_;
+    std::unordered_map<Key, std::shared_ptr<const cv::Mat>, KeyHash> entries_;
+    size_t capacity_bytes_ = size_t(2) << 30;  // 2 GiB: full HPatches at 32x32 fits
+    Stats stats_;
+};
+
+} // namespace extractors
+} // namespace thesis_project
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <opencv2/features2d.hpp>
+#include <stdexcept>
+#include <vector>
+
+namespace thesis_project {
+namespace wrappers {
+
+/**
+ * @brief Run fn(image, keypoints) for each image of a batch in parallel
+ *
+ * fn must be safe to call concurrently; the SIFT-family wrappers build a
+ * fresh descriptor instance inside fn rather than sharing their member.
+ */
+template <typename Fn>
+std::vector<cv::Mat> extractImagesInParallel(const std::vector<cv::Mat>& images,
+                                             const std::vector<std::vector<cv::KeyPoint>>& keypointSets,
+                                             Fn fn) {
+    if (images.size() != keypointSets.size()) {
+        throw std::invalid_argument("extractBatch: images and keypointSets differ in size");
+    }
+    std::vector<cv::Mat> out(images.size());
+    cv::parallel_for_(cv::Range(0, static_cast<int>(images.size())), [&](const cv::Range& r) {
+        for (int i = r.start; i < r.end; ++i) {
+            out[i] = fn(images[i], keypointSets[i]);
+        }
+    });
+    return out;
+}
+
+} // namespace wrappers
+} // namespace thesis_project
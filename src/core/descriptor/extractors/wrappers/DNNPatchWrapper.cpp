@@ -47,7 +47,7 @@ void DNNPatchWrapper::setBackendTarget(int backend, int target) {
     net_.setPreferableTarget(target);
 }
 
-cv::Mat DNNPatchWrapper::makePatch_(const cv::Mat& imageGray, const cv::KeyPoint& kp) const {
+void DNNPatchWrapper::warpPatch_(const cv::Mat& imageGray, const cv::KeyPoint& kp, cv::Mat& patch8u) const {
     // kp.angle == -1 means "unset" -> treat as 0
     const float angle_deg = (rotate_upright_ && kp.angle >= 0.f) ? -kp.angle : 0.f;
 
@@ -61,10 +61,38 @@ cv::Mat DNNPatchWrapper::makePatch_(const cv::Mat& imageGray, const cv::KeyPoint
     M.at<double>(0, 2) += (input_size_ * 0.5 - kp.pt.x);
     M.at<double>(1, 2) += (input_size_ * 0.5 - kp.pt.y);
 
-    cv::Mat patch8u;
     cv::warpAffine(imageGray, patch8u, M, cv::Size(input_size_, input_size_),
                    cv::INTER_LINEAR, cv::BORDER_REPLICATE);
+}
+
+std::shared_ptr<const cv::Mat> DNNPatchWrapper::rawPatches_(const cv::Mat& imageGray,
+                                                            const std::vector<cv::KeyPoint>& keypoints) const {
+    if (imageGray.depth() != CV_8U) {
+        // Patches are warped straight into CV_8U rows; any other depth would reallocate dst
+        throw std::invalid_argument("DNNPatchWrapper: patches need an 8-bit grayscale image");
+    }
+
+    extractors::PatchCache::Key key;
+    if (use_patch_cache_) {
+        key = extractors::PatchCache::makeKey(imageGray, keypoints, input_size_, support_mult_, rotate_upright_);
+        if (auto hit = extractors::PatchCache::instance().get(key)) return hit;
+    }
+
+    const int N = input_size_;
+    const int K = static_cast<int>(keypoints.size());
+    cv::Mat patches(K, N * N, CV_8U);
+    cv::parallel_for_(cv::Range(0, K), [&](const cv::Range& r) {
+        for (int i = r.start; i < r.end; ++i) {
+            cv::Mat dst(N, N, CV_8U, patches.ptr<uchar>(i));  // warp straight into row i
+            warpPatch_(imageGray, keypoints[i], dst);
+        }
+    });
+
+    if (use_patch_cache_) return extractors::PatchCache::instance().put(key, patches);
+    return std::make_shared<const cv::Mat>(patches);
+}
 
+cv::Mat DNNPatchWrapper::normalizePatch_(const cv::Mat& patch8u) const {
     cv::Mat patch32f;
     patch8u.convertTo(patch32f, CV_32F, 1.0 / 255.0);  // [0,1]
 
@@ -81,37 +109,123 @@ cv::Mat DNNPatchWrapper::makePatch_(const cv::Mat& imageGray, const cv::KeyPoint
     return patch32f; // single-channel float N×N
 }
 
+void DNNPatchWrapper::writeDescriptorRows_(const cv::Mat& netOut, int B,
+                                           cv::Mat& descriptors, int rowOffset) const {
+    cv::Mat out = netOut;
+    if (out.depth() != CV_32F) {
+        cv::Mat tmp;
+        out.convertTo(tmp, CV_32F);
+        out = tmp;
+    }
+    if (!out.isContinuous()) out = out.clone();
+
+    // Resolve per-sample layout. Supported: [B,C,H,W], [B,C,1,1], [B,C] and [1,B*C].
+    const size_t total = out.total();
+    if (B <= 0 || total % static_cast<size_t>(B) != 0) {
+        throw std::runtime_error("Unexpected DNN output shape (not divisible by batch).");
+    }
+    const int perSample = static_cast<int>(total / static_cast<size_t>(B));
+    int C_raw = perSample;
+    int HW = 1;
+    if (out.dims >= 3 && out.size[0] == B && out.size[1] > 0) {
+        C_raw = out.size[1];
+        HW = perSample / C_raw;           // spatial extent to average over (1 for [B,C,1,1])
+    } else if (out.dims == 2 && out.rows == B) {
+        C_raw = out.cols;
+    } else if (!(out.dims == 2 && out.rows == 1)) {
+        throw std::runtime_error("Unexpected DNN output layout after forward");
+    }
+
+    const int C_expected = descriptor_size_;
+    const int C_copy = std::min(C_raw, C_expected);
+    const float invHW = 1.0f / static_cast<float>(HW);
+    const float* base = out.ptr<float>();
+
+    cv::parallel_for_(cv::Range(0, B), [&](const cv::Range& r) {
+        for (int b = r.start; b < r.end; ++b) {
+            const float* src = base + static_cast<size_t>(b) * perSample;
+            float* dst = descriptors.ptr<float>(rowOffset + b);
+
+            // Global average pool (no-op when HW == 1), truncating to C_expected
+            if (HW == 1) {
+                for (int c = 0; c < C_copy; ++c) dst[c] = src[c];
+            } else {
+                for (int c = 0; c < C_copy; ++c) {
+                    const float* p = src + static_cast<size_t>(c) * HW;
+                    float sum = 0.0f;
+                    for (int i = 0; i < HW; ++i) sum += p[i];
+                    dst[c] = sum * invHW;
+                }
+            }
+            // Zero-pad short outputs
+            for (int c = C_copy; c < C_expected; ++c) dst[c] = 0.0f;
+
+            // L2 normalize in place (all-zero rows stay zero, as with cv::normalize)
+            float sq = 0.0f;
+            for (int c = 0; c < C_copy; ++c) sq += dst[c] * dst[c];
+            if (sq > 0.0f) {
+                const float inv = 1.0f / std::sqrt(sq);
+                for (int c = 0; c < C_copy; ++c) dst[c] *= inv;
+            }
+        }
+    });
+}
+
 cv::Mat DNNPatchWrapper::extract(const cv::Mat& imageBgrOrGray,
                                  const std::vector<cv::KeyPoint>& keypoints,
-                                 const DescriptorParams& /*params*/) {
-    // ---- 0) Ensure single-channel source once
-    cv::Mat imageGray;
-    if (imageBgrOrGray.channels() == 1) {
-        imageGray = imageBgrOrGray;
-    } else {
-        cv::cvtColor(imageBgrOrGray, imageGray, cv::COLOR_BGR2GRAY);
+                                 const DescriptorParams& params) {
+    return extractBatch({imageBgrOrGray}, {keypoints}, params).front();
+}
+
+std::vector<cv::Mat> DNNPatchWrapper::extractBatch(const std::vector<cv::Mat>& images,
+                                                   const std::vector<std::vector<cv::KeyPoint>>& keypointSets,
+                                                   const DescriptorParams& /*params*/) {
+    if (images.size() != keypointSets.size()) {
+        throw std::invalid_argument("extractBatch: images and keypointSets differ in size");
     }
 
     const int N = input_size_;
     const int C_expected = descriptor_size_;
-    const int totalKp = static_cast<int>(keypoints.size());
-    cv::Mat descriptors(totalKp, C_expected, CV_32F, cv::Scalar(0));
+    const size_t numImages = images.size();
+
+    // ---- 0) Raw 8-bit patches [K_i, N*N] per image (shared with other DNN configs via PatchCache)
+    std::vector<std::shared_ptr<const cv::Mat>> patches(numImages);
+    std::vector<int> offsets(numImages + 1, 0);   // image i owns global rows [offsets[i], offsets[i+1])
+    for (size_t i = 0; i < numImages; ++i) {
+        cv::Mat imageGray;
+        if (images[i].channels() == 1) {
+            imageGray = images[i];
+        } else {
+            cv::cvtColor(images[i], imageGray, cv::COLOR_BGR2GRAY);
+        }
+        // Patches are 8-bit (normalized by 1/255 later); saturate other depths once per image
+        if (imageGray.depth() != CV_8U) {
+            cv::Mat gray8u;
+            imageGray.convertTo(gray8u, CV_8U);
+            imageGray = gray8u;
+        }
+        patches[i] = rawPatches_(imageGray, keypointSets[i]);
+        offsets[i + 1] = offsets[i] + static_cast<int>(keypointSets[i].size());
+    }
 
-    if (totalKp == 0) return descriptors;
+    const int totalKp = offsets.back();
+    cv::Mat descriptors(totalKp, C_expected, CV_32F, cv::Scalar(0));
 
-    // Batching
+    // ---- 1) Forward in fixed-size batches that span image boundaries
     const int BATCH = std::max(1, default_batch_size_);
     std::vector<cv::Mat> batch;
-    batch.reserve(std::min(totalKp, BATCH));
 
-    int start = 0;
-    while (start < totalKp) {
-        batch.clear();
+    for (int start = 0; start < totalKp; ) {
         const int end = std::min(start + BATCH, totalKp);
+        batch.resize(end - start);
 
-        for (int i = start; i < end; ++i) {
-            batch.push_back(makePatch_(imageGray, keypoints[i]));
-        }
+        cv::parallel_for_(cv::Range(start, end), [&](const cv::Range& r) {
+            for (int g = r.start; g < r.end; ++g) {
+                const size_t img = static_cast<size_t>(
+                    std::upper_bound(offsets.begin(), offsets.end(), g) - offsets.begin() - 1);
+                batch[g - start] = normalizePatch_(patches[img]->row(g - offsets[img]).reshape(1, N));
+            }
+        });
 
         // blobFromImages -> shape (B,1,N,N)
         cv::Mat blob = cv::dnn::blobFromImages(
@@ -126,80 +240,8 @@ cv::Mat DNNPatchWrapper::extract(const cv::Mat& imageBgrOrGray,
 
             cv::Mat out = output_name_.empty() ? net_.forward() : net_.forward(output_name_);
 
-            // Normalize output to shape [B, C]
-            const int B = end - start;
-            cv::Mat out2;
-            if (out.dims == 4 && out.size[2] == 1 && out.size[3] == 1) {
-                // [B, C, 1, 1] -> [B, C]
-                out2 = out.reshape(1, out.size[0]);
-            } else if (out.dims == 4 && (out.size[2] > 1 || out.size[3] > 1)) {
-                // [B, C, H, W] -> global average pool to [B, C]
-                int Bn = out.size[0], Cn = out.size[1], H = out.size[2], W = out.size[3];
-                if (out.type() != CV_32F) {
-                    cv::Mat tmp;
-                    out.convertTo(tmp, CV_32F);
-                    out = tmp;
-                }
-                out2.create(Bn, Cn, CV_32F);
-                const int HW = H * W;
-                for (int b = 0; b < Bn; ++b) {
-                    for (int c = 0; c < Cn; ++c) {
-                        const float* p = out.ptr<float>(b, c);
-                        double sum = 0.0;
-                        for (int i = 0; i < HW; ++i) sum += p[i];
-                        out2.at<float>(b, c) = static_cast<float>(sum / (double)HW);
-                    }
-                }
-            } else if (out.dims == 2) {
-                // [B, C]
-                out2 = out;
-            } else {
-                // Fallback: flatten to [B, C]
-                int total = static_cast<int>(out.total());
-                if (B <= 0 || total % B != 0) {
-                    throw std::runtime_error("Unexpected DNN output shape (not divisible by batch).");
-                }
-                int C = total / B;
-                out2 = out.reshape(1, B);
-                if (out2.cols != C) {
-                    out2 = out.reshape(1, B); // ensure rows=B, cols computed
-                }
-            }
-
-            if (out2.type() != CV_32F) out2.convertTo(out2, CV_32F);
-
-            // Handle two cases: [B, C_raw] or [1, B*C_raw]
-            if (out2.rows == B) {
-                const int C = out2.cols;
-                for (int b = 0; b < B; ++b) {
-                    cv::Mat srcRow = out2.row(b);
-                    cv::Mat dstRow = descriptors.row(start + b);
-                    if (C >= C_expected) {
-                        srcRow.colRange(0, C_expected).copyTo(dstRow);
-                    } else {
-                        if (C > 0) srcRow.colRange(0, C).copyTo(dstRow.colRange(0, C));
-                        if (C < C_expected) dstRow.colRange(C, C_expected).setTo(0);
-                    }
-                    cv::normalize(dstRow, dstRow, 1.0, 0.0, cv::NORM_L2);
-                }
-            } else if (out2.rows == 1 && out2.cols % B == 0) {
-                const int C_raw = out2.cols / B;
-                for (int b = 0; b < B; ++b) {
-                    int startCol = b * C_raw;
-                    int endCol = (b + 1) * C_raw;
-                    cv::Mat srcSeg = out2.colRange(startCol, endCol);
-                    cv::Mat dstRow = descriptors.row(start + b);
-                    if (C_raw >= C_expected) {
-                        srcSeg.colRange(0, C_expected).copyTo(dstRow);
-                    } else {
-                        if (C_raw > 0) srcSeg.colRange(0, C_raw).copyTo(dstRow.colRange(0, C_raw));
-                        if (C_raw < C_expected) dstRow.colRange(C_raw, C_expected).setTo(0);
-                    }
-                    cv::normalize(dstRow, dstRow, 1.0, 0.0, cv::NORM_L2);
-                }
-            } else {
-                throw std::runtime_error("Unexpected DNN output layout after forward");
-            }
+            // Pool / truncate / pad / L2 straight into descriptors rows [start, end)
+            writeDescriptorRows_(out, end - start, descriptors, start);
         } catch (const std::exception& e) {
             throw std::runtime_error(std::string("DNN forward pass failed: ") + e.what());
         }
@@ -207,7 +249,12 @@ cv::Mat DNNPatchWrapper::extract(const cv::Mat& imageBgrOrGray,
         start = end;
     }
 
-    return descriptors;
+    // ---- 2) Hand back per-image row ranges of the shared buffer
+    std::vector<cv::Mat> result(numImages);
+    for (size_t i = 0; i < numImages; ++i) {
+        result[i] = descriptors.rowRange(offsets[i], offsets[i + 1]);
+    }
+    return result;
 }
 
 } // namespace wrappers
@@ -4,9 +4,11 @@
 #include <opencv2/core.hpp>
 #include <opencv2/dnn.hpp>
 #include <opencv2/features2d.hpp>
+#include <memory>
 #include <string>
 #include <vector>
 #include "interfaces/IDescriptorExtractor.hpp"
+#include "src/core/descriptor/extractors/PatchCache.hpp"
 #include "src/core/config/experiment_config.hpp"
 #include <opencv2/dnn.hpp>
 
@@ -34,19 +36,38 @@ public:
     // Prefer explicit backend/target once you're ready (CPU is the safest default)
     void setBackendTarget(int backend, int target);
 
+    // Reuse warped 8-bit patches across DNN configs with the same geometry (off by default)
+    void setPatchCacheEnabled(bool enabled) { use_patch_cache_ = enabled; }
+
     // Main API: extract descriptors for keypoints in 'image'
     cv::Mat extract(const cv::Mat& imageBgrOrGray,
                     const std::vector<cv::KeyPoint>& keypoints,
                     const DescriptorParams& params /* not used, kept for API compatibility */) override;
 
+    // Several images at once: patches from all images are packed into shared forward batches
+    std::vector<cv::Mat> extractBatch(const std::vector<cv::Mat>& images,
+                                      const std::vector<std::vector<cv::KeyPoint>>& keypointSets,
+                                      const DescriptorParams& params = {}) override;
+
     // IDescriptorExtractor interface
     std::string name() const override { return "dnn_patch"; }
     int descriptorSize() const override { return descriptor_size_; }
     int descriptorType() const override { return CV_32F; }
 
 private:
-    // Single-patch maker (grayscale + warp + float + normalization)
-    cv::Mat makePatch_(const cv::Mat& imageGray, const cv::KeyPoint& kp) const;
+    // Warp one keypoint's support region into an N×N 8-bit patch
+    void warpPatch_(const cv::Mat& imageGray, const cv::KeyPoint& kp, cv::Mat& patch8u) const;
+
+    // All raw patches for an image as [K, N*N] CV_8U (from PatchCache when enabled)
+    std::shared_ptr<const cv::Mat> rawPatches_(const cv::Mat& imageGray,
+                                               const std::vector<cv::KeyPoint>& keypoints) const;
+
+    // 8-bit patch -> float N×N with this model's normalization (per-patch z-score or global mean/std)
+    cv::Mat normalizePatch_(const cv::Mat& patch8u) const;
+
+    // Reduce raw network output for B samples to [B, descriptor_size_] (GAP, truncate/pad, L2)
+    // and write it into descriptors rows [rowOffset, rowOffset + B), parallel over the batch
+    void writeDescriptorRows_(const cv::Mat& netOut, int B, cv::Mat& descriptors, int rowOffset) const;
 
 private:
     cv::dnn::Net net_;
@@ -67,6 +88,8 @@ private:
 
     // Tuning knob for batching
     int   default_batch_size_     = 512;
+
+    bool  use_patch_cache_        = false; // share raw patches through extractors::PatchCache (runner opts in)
 };
 
 } // namespace wrappers
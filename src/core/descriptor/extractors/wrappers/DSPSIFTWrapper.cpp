@@ -1,4 +1,5 @@
 #include "DSPSIFTWrapper.hpp"
+#include "BatchExtraction.hpp"
 #include <algorithm>
 #include <sstream>
 
@@ -14,32 +15,51 @@ DSPSIFTWrapper::DSPSIFTWrapper(const experiment_config& config)
     dspsift_ = DSPSIFT::create();
 }
 
+namespace {
+
+struct DSPRange {
+    int numScales;
+    double linePoint1;
+    double linePoint2;
+};
+
+// Heuristic mapping: if scales provided, use them to derive DSP range
+DSPRange dspRangeFromParams(const DescriptorParams& params) {
+    if (!params.scales.empty()) {
+        auto [minIt, maxIt] = std::minmax_element(params.scales.begin(), params.scales.end());
+        return {static_cast<int>(params.scales.size()), static_cast<double>(*minIt), static_cast<double>(*maxIt)};
+    }
+    // Sensible defaults (small pooling around 1.0)
+    return {3, 0.85, 1.30};
+}
+
+} // namespace
+
 cv::Mat DSPSIFTWrapper::extract(const cv::Mat& image,
                                const std::vector<cv::KeyPoint>& keypoints,
                                const DescriptorParams& params) {
     cv::Mat descriptors;
     std::vector<cv::KeyPoint> kps = keypoints;
-
-    // Heuristic mapping: if scales provided, use them to derive DSP range
-    int numScales = 1;
-    double linePoint1 = 1.0, linePoint2 = 1.0;
-    if (!params.scales.empty()) {
-        numScales = static_cast<int>(params.scales.size());
-        auto [minIt, maxIt] = std::minmax_element(params.scales.begin(), params.scales.end());
-        linePoint1 = static_cast<double>(*minIt);
-        linePoint2 = static_cast<double>(*maxIt);
-    } else {
-        // Sensible defaults (small pooling around 1.0)
-        numScales = 3;
-        linePoint1 = 0.85;
-        linePoint2 = 1.30;
-    }
+    const DSPRange range = dspRangeFromParams(params);
 
     // Call DSPSIFT compute
-    dspsift_->compute(image, kps, descriptors, numScales, linePoint1, linePoint2);
+    dspsift_->compute(image, kps, descriptors, range.numScales, range.linePoint1, range.linePoint2);
     return descriptors;
 }
 
+std::vector<cv::Mat> DSPSIFTWrapper::extractBatch(const std::vector<cv::Mat>& images,
+                                                  const std::vector<std::vector<cv::KeyPoint>>& keypointSets,
+                                                  const DescriptorParams& params) {
+    const DSPRange range = dspRangeFromParams(params);
+    return extractImagesInParallel(images, keypointSets,
+        [&range](const cv::Mat& image, const std::vector<cv::KeyPoint>& keypoints) {
+            cv::Mat descriptors;
+            std::vector<cv::KeyPoint> kps = keypoints;
+            DSPSIFT::create()->compute(image, kps, descriptors, range.numScales, range.linePoint1, range.linePoint2);
+            return descriptors;
+        });
+}
+
 std::string DSPSIFTWrapper::getConfiguration() const {
     std::stringstream ss;
     ss << "DSPSIFT Wrapper Configuration\n";
@@ -1,4 +1,5 @@
 #include "HoNCWrapper.hpp"
+#include "BatchExtraction.hpp"
 #include <sstream>
 
 namespace thesis_project {
@@ -22,6 +23,19 @@ cv::Mat HoNCWrapper::extract(const cv::Mat& image,
     return descriptors;
 }
 
+std::vector<cv::Mat> HoNCWrapper::extractBatch(const std::vector<cv::Mat>& images,
+                                               const std::vector<std::vector<cv::KeyPoint>>& keypointSets,
+                                               const DescriptorParams& /*params*/) {
+    return extractImagesInParallel(images, keypointSets,
+        [](const cv::Mat& image, const std::vector<cv::KeyPoint>& keypoints) {
+            cv::Mat descriptors;
+            std::vector<cv::KeyPoint> mutable_keypoints = keypoints;
+            HoNC honc;
+            honc.compute(image, mutable_keypoints, descriptors);
+            return descriptors;
+        });
+}
+
 std::string HoNCWrapper::getConfiguration() const {
     std::stringstream ss;
     ss << "HoNC Wrapper Configuration:\n";
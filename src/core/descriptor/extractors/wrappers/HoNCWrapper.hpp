@@ -21,6 +21,11 @@ public:
                     const std::vector<cv::KeyPoint>& keypoints,
                     const DescriptorParams& params = {}) override;
 
+    // Images run in parallel, each with its own HoNC instance
+    std::vector<cv::Mat> extractBatch(const std::vector<cv::Mat>& images,
+                                      const std::vector<std::vector<cv::KeyPoint>>& keypointSets,
+                                      const DescriptorParams& params = {}) override;
+
     std::string name() const override { return "HoNC"; }
     int descriptorSize() const override { return 128; }
     int descriptorType() const override { return DESCRIPTOR_HoNC; }
@@ -1,15 +1,21 @@
 #include "PseudoDNNWrapper.hpp"
+#include "thesis_project/logging.hpp"
 #include <opencv2/imgproc.hpp>
 #include <cmath>
+#include <stdexcept>
 
 namespace thesis_project {
 namespace wrappers {
 
-PseudoDNNWrapper::PseudoDNNWrapper(int input_size, float support_multiplier, bool rotate_to_upright)
+PseudoDNNWrapper::PseudoDNNWrapper(int input_size, float support_multiplier, bool rotate_to_upright,
+                                   const std::string& pca_path)
     : input_size_(input_size), support_mult_(support_multiplier), rotate_upright_(rotate_to_upright) {
+    if (!pca_path.empty() && !loadPCA(pca_path)) {
+        throw std::runtime_error("Failed to load PseudoDNN PCA projection: " + pca_path);
+    }
 }
 
-cv::Mat PseudoDNNWrapper::extractPatch(const cv::Mat& image, const cv::KeyPoint& kp) {
+cv::Mat PseudoDNNWrapper::extractPatch(const cv::Mat& image, const cv::KeyPoint& kp) const {
     float S = std::max(1.0f, support_mult_ * kp.size);
     // Undo keypoint angle to rotate patch to upright
     float angle = rotate_upright_ ? -kp.angle : 0.0f;
@@ -28,126 +34,186 @@ cv::Mat PseudoDNNWrapper::extractPatch(const cv::Mat& image, const cv::KeyPoint&
     return patch;
 }
 
-cv::Mat PseudoDNNWrapper::computePseudoCNNFeatures(const cv::Mat& patch) {
-    std::vector<cv::Mat> features;
-    
+void PseudoDNNWrapper::computePseudoCNNFeatures(const cv::Mat& patch, float* out) const {
+    cv::Mat features[kFeatureMaps];
+
     // Simulate conv layer 1: Multi-scale Gaussian filtering
     for (int sigma = 1; sigma <= 3; sigma++) {
         cv::Mat blurred;
         cv::GaussianBlur(patch, blurred, cv::Size(5, 5), sigma);
-        
+
         // Compute gradients (simulates edge detection)
         cv::Mat grad_x, grad_y;
         cv::Sobel(blurred, grad_x, CV_32F, 1, 0, 3);
         cv::Sobel(blurred, grad_y, CV_32F, 0, 1, 3);
-        
-        cv::Mat magnitude;
-        cv::magnitude(grad_x, grad_y, magnitude);
-        features.push_back(magnitude);
+
+        cv::magnitude(grad_x, grad_y, features[sigma - 1]);
     }
-    
-    // Simulate conv layer 2: Local binary patterns
-    cv::Mat lbp = cv::Mat::zeros(patch.size(), CV_8U);
-    for (int i = 1; i < patch.rows - 1; i++) {
-        for (int j = 1; j < patch.cols - 1; j++) {
-            uint8_t center = patch.at<uint8_t>(i, j);
-            uint8_t code = 0;
-            
-            // 8-connected LBP
-            code |= (patch.at<uint8_t>(i-1, j-1) > center) << 7;
-            code |= (patch.at<uint8_t>(i-1, j) > center) << 6;
-            code |= (patch.at<uint8_t>(i-1, j+1) > center) << 5;
-            code |= (patch.at<uint8_t>(i, j+1) > center) << 4;
-            code |= (patch.at<uint8_t>(i+1, j+1) > center) << 3;
-            code |= (patch.at<uint8_t>(i+1, j) > center) << 2;
-            code |= (patch.at<uint8_t>(i+1, j-1) > center) << 1;
-            code |= (patch.at<uint8_t>(i, j-1) > center) << 0;
-            
-            lbp.at<uint8_t>(i, j) = code;
+
+    // Simulate conv layer 2: 8-connected local binary patterns, one whole-ROI
+    // compare per neighbour (border pixels stay 0)
+    cv::Mat lbp = cv::Mat::zeros(patch.rows, patch.cols, CV_8U);
+    if (patch.rows > 2 && patch.cols > 2) {
+        const cv::Rect inner(1, 1, patch.cols - 2, patch.rows - 2);
+        const cv::Mat center = patch(inner);
+        cv::Mat code = lbp(inner);
+        // (dy, dx) in bit order 7..0: TL, T, TR, R, BR, B, BL, L
+        static const int offsets[8][2] = {{-1, -1}, {-1, 0}, {-1, 1}, {0, 1},
+                                          {1, 1},   {1, 0},  {1, -1}, {0, -1}};
+        cv::Mat bit;
+        for (int k = 0; k < 8; ++k) {
+            const cv::Rect shifted(inner.x + offsets[k][1], inner.y + offsets[k][0], inner.width, inner.height);
+            cv::compare(patch(shifted), center, bit, cv::CMP_GT);   // 255 / 0
+            cv::bitwise_and(bit, cv::Scalar(1 << (7 - k)), bit);
+            cv::bitwise_or(code, bit, code);
         }
     }
-    lbp.convertTo(lbp, CV_32F);
-    features.push_back(lbp);
-    
-    // Spatial pooling: divide into 4x4 grid and compute statistics
-    std::vector<float> descriptor;
+    lbp.convertTo(features[3], CV_32F);
+
+    // Spatial pooling: 4x4 grid, mean and (population) std per cell from
+    // integral images of the map and its square
+    const int cell_w = patch.cols / kGridSize;
+    const int cell_h = patch.rows / kGridSize;
+    const double n = static_cast<double>(cell_w) * cell_h;
+    int o = 0;
+    cv::Mat sum, sqsum;
     for (const auto& feat : features) {
-        int grid_size = 4;
-        int cell_w = feat.cols / grid_size;
-        int cell_h = feat.rows / grid_size;
-        
-        for (int gi = 0; gi < grid_size; gi++) {
-            for (int gj = 0; gj < grid_size; gj++) {
-                cv::Rect cell(gj * cell_w, gi * cell_h, cell_w, cell_h);
-                cv::Mat cell_data = feat(cell);
-                
-                // Compute mean and std for each cell
-                cv::Scalar mean, stddev;
-                cv::meanStdDev(cell_data, mean, stddev);
-                descriptor.push_back(static_cast<float>(mean[0]));
-                descriptor.push_back(static_cast<float>(stddev[0]));
+        cv::integral(feat, sum, sqsum, CV_64F, CV_64F);
+        for (int gi = 0; gi < kGridSize; gi++) {
+            const int y0 = gi * cell_h, y1 = y0 + cell_h;
+            const double* s0 = sum.ptr<double>(y0);
+            const double* s1 = sum.ptr<double>(y1);
+            const double* q0 = sqsum.ptr<double>(y0);
+            const double* q1 = sqsum.ptr<double>(y1);
+            for (int gj = 0; gj < kGridSize; gj++) {
+                const int x0 = gj * cell_w, x1 = x0 + cell_w;
+                const double s = s1[x1] - s0[x1] - s1[x0] + s0[x0];
+                const double q = q1[x1] - q0[x1] - q1[x0] + q0[x0];
+                const double mean = n > 0 ? s / n : 0.0;
+                const double var = n > 0 ? q / n - mean * mean : 0.0;
+                out[o++] = static_cast<float>(mean);
+                out[o++] = static_cast<float>(std::sqrt(std::max(var, 0.0)));
             }
         }
     }
-    
-    // Convert to cv::Mat
-    cv::Mat result(1, static_cast<int>(descriptor.size()), CV_32F, descriptor.data());
-    return result.clone();
 }
 
-void PseudoDNNWrapper::initializePCA(const std::vector<cv::Mat>& samples) {
+void PseudoDNNWrapper::setProjection(const cv::Mat& mean, const cv::Mat& eigenvectors) {
+    mean.convertTo(pca_mean_, CV_32F);
+    eigenvectors.convertTo(pca_basis_, CV_32F);
+    // Fold the mean into a per-component bias: (x - m) P^T = x P^T - m P^T
+    cv::gemm(pca_mean_, pca_basis_, 1.0, cv::Mat(), 0.0, pca_bias_, cv::GEMM_2_T);
+    pca_initialized_ = true;
+}
+
+void PseudoDNNWrapper::fitPCA(const cv::Mat& samples) {
     if (samples.empty()) return;
-    
-    // Stack samples into matrix
-    cv::Mat data(static_cast<int>(samples.size()), samples[0].cols, CV_32F);
-    for (size_t i = 0; i < samples.size(); i++) {
-        samples[i].copyTo(data.row(static_cast<int>(i)));
-    }
-    
+
     // Compute PCA to reduce to 128 dimensions
-    pca_(data, cv::Mat(), cv::PCA::DATA_AS_ROW, 128);
-    pca_initialized_ = true;
+    cv::PCA pca(samples, cv::Mat(), cv::PCA::DATA_AS_ROW, descriptorSize());
+    setProjection(pca.mean, pca.eigenvectors);
+}
+
+bool PseudoDNNWrapper::savePCA(const std::string& path) const {
+    if (!pca_initialized_) return false;
+    cv::FileStorage fs(path, cv::FileStorage::WRITE);
+    if (!fs.isOpened()) return false;
+    fs << "input_size" << input_size_;
+    fs << "support_multiplier" << support_mult_;
+    fs << "rotate_upright" << (rotate_upright_ ? 1 : 0);
+    fs << "mean" << pca_mean_;
+    fs << "eigenvectors" << pca_basis_;
+    fs.release();
+    return true;
+}
+
+bool PseudoDNNWrapper::loadPCA(const std::string& path) {
+    cv::FileStorage fs(path, cv::FileStorage::READ);
+    if (!fs.isOpened()) return false;
+    cv::Mat mean, eigenvectors;
+    fs["mean"] >> mean;
+    fs["eigenvectors"] >> eigenvectors;
+    if (mean.empty() || eigenvectors.empty() ||
+        mean.cols != kFeatureDim || eigenvectors.cols != kFeatureDim) {
+        return false;
+    }
+
+    int input_size = input_size_;
+    float support_mult = support_mult_;
+    if (!fs["input_size"].empty()) fs["input_size"] >> input_size;
+    if (!fs["support_multiplier"].empty()) fs["support_multiplier"] >> support_mult;
+    if (input_size != input_size_ || support_mult != support_mult_) {
+        LOG_WARNING("PseudoDNN PCA " + path + " was trained with input_size=" + std::to_string(input_size) +
+                    ", support_multiplier=" + std::to_string(support_mult) + " (current: " +
+                    std::to_string(input_size_) + ", " + std::to_string(support_mult_) + ")");
+    }
+
+    setProjection(mean, eigenvectors);
+    return true;
+}
+
+cv::Mat PseudoDNNWrapper::computeRawFeatures(const cv::Mat& image,
+                                             const std::vector<cv::KeyPoint>& keypoints) const {
+    const int K = static_cast<int>(keypoints.size());
+
+    // Grayscale once per image rather than per patch
+    cv::Mat gray;
+    if (image.channels() > 1) {
+        cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
+    } else {
+        gray = image;
+    }
+
+    // Extract features for all keypoints, one row each, in parallel
+    cv::Mat raw_features(K, kFeatureDim, CV_32F);
+    cv::parallel_for_(cv::Range(0, K), [&](const cv::Range& r) {
+        for (int i = r.start; i < r.end; i++) {
+            cv::Mat patch = extractPatch(gray, keypoints[i]);
+            computePseudoCNNFeatures(patch, raw_features.ptr<float>(i));
+        }
+    });
+    return raw_features;
 }
 
 cv::Mat PseudoDNNWrapper::extract(const cv::Mat& image, 
                                   const std::vector<cv::KeyPoint>& keypoints,
                                   const DescriptorParams& params) {
-    cv::Mat descriptors(static_cast<int>(keypoints.size()), descriptorSize(), CV_32F);
-    std::vector<cv::Mat> raw_features;
-    
-    // Extract features for all keypoints
-    for (size_t i = 0; i < keypoints.size(); i++) {
-        cv::Mat patch = extractPatch(image, keypoints[i]);
-        if (patch.channels() > 1) {
-            cv::cvtColor(patch, patch, cv::COLOR_BGR2GRAY);
-        }
-        
-        cv::Mat features = computePseudoCNNFeatures(patch);
-        raw_features.push_back(features);
-    }
-    
-    // Initialize PCA if not done yet
-    if (!pca_initialized_ && !raw_features.empty()) {
-        initializePCA(raw_features);
+    const int K = static_cast<int>(keypoints.size());
+    const int D = descriptorSize();
+    cv::Mat descriptors(K, D, CV_32F, cv::Scalar(0));
+    if (K == 0) return descriptors;
+
+    cv::Mat raw_features = computeRawFeatures(image, keypoints);
+
+    // Legacy: no offline projection, fit on the first image seen
+    if (!pca_initialized_) {
+        LOG_WARNING("PseudoDNN: no PCA file configured, fitting on the first image (not reproducible)");
+        fitPCA(raw_features);
     }
-    
-    // Apply PCA and normalize
-    for (size_t i = 0; i < keypoints.size(); i++) {
-        cv::Mat desc_row = descriptors.row(static_cast<int>(i));
-        
-        if (pca_initialized_) {
-            cv::Mat projected = pca_.project(raw_features[i]);
-            projected.copyTo(desc_row);
-        } else {
-            // Fallback: just use raw features (truncated/padded to 128)
-            int copy_size = std::min(raw_features[i].cols, descriptorSize());
-            raw_features[i].colRange(0, copy_size).copyTo(desc_row.colRange(0, copy_size));
+
+    // Project all rows at once: raw [K, F] x basis^T [F, C] -> [K, C]
+    cv::Mat projected;
+    cv::gemm(raw_features, pca_basis_, 1.0, cv::Mat(), 0.0, projected, cv::GEMM_2_T);
+
+    // Subtract the mean term, truncate/pad to 128 and L2 normalize into descriptors
+    const int C = std::min(projected.cols, D);
+    const float* bias = pca_bias_.ptr<float>();
+    cv::parallel_for_(cv::Range(0, K), [&](const cv::Range& r) {
+        for (int i = r.start; i < r.end; i++) {
+            const float* src = projected.ptr<float>(i);
+            float* dst = descriptors.ptr<float>(i);
+            float sq = 0.0f;
+            for (int c = 0; c < C; c++) {
+                dst[c] = src[c] - bias[c];
+                sq += dst[c] * dst[c];
+            }
+            if (sq > 0.0f) {
+                const float inv = 1.0f / std::sqrt(sq);
+                for (int c = 0; c < C; c++) dst[c] *= inv;
+            }
         }
-        
-        // L2 normalize
-        cv::normalize(desc_row, desc_row, 1.0, 0.0, cv::NORM_L2);
-    }
-    
+    });
+
     return descriptors;
 }
 
@@ -19,20 +19,30 @@ namespace wrappers {
  * 2. Local binary patterns (simulates learned features) 
  * 3. Spatial pooling (simulates pooling layers)
  * 4. PCA dimensionality reduction (simulates FC layers)
+ *
+ * The PCA projection is normally trained offline (train_pseudo_dnn_pca) and
+ * loaded from disk so results do not depend on which image is seen first.
+ * Without a PCA file the projection is fitted on the first image (legacy).
  */
 class PseudoDNNWrapper : public IDescriptorExtractor {
 private:
     int input_size_ = 32;
     float support_mult_ = 1.0f;
     bool rotate_upright_ = true;
-    cv::PCA pca_;
+    cv::Mat pca_mean_;        // 1 x kFeatureDim
+    cv::Mat pca_basis_;       // components x kFeatureDim (rows = eigenvectors)
+    cv::Mat pca_bias_;        // 1 x components, pca_mean_ * pca_basis_^T
     bool pca_initialized_ = false;
-    std::vector<cv::Mat> training_samples_;
     
 public:
+    /**
+     * @param pca_path Optional PCA file written by savePCA(); empty fits on the first image
+     * @throws std::runtime_error if pca_path is given but cannot be loaded
+     */
     explicit PseudoDNNWrapper(int input_size = 32,
                              float support_multiplier = 1.0f, 
-                             bool rotate_to_upright = true);
+                             bool rotate_to_upright = true,
+                             const std::string& pca_path = "");
 
     cv::Mat extract(const cv::Mat& image,
                     const std::vector<cv::KeyPoint>& keypoints,
@@ -41,11 +51,26 @@ public:
     std::string name() const override { return "LightweightCNN"; }
     int descriptorSize() const override { return 128; }
     int descriptorType() const override { return DESCRIPTOR_SIFT; }
+
+    /// Pre-PCA features, one kFeatureDim row per keypoint (used for offline PCA training)
+    cv::Mat computeRawFeatures(const cv::Mat& image, const std::vector<cv::KeyPoint>& keypoints) const;
+
+    /// Fit the projection on raw feature rows (at most 128 components)
+    void fitPCA(const cv::Mat& samples);
+
+    bool savePCA(const std::string& path) const;
+    bool loadPCA(const std::string& path);
+    bool hasPCA() const { return pca_initialized_; }
     
 private:
-    cv::Mat extractPatch(const cv::Mat& image, const cv::KeyPoint& kp);
-    cv::Mat computePseudoCNNFeatures(const cv::Mat& patch);
-    void initializePCA(const std::vector<cv::Mat>& samples);
+    static constexpr int kGridSize = 4;                                  // 4x4 pooling cells
+    static constexpr int kFeatureMaps = 4;                               // 3 gradient scales + LBP
+    static constexpr int kFeatureDim = kFeatureMaps * kGridSize * kGridSize * 2;  // mean + std per cell
+
+    cv::Mat extractPatch(const cv::Mat& image, const cv::KeyPoint& kp) const;
+    // Writes kFeatureDim floats for one 8-bit grayscale patch into out (thread-safe)
+    void computePseudoCNNFeatures(const cv::Mat& patch, float* out) const;
+    void setProjection(const cv::Mat& mean, const cv::Mat& eigenvectors);
 };
 
 } // namespace wrappers
@@ -1,4 +1,5 @@
 #include "RGBSIFTWrapper.hpp"
+#include "BatchExtraction.hpp"
 #include <sstream>
 
 namespace thesis_project {
@@ -22,6 +23,19 @@ cv::Mat RGBSIFTWrapper::extract(const cv::Mat& image,
     return descriptors;
 }
 
+std::vector<cv::Mat> RGBSIFTWrapper::extractBatch(const std::vector<cv::Mat>& images,
+                                                  const std::vector<std::vector<cv::KeyPoint>>& keypointSets,
+                                                  const DescriptorParams& /*params*/) {
+    return extractImagesInParallel(images, keypointSets,
+        [](const cv::Mat& image, const std::vector<cv::KeyPoint>& keypoints) {
+            cv::Mat descriptors;
+            std::vector<cv::KeyPoint> mutable_keypoints = keypoints;
+            RGBSIFT rgbsift;
+            rgbsift.compute(image, mutable_keypoints, descriptors);
+            return descriptors;
+        });
+}
+
 std::string RGBSIFTWrapper::getConfiguration() const {
     std::stringstream ss;
     ss << "RGBSIFT Wrapper Configuration:\n";
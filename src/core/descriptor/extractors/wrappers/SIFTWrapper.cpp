@@ -1,4 +1,5 @@
 #include "SIFTWrapper.hpp"
+#include "BatchExtraction.hpp"
 #include <sstream>
 
 namespace thesis_project {
@@ -23,6 +24,18 @@ cv::Mat SIFTWrapper::extract(const cv::Mat& image,
     return descriptors;
 }
 
+std::vector<cv::Mat> SIFTWrapper::extractBatch(const std::vector<cv::Mat>& images,
+                                               const std::vector<std::vector<cv::KeyPoint>>& keypointSets,
+                                               const DescriptorParams& /*params*/) {
+    return extractImagesInParallel(images, keypointSets,
+        [](const cv::Mat& image, const std::vector<cv::KeyPoint>& keypoints) {
+            cv::Mat descriptors;
+            std::vector<cv::KeyPoint> mutable_keypoints = keypoints;
+            cv::SIFT::create()->compute(image, mutable_keypoints, descriptors);
+            return descriptors;
+        });
+}
+
 std::string SIFTWrapper::getConfiguration() const {
     std::stringstream ss;
     ss << "SIFT Wrapper Configuration:\n";
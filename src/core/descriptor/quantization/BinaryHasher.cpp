@@ -0,0 +1,130 @@
+#include "BinaryHasher.hpp"
+#include "src/core/matching/DistanceKernels.hpp"
+#include <stdexcept>
+
+namespace thesis_project::quantization {
+
+namespace {
+
+cv::Mat asFloat(const cv::Mat& m) {
+    if (m.type() == CV_32F) return m;
+    return matching::kernels::toFloat(m);  // also widens fp16 / bfloat16 descriptors
+}
+
+cv::Mat centerRows(const cv::Mat& data, const cv::Mat& mean) {
+    cv::Mat tiled, centered;
+    cv::repeat(mean, data.rows, 1, tiled);
+    cv::subtract(data, tiled, centered);
+    return centered;
+}
+
+// +1 / -1 per entry (zero maps to +1, matching the encoder's bit rule)
+cv::Mat signs(const cv::Mat& v) {
+    cv::Mat b(v.size(), CV_32F);
+    for (int r = 0; r < v.rows; ++r) {
+        const float* p = v.ptr<float>(r);
+        float* out = b.ptr<float>(r);
+        for (int c = 0; c < v.cols; ++c) out[c] = p[c] >= 0.0f ? 1.0f : -1.0f;
+    }
+    return b;
+}
+
+cv::Mat randomGaussian(int rows, int cols, uint64_t seed) {
+    cv::Mat m(rows, cols, CV_32F);
+    cv::RNG rng(seed);
+    rng.fill(m, cv::RNG::NORMAL, 0.0f, 1.0f);
+    return m;
+}
+
+} // namespace
+
+BinaryHasher BinaryHasher::fit(const cv::Mat& samples, const BinaryHashParams& params) {
+    if (samples.empty()) {
+        throw std::invalid_argument("BinaryHasher::fit: empty training descriptors");
+    }
+    if (params.bits <= 0 || params.bits % 8 != 0) {
+        throw std::invalid_argument("BinaryHasher::fit: bits must be a positive multiple of 8");
+    }
+    const cv::Mat data = asFloat(samples);
+
+    BinaryHasher hasher;
+    cv::reduce(data, hasher.mean_, 0, cv::REDUCE_AVG, CV_32F);
+
+    if (params.projection == BinaryProjection::RANDOM) {
+        hasher.projection_ = randomGaussian(data.cols, params.bits, params.seed);
+        return hasher;
+    }
+
+    if (params.bits > data.cols || params.bits > data.rows) {
+        throw std::invalid_argument("BinaryHasher::fit: itq needs bits <= descriptor width and <= sample count (bits=" +
+                                    std::to_string(params.bits) + ", width=" + std::to_string(data.cols) +
+                                    ", samples=" + std::to_string(data.rows) + ")");
+    }
+
+    // ITQ: PCA down to `bits` dims, then learn the rotation R minimising ||B - V R||
+    const cv::Mat centered = centerRows(data, hasher.mean_);
+    cv::PCA pca(centered, cv::Mat(), cv::PCA::DATA_AS_ROW, params.bits);
+    cv::Mat basis;                                   // D x bits
+    cv::transpose(pca.eigenvectors, basis);
+    basis.convertTo(basis, CV_32F);
+    const cv::Mat V = centered * basis;             // N x bits
+
+    cv::Mat R = cv::SVD(randomGaussian(params.bits, params.bits, params.seed)).u;
+    R.convertTo(R, CV_32F);
+    for (int it = 0; it < params.itq_iterations; ++it) {
+        const cv::Mat B = signs(V * R);
+        // Orthogonal Procrustes: V^T B = U S W^T  =>  R = U W^T
+        cv::SVD svd(V.t() * B);
+        R = svd.u * svd.vt;
+    }
+
+    hasher.projection_ = basis * R;
+    return hasher;
+}
+
+cv::Mat BinaryHasher::encode(const cv::Mat& descriptors) const {
+    if (descriptors.empty()) return cv::Mat();
+    if (descriptors.cols != dims()) {
+        throw std::invalid_argument("BinaryHasher::encode: descriptor width does not match fitted width");
+    }
+    const cv::Mat projected = centerRows(asFloat(descriptors), mean_) * projection_;
+
+    cv::Mat codes = cv::Mat::zeros(projected.rows, codeBytes(), CV_8U);
+    cv::parallel_for_(cv::Range(0, projected.rows), [&](const cv::Range& range) {
+        for (int r = range.start; r < range.end; ++r) {
+            const float* p = projected.ptr<float>(r);
+            uchar* out = codes.ptr<uchar>(r);
+            for (int b = 0; b < projected.cols; ++b) {
+                if (p[b] >= 0.0f) out[b >> 3] |= static_cast<uchar>(0x80 >> (b & 7));
+            }
+        }
+    });
+    return codes;
+}
+
+bool BinaryHasher::save(const std::string& path) const {
+    if (!fitted()) return false;
+    cv::FileStorage fs(path, cv::FileStorage::WRITE);
+    if (!fs.isOpened()) return false;
+    fs << "mean" << mean_;
+    fs << "projection" << projection_;
+    fs.release();
+    return true;
+}
+
+bool BinaryHasher::load(const std::string& path) {
+    cv::FileStorage fs(path, cv::FileStorage::READ);
+    if (!fs.isOpened()) return false;
+    cv::Mat mean, projection;
+    fs["mean"] >> mean;
+    fs["projection"] >> projection;
+    if (mean.empty() || projection.empty() || mean.type() != CV_32F || projection.type() != CV_32F ||
+        mean.rows != 1 || mean.cols != projection.rows || projection.cols % 8 != 0) {
+        return false;
+    }
+    mean_ = mean;
+    projection_ = projection;
+    return true;
+}
+
+} // namespace thesis_project::quantization
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "thesis_project/types.hpp"
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <string>
+
+namespace thesis_project::quantization {
+
+/**
+ * @brief Binarization parameters
+ */
+struct BinaryHashParams {
+    int bits = 256;                                         // code length, multiple of 8
+    BinaryProjection projection = BinaryProjection::ITQ;
+    int itq_iterations = 50;                                // rotation updates (ITQ)
+    uint64_t seed = 4321;                                   // random hyperplanes / initial rotation
+};
+
+/**
+ * @brief Sign-of-projection hashing of float descriptors into packed bits
+ *
+ * Descriptors are mean-centered and projected onto `bits` directions, and
+ * each sign becomes one bit. Bits are packed MSB-first into CV_8U rows, the
+ * layout of ORB/BRISK codes, so cv::NORM_HAMMING works on them directly.
+ *
+ * - RANDOM: Gaussian hyperplanes. Hamming distance estimates the angle
+ *   between the centered descriptors. Any code length is allowed.
+ * - ITQ: top `bits` PCA directions, then a rotation learned by alternating
+ *   sign assignment and orthogonal Procrustes (Gong & Lazebnik). This
+ *   reduces the quantization loss of the signs. Requires bits <= width.
+ */
+class BinaryHasher {
+public:
+    BinaryHasher() = default;
+
+    /**
+     * @brief Learn the mean and projection from sample descriptors
+     * @throws std::invalid_argument for empty samples, bits not a positive
+     *         multiple of 8, or ITQ with bits > width or fewer samples than bits
+     */
+    static BinaryHasher fit(const cv::Mat& samples, const BinaryHashParams& params = BinaryHashParams());
+
+    /**
+     * @brief Hash descriptors to N x (bits / 8) packed CV_8U codes
+     * @throws std::invalid_argument if the width differs from the fitted one
+     */
+    cv::Mat encode(const cv::Mat& descriptors) const;
+
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+
+    bool fitted() const { return !projection_.empty(); }
+    int dims() const { return projection_.rows; }
+    int bits() const { return projection_.cols; }
+    int codeBytes() const { return projection_.cols / 8; }
+
+private:
+    cv::Mat mean_;        // 1 x D CV_32F
+    cv::Mat projection_;  // D x bits CV_32F
+};
+
+} // namespace thesis_project::quantization
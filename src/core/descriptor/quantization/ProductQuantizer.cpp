@@ -0,0 +1,153 @@
+#include "ProductQuantizer.hpp"
+#include "src/core/matching/DistanceKernels.hpp"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace thesis_project::quantization {
+
+namespace {
+
+cv::Mat asFloat(const cv::Mat& m) {
+    if (m.type() == CV_32F) return m;
+    return matching::kernels::toFloat(m);  // also widens fp16 / bfloat16 descriptors
+}
+
+float squaredDistance(const float* a, const float* b, int n) {
+    float d = 0.0f;
+    for (int i = 0; i < n; ++i) {
+        const float diff = a[i] - b[i];
+        d += diff * diff;
+    }
+    return d;
+}
+
+} // namespace
+
+ProductQuantizer ProductQuantizer::fit(const cv::Mat& samples, const PQParams& params) {
+    if (samples.empty()) {
+        throw std::invalid_argument("ProductQuantizer::fit: empty training descriptors");
+    }
+    if (params.bits < 1 || params.bits > 8) {
+        throw std::invalid_argument("ProductQuantizer::fit: bits must be in [1,8]");
+    }
+    if (params.m <= 0 || samples.cols % params.m != 0) {
+        throw std::invalid_argument("ProductQuantizer::fit: descriptor width " + std::to_string(samples.cols) +
+                                    " is not divisible by m=" + std::to_string(params.m));
+    }
+    const cv::Mat data = asFloat(samples);
+
+    ProductQuantizer pq;
+    pq.dims_ = data.cols;
+    pq.m_ = params.m;
+    pq.subDims_ = data.cols / params.m;
+    pq.ks_ = std::min(1 << params.bits, data.rows);
+    pq.codebooks_.create(pq.m_ * pq.ks_, pq.subDims_, CV_32F);
+
+    // cv::kmeans seeds k-means++ from the thread RNG; pin it so codebooks are reproducible
+    cv::RNG& rng = cv::theRNG();
+    const uint64_t savedState = rng.state;
+    rng.state = params.seed;
+
+    const cv::TermCriteria criteria(cv::TermCriteria::COUNT + cv::TermCriteria::EPS, params.iterations, 1e-4);
+    for (int s = 0; s < pq.m_; ++s) {
+        const cv::Mat sub = data.colRange(s * pq.subDims_, (s + 1) * pq.subDims_).clone();
+        cv::Mat labels, centers;
+        cv::kmeans(sub, pq.ks_, labels, criteria, 1, cv::KMEANS_PP_CENTERS, centers);
+        centers.copyTo(pq.codebooks_.rowRange(s * pq.ks_, (s + 1) * pq.ks_));
+    }
+
+    rng.state = savedState;
+    return pq;
+}
+
+cv::Mat ProductQuantizer::encode(const cv::Mat& descriptors) const {
+    if (descriptors.empty()) return cv::Mat();
+    if (descriptors.cols != dims_) {
+        throw std::invalid_argument("ProductQuantizer::encode: descriptor width does not match trained width");
+    }
+    const cv::Mat src = asFloat(descriptors);
+    cv::Mat codes(src.rows, m_, CV_8U);
+
+    cv::parallel_for_(cv::Range(0, src.rows), [&](const cv::Range& range) {
+        for (int r = range.start; r < range.end; ++r) {
+            const float* p = src.ptr<float>(r);
+            uchar* out = codes.ptr<uchar>(r);
+            for (int s = 0; s < m_; ++s) {
+                const float* sub = p + s * subDims_;
+                int best = 0;
+                float bestDist = std::numeric_limits<float>::max();
+                for (int k = 0; k < ks_; ++k) {
+                    const float d = squaredDistance(sub, codebooks_.ptr<float>(s * ks_ + k), subDims_);
+                    if (d < bestDist) {
+                        bestDist = d;
+                        best = k;
+                    }
+                }
+                out[s] = static_cast<uchar>(best);
+            }
+        }
+    });
+    return codes;
+}
+
+cv::Mat ProductQuantizer::decode(const cv::Mat& codes) const {
+    if (codes.empty()) return cv::Mat();
+    if (codes.type() != CV_8U || codes.cols != m_) {
+        throw std::invalid_argument("ProductQuantizer::decode: codes must be CV_8U with m columns");
+    }
+    cv::Mat out(codes.rows, dims_, CV_32F);
+    for (int r = 0; r < codes.rows; ++r) {
+        const uchar* code = codes.ptr<uchar>(r);
+        float* dst = out.ptr<float>(r);
+        for (int s = 0; s < m_; ++s) {
+            const float* centroid = codebooks_.ptr<float>(s * ks_ + code[s]);
+            std::copy(centroid, centroid + subDims_, dst + s * subDims_);
+        }
+    }
+    return out;
+}
+
+void ProductQuantizer::distanceTable(const float* query, float* table) const {
+    for (int s = 0; s < m_; ++s) {
+        const float* sub = query + s * subDims_;
+        for (int k = 0; k < ks_; ++k) {
+            table[s * ks_ + k] = squaredDistance(sub, codebooks_.ptr<float>(s * ks_ + k), subDims_);
+        }
+    }
+}
+
+bool ProductQuantizer::save(const std::string& path) const {
+    if (!fitted()) return false;
+    cv::FileStorage fs(path, cv::FileStorage::WRITE);
+    if (!fs.isOpened()) return false;
+    fs << "dims" << dims_;
+    fs << "m" << m_;
+    fs << "centroids" << ks_;
+    fs << "codebooks" << codebooks_;
+    fs.release();
+    return true;
+}
+
+bool ProductQuantizer::load(const std::string& path) {
+    cv::FileStorage fs(path, cv::FileStorage::READ);
+    if (!fs.isOpened()) return false;
+    int dims = 0, m = 0, ks = 0;
+    cv::Mat codebooks;
+    fs["dims"] >> dims;
+    fs["m"] >> m;
+    fs["centroids"] >> ks;
+    fs["codebooks"] >> codebooks;
+    if (dims <= 0 || m <= 0 || dims % m != 0 || ks <= 0 || ks > 256 ||
+        codebooks.type() != CV_32F || codebooks.rows != m * ks || codebooks.cols != dims / m) {
+        return false;
+    }
+    dims_ = dims;
+    m_ = m;
+    subDims_ = dims / m;
+    ks_ = ks;
+    codebooks_ = codebooks;
+    return true;
+}
+
+} // namespace thesis_project::quantization
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <string>
+
+namespace thesis_project::quantization {
+
+/**
+ * @brief Product-quantization parameters
+ */
+struct PQParams {
+    int m = 16;            // subspaces (descriptor width must be divisible by m)
+    int bits = 8;          // bits per sub-code, 2^bits centroids per subspace (max 8)
+    int iterations = 25;   // k-means iterations per subspace
+    uint64_t seed = 1234;  // k-means++ seeding, fixed for reproducible codebooks
+};
+
+/**
+ * @brief Product quantizer for float descriptors
+ *
+ * Splits each D-dim descriptor into m sub-vectors of D/m dims and replaces
+ * every sub-vector by the index of its nearest centroid in a per-subspace
+ * k-means codebook. A descriptor becomes m bytes: 128-D SIFT at m=16 is
+ * 16 bytes instead of 512 (32x), at m=32 it is 16x.
+ *
+ * Search uses asymmetric distances: the query stays float, a table of
+ * squared distances from each query sub-vector to every centroid is built
+ * once (m x 2^bits floats), and the distance to any code is m table
+ * lookups. That equals the exact squared L2 distance from the query to the
+ * code's reconstruction.
+ */
+class ProductQuantizer {
+public:
+    ProductQuantizer() = default;
+
+    /**
+     * @brief Train per-subspace codebooks with k-means
+     *
+     * Uses min(2^bits, rows) centroids per subspace, so small training sets
+     * still produce a usable (smaller) codebook.
+     * @throws std::invalid_argument for empty samples, bits outside [1,8]
+     *         or a width not divisible by m
+     */
+    static ProductQuantizer fit(const cv::Mat& samples, const PQParams& params = PQParams());
+
+    /**
+     * @brief Encode descriptors to N x m CV_8U codes
+     * @throws std::invalid_argument if the width differs from the trained one
+     */
+    cv::Mat encode(const cv::Mat& descriptors) const;
+
+    /**
+     * @brief Reconstruct N x D CV_32F descriptors from codes
+     */
+    cv::Mat decode(const cv::Mat& codes) const;
+
+    /**
+     * @brief Fill the m x ks table of squared distances from one query to every centroid
+     * @param query D floats
+     * @param table m * ks floats, row-major by subspace
+     */
+    void distanceTable(const float* query, float* table) const;
+
+    /**
+     * @brief Asymmetric squared distance of a code given a query's distance table
+     */
+    float adcDistance(const float* table, const uchar* code) const {
+        float d = 0.0f;
+        for (int s = 0; s < m_; ++s) d += table[s * ks_ + code[s]];
+        return d;
+    }
+
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+
+    bool fitted() const { return dims_ > 0; }
+    int dims() const { return dims_; }
+    int subspaces() const { return m_; }
+    int centroids() const { return ks_; }
+    int codeBytes() const { return m_; }
+
+private:
+    int dims_ = 0;
+    int m_ = 0;
+    int subDims_ = 0;
+    int ks_ = 0;
+    cv::Mat codebooks_;  // (m * ks) x subDims CV_32F, subspace s at rows [s*ks, (s+1)*ks)
+};
+
+} // namespace thesis_project::quantization
@@ -0,0 +1,86 @@
+#include "ScalarQuantizer.hpp"
+#include "src/core/matching/DistanceKernels.hpp"
+#include <cmath>
+#include <stdexcept>
+
+namespace thesis_project::quantization {
+
+namespace {
+
+cv::Mat asFloat(const cv::Mat& m) {
+    if (m.type() == CV_32F) return m;
+    return matching::kernels::toFloat(m);  // also widens fp16 / bfloat16 descriptors
+}
+
+bool allIntegralBytes(const cv::Mat& m) {
+    for (int r = 0; r < m.rows; ++r) {
+        const float* p = m.ptr<float>(r);
+        for (int c = 0; c < m.cols; ++c) {
+            if (p[c] < 0.0f || p[c] > 255.0f || p[c] != std::nearbyint(p[c])) return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+ScalarQuantizer ScalarQuantizer::fit(const cv::Mat& reference) {
+    if (reference.empty()) {
+        throw std::invalid_argument("ScalarQuantizer::fit: empty reference descriptors");
+    }
+    const cv::Mat ref = asFloat(reference);
+
+    ScalarQuantizer q;
+    q.dims_ = ref.cols;
+
+    double minVal = 0.0, maxVal = 0.0;
+    cv::minMaxLoc(ref, &minVal, &maxVal);
+
+    if (minVal >= 0.0) {
+        if (!allIntegralBytes(ref)) {
+            q.scale_ = maxVal > 0.0 ? static_cast<float>(255.0 / maxVal) : 1.0f;
+        }
+        return q;
+    }
+
+    cv::reduce(ref, q.offset_, 0, cv::REDUCE_AVG, CV_32F);
+    double maxAbs = 0.0;
+    for (int r = 0; r < ref.rows; ++r) {
+        const float* p = ref.ptr<float>(r);
+        const float* o = q.offset_.ptr<float>(0);
+        for (int c = 0; c < ref.cols; ++c) maxAbs = std::max(maxAbs, static_cast<double>(std::abs(p[c] - o[c])));
+    }
+    q.scale_ = maxAbs > 0.0 ? static_cast<float>(127.0 / maxAbs) : 1.0f;
+    q.zero_point_ = 128.0f;
+    return q;
+}
+
+cv::Mat ScalarQuantizer::quantize(const cv::Mat& descriptors) const {
+    if (descriptors.empty()) return cv::Mat();
+    if (descriptors.cols != dims_) {
+        throw std::invalid_argument("ScalarQuantizer::quantize: descriptor width does not match fitted width");
+    }
+    const cv::Mat src = asFloat(descriptors);
+    cv::Mat codes(src.rows, src.cols, CV_8U);
+    const float* offset = centered() ? offset_.ptr<float>(0) : nullptr;
+
+    cv::parallel_for_(cv::Range(0, src.rows), [&](const cv::Range& range) {
+        for (int r = range.start; r < range.end; ++r) {
+            const float* p = src.ptr<float>(r);
+            uchar* out = codes.ptr<uchar>(r);
+            for (int c = 0; c < src.cols; ++c) {
+                const float v = offset ? p[c] - offset[c] : p[c];
+                out[c] = cv::saturate_cast<uchar>(v * scale_ + zero_point_);
+            }
+        }
+    });
+    return codes;
+}
+
+cv::Mat ScalarQuantizer::dequantize(const cv::Mat& codes) const {
+    cv::Mat out;
+    codes.convertTo(out, CV_32F, 1.0 / scale_, -zero_point_ / scale_);
+    return out;
+}
+
+} // namespace thesis_project::quantization
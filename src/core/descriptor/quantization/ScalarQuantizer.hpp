@@ -0,0 +1,55 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+
+namespace thesis_project::quantization {
+
+/**
+ * @brief Per-run uint8 quantization of float descriptors
+ *
+ * Maps descriptors to CV_8U with one global scale so L1/L2 distances between
+ * codes are the float distances times that scale (rankings preserved up to
+ * rounding):
+ * - non-negative data (SIFT family): code = round(v * scale), scale = 255 / max;
+ *   values that are already integers in [0,255] (raw SIFT, SIFT_INT_DESCR_FCTR)
+ *   keep scale 1 and quantize losslessly
+ * - signed data (DNN): per-dimension mean removed first, then
+ *   code = round(v * scale) + 128, scale = 127 / max|v|. The common offset
+ *   cancels in every distance, so this is int8 after centering stored as uint8.
+ *
+ * The scale is fitted once (on the reference image of a scene) and applied to
+ * all images compared against it.
+ */
+class ScalarQuantizer {
+public:
+    ScalarQuantizer() = default;
+
+    /**
+     * @brief Fit scale (and centering) on reference descriptors
+     * @throws std::invalid_argument for empty input
+     */
+    static ScalarQuantizer fit(const cv::Mat& reference);
+
+    /**
+     * @brief Quantize descriptors to CV_8U codes (same shape)
+     * @throws std::invalid_argument if the width differs from the fitted one
+     */
+    cv::Mat quantize(const cv::Mat& descriptors) const;
+
+    /**
+     * @brief Approximate float reconstruction (centered data is returned centered)
+     */
+    cv::Mat dequantize(const cv::Mat& codes) const;
+
+    bool fitted() const { return dims_ > 0; }
+    bool centered() const { return !offset_.empty(); }
+    float scale() const { return scale_; }
+
+private:
+    int dims_ = 0;
+    float scale_ = 1.0f;
+    float zero_point_ = 0.0f;
+    cv::Mat offset_;  // 1 x D CV_32F, subtracted before scaling when centered
+};
+
+} // namespace thesis_project::quantization
@@ -1,9 +1,23 @@
 #include "BruteForceMatching.hpp"
+#include "DistanceKernels.hpp"
 
 namespace thesis_project::matching {
 
 BruteForceMatching::BruteForceMatching(int normType, bool crossCheck) 
-    : matcher_(normType, crossCheck) {
+    : matcher_(normType, crossCheck), normType_(normType), crossCheck_(crossCheck) {
+}
+
+bool BruteForceMatching::usesBlockedKernel(const cv::Mat& descriptors) const {
+    switch (normType_) {
+        case cv::NORM_L1:
+        case cv::NORM_L2:
+        case cv::NORM_L2SQR:
+            return true;
+        case cv::NORM_HAMMING:
+            return descriptors.depth() == CV_8U;
+        default:
+            return false;
+    }
 }
 
 std::vector<cv::DMatch> BruteForceMatching::matchDescriptors(
@@ -11,7 +25,23 @@ std::vector<cv::DMatch> BruteForceMatching::matchDescriptors(
     const cv::Mat& descriptors2
 ) {
     std::vector<cv::DMatch> matches;
-    matcher_.match(descriptors1, descriptors2, matches);
+    if (descriptors1.empty() || descriptors2.empty()) return matches;
+    if (!usesBlockedKernel(descriptors1)) {
+        matcher_.match(descriptors1, descriptors2, matches);
+        return matches;
+    }
+
+    // One tiled pass yields both directions, so cross-check costs no extra search
+    kernels::BestBothWays best;
+    kernels::bestBothWays(descriptors1, descriptors2, normType_, best);
+
+    matches.reserve(descriptors1.rows);
+    for (int q = 0; q < descriptors1.rows; ++q) {
+        const int t = best.rowIdx[q];
+        if (t < 0) continue;
+        if (crossCheck_ && best.colIdx[t] != q) continue;
+        matches.emplace_back(q, t, best.rowDist[q]);
+    }
     return matches;
 }
 
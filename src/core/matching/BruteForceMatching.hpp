@@ -5,10 +5,13 @@
 namespace thesis_project::matching {
 
 /**
- * @brief Brute-force matching strategy using OpenCV BFMatcher
+ * @brief Brute-force matching strategy
  * 
- * This strategy implements straightforward brute-force matching using
- * OpenCV's BFMatcher with L2 norm and cross-check enabled.
+ * Exact nearest-neighbour matching with L2 norm and cross-check enabled.
+ * L1/L2 (and Hamming on CV_8U) run on the cache-blocked, multi-threaded
+ * kernels::bestBothWays, which finds the forward and backward nearest
+ * neighbours in a single distance pass; other norms fall back to
+ * OpenCV's BFMatcher.
  * 
  * Features:
  * - L2 norm distance metric (suitable for SIFT, SURF descriptors)
@@ -53,8 +56,16 @@ public:
         return false; // Simple brute force doesn't use ratio test
     }
 
+    bool parallelizesQueries() const override {
+        return true;  // the tiled kernel splits query blocks over cv::parallel_for_
+    }
+
 private:
-    cv::BFMatcher matcher_;
+    bool usesBlockedKernel(const cv::Mat& descriptors) const;
+
+    cv::BFMatcher matcher_;  // fallback for norms the blocked kernel does not cover
+    int normType_;
+    bool crossCheck_;
 };
 
 } // namespace thesis_project::matching
\ No newline at end of file
@@ -0,0 +1,552 @@
+#include "DistanceKernels.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace thesis_project::matching::kernels {
+
+namespace {
+
+constexpr int kQueryBlock = 64;    // query rows per parallel task
+constexpr int kTrainBlock = 512;   // train rows per tile (~256 KB of 128-d floats)
+constexpr int kTrainRegTile = 4;   // train rows sharing one load of the query chunk (L1)
+
+inline void pushTopTwo(float d, int t, float& d1, int& i1, float& d2, int& i2) {
+    if (d < d1) {
+        d2 = d1; i2 = i1;
+        d1 = d;  i1 = t;
+    } else if (d < d2) {
+        d2 = d;  i2 = t;
+    }
+}
+
+cv::Mat asContinuousFloat(const cv::Mat& m) {
+    if (m.type() == CV_32F && m.isContinuous()) return m;
+    return toFloat(m);
+}
+
+bool isHalf(const cv::Mat& m) {
+    return m.depth() == CV_16F || m.depth() == CV_16U;
+}
+
+// Rows [r0, r1) of 16-bit descriptors widened into dst (CV_32F)
+void widenRows(const cv::Mat& src, int r0, int r1, cv::Mat& dst) {
+    if (src.depth() == CV_16F) {
+        src.rowRange(r0, r1).convertTo(dst, CV_32F);
+        return;
+    }
+    dst.create(r1 - r0, src.cols, CV_32F);
+    for (int r = r0; r < r1; ++r) {
+        const uint16_t* p = src.ptr<uint16_t>(r);
+        uint32_t* out = dst.ptr<uint32_t>(r - r0);
+        for (int c = 0; c < src.cols; ++c) out[c] = static_cast<uint32_t>(p[c]) << 16;
+    }
+}
+
+void accumulateSquaredNorms(const cv::Mat& m, int r0, float* norms) {
+    for (int r = 0; r < m.rows; ++r) {
+        const float* p = m.ptr<float>(r);
+        float s = 0.f;
+        for (int c = 0; c < m.cols; ++c) s += p[c] * p[c];
+        norms[r0 + r] = s;
+    }
+}
+
+std::vector<float> rowSquaredNorms(const cv::Mat& m) {
+    std::vector<float> norms(m.rows);
+    if (!isHalf(m)) {
+        accumulateSquaredNorms(m, 0, norms.data());
+        return norms;
+    }
+    cv::Mat block;
+    for (int r0 = 0; r0 < m.rows; r0 += kTrainBlock) {
+        const int r1 = std::min(m.rows, r0 + kTrainBlock);
+        widenRows(m, r0, r1, block);
+        accumulateSquaredNorms(block, r0, norms.data());
+    }
+    return norms;
+}
+
+// 1x4 register tile: one query chunk is loaded once and compared against
+// four train rows, with eight partial sums per pair
+void l1RowAgainstFour(const float* q, const float* t0, const float* t1, const float* t2, const float* t3,
+                      int n, float* out) {
+    float a0[8] = {0.f}, a1[8] = {0.f}, a2[8] = {0.f}, a3[8] = {0.f};
+    int j = 0;
+    for (; j + 8 <= n; j += 8) {
+        for (int l = 0; l < 8; ++l) {
+            const float v = q[j + l];
+            a0[l] += std::abs(v - t0[j + l]);
+            a1[l] += std::abs(v - t1[j + l]);
+            a2[l] += std::abs(v - t2[j + l]);
+            a3[l] += std::abs(v - t3[j + l]);
+        }
+    }
+    float s0 = 0.f, s1 = 0.f, s2 = 0.f, s3 = 0.f;
+    for (int l = 0; l < 8; ++l) { s0 += a0[l]; s1 += a1[l]; s2 += a2[l]; s3 += a3[l]; }
+    for (; j < n; ++j) {
+        s0 += std::abs(q[j] - t0[j]);
+        s1 += std::abs(q[j] - t1[j]);
+        s2 += std::abs(q[j] - t2[j]);
+        s3 += std::abs(q[j] - t3[j]);
+    }
+    out[0] = s0; out[1] = s1; out[2] = s2; out[3] = s3;
+}
+
+/**
+ * Computes query-block x train-tile distance tiles. L2 tiles hold squared
+ * distances (||q||^2 + ||t||^2 - 2 q.t, one GEMM per tile); callers take
+ * the square root of the few distances they keep.
+ */
+class TileComputer {
+public:
+    TileComputer(const cv::Mat& query, const cv::Mat& train, int normType) : normType_(normType) {
+        if (query.cols != train.cols || query.depth() != train.depth()) {
+            throw std::invalid_argument("DistanceKernels: query/train width or type mismatch");
+        }
+        if (normType_ == cv::NORM_HAMMING) {
+            if (query.depth() != CV_8U) {
+                throw std::invalid_argument("DistanceKernels: NORM_HAMMING requires CV_8U descriptors");
+            }
+            q_ = query;
+            t_ = train;
+            return;
+        }
+        if (!isSquaredL2() && normType_ != cv::NORM_L1) {
+            throw std::invalid_argument("DistanceKernels: unsupported norm type " + std::to_string(normType_));
+        }
+        if (query.depth() == CV_8U) {  // quantized codes: stay in uint8, integer kernels
+            integer_ = true;
+            q_ = query;
+            t_ = train;
+            return;
+        }
+        if (isHalf(query)) {  // fp16 / bf16: stay 16-bit, tiles widened to fp32 on the fly
+            half_ = true;
+            q_ = query;
+            t_ = train;
+        } else {
+            q_ = asContinuousFloat(query);
+            t_ = asContinuousFloat(train);
+        }
+        if (isSquaredL2()) {
+            qNorms_ = rowSquaredNorms(q_);
+            tNorms_ = rowSquaredNorms(t_);
+        }
+    }
+
+    bool isSquaredL2() const { return normType_ == cv::NORM_L2 || normType_ == cv::NORM_L2SQR; }
+    bool needsSqrt() const { return normType_ == cv::NORM_L2; }
+    int queryRows() const { return q_.rows; }
+    int trainRows() const { return t_.rows; }
+
+    // tile is (q1-q0) x (t1-t0) CV_32F; reused between calls
+    void compute(int q0, int q1, int t0, int t1, cv::Mat& tile) const {
+        if (integer_) {
+            tile.create(q1 - q0, t1 - t0, CV_32F);
+            const bool l1 = normType_ == cv::NORM_L1;
+            for (int r = q0; r < q1; ++r) {
+                const uchar* qp = q_.ptr<uchar>(r);
+                float* dp = tile.ptr<float>(r - q0);
+                for (int c = t0; c < t1; ++c) {
+                    const uchar* tp = t_.ptr<uchar>(c);
+                    dp[c - t0] = static_cast<float>(l1 ? l1DistanceU8(qp, tp, q_.cols) : l2SquaredDistanceU8(qp, tp, q_.cols));
+                }
+            }
+            return;
+        }
+        if (normType_ == cv::NORM_HAMMING) {
+            tile.create(q1 - q0, t1 - t0, CV_32F);
+            for (int r = q0; r < q1; ++r) {
+                float* dp = tile.ptr<float>(r - q0);
+                const uchar* qp = q_.ptr<uchar>(r);
+                for (int c = t0; c < t1; ++c) {
+                    dp[c - t0] = static_cast<float>(cv::hal::normHamming(qp, t_.ptr<uchar>(c), q_.cols));
+                }
+            }
+            return;
+        }
+        if (half_) {
+            // Only the current block and tile are widened, so memory traffic stays 16-bit
+            thread_local cv::Mat qScratch, tScratch;
+            widenRows(q_, q0, q1, qScratch);
+            widenRows(t_, t0, t1, tScratch);
+            floatTile(qScratch, tScratch, q0, t0, tile);
+            return;
+        }
+        floatTile(q_.rowRange(q0, q1), t_.rowRange(t0, t1), q0, t0, tile);
+    }
+
+    // Bound on how far one pair's tile distance can move between tiles of different
+    // shape (GEMM / register-tile summation order); zero for the integer kernels
+    float roundoff(int r, int c, float d) const {
+        if (integer_ || normType_ == cv::NORM_HAMMING) return 0.f;
+        if (isSquaredL2()) return 1e-4f * (qNorms_[r] + tNorms_[c]);
+        return 1e-4f * d;
+    }
+
+    // Exact distance in the reported metric (used to refine GEMM-derived L2 values)
+    float exact(int r, int c) const {
+        if (integer_) {
+            const uchar* qp = q_.ptr<uchar>(r);
+            const uchar* tp = t_.ptr<uchar>(c);
+            if (normType_ == cv::NORM_L1) return static_cast<float>(l1DistanceU8(qp, tp, q_.cols));
+            const float d2 = static_cast<float>(l2SquaredDistanceU8(qp, tp, q_.cols));
+            return needsSqrt() ? std::sqrt(d2) : d2;
+        }
+        if (normType_ == cv::NORM_HAMMING) {
+            return static_cast<float>(cv::hal::normHamming(q_.ptr<uchar>(r), t_.ptr<uchar>(c), q_.cols));
+        }
+        const float* qp = nullptr;
+        const float* tp = nullptr;
+        if (half_) {
+            thread_local cv::Mat qRow, tRow;
+            widenRows(q_, r, r + 1, qRow);
+            widenRows(t_, c, c + 1, tRow);
+            qp = qRow.ptr<float>(0);
+            tp = tRow.ptr<float>(0);
+        } else {
+            qp = q_.ptr<float>(r);
+            tp = t_.ptr<float>(c);
+        }
+        if (normType_ == cv::NORM_L1) return l1Distance(qp, tp, q_.cols);
+        const float d2 = l2SquaredDistance(qp, tp, q_.cols);
+        return needsSqrt() ? std::sqrt(d2) : d2;
+    }
+
+private:
+    // Float tile: qb holds query rows q0.., tb train rows t0..
+    void floatTile(const cv::Mat& qb, const cv::Mat& tb, int q0, int t0, cv::Mat& tile) const {
+        if (isSquaredL2()) {
+            cv::gemm(qb, tb, 1.0, cv::Mat(), 0.0, tile, cv::GEMM_2_T);
+            for (int r = 0; r < qb.rows; ++r) {
+                float* dp = tile.ptr<float>(r);
+                for (int c = 0; c < tb.rows; ++c) {
+                    dp[c] = std::max(0.f, qNorms_[q0 + r] + tNorms_[t0 + c] - 2.f * dp[c]);
+                }
+            }
+            return;
+        }
+
+        tile.create(qb.rows, tb.rows, CV_32F);
+        const int n = qb.cols;
+        for (int r = 0; r < qb.rows; ++r) {
+            float* dp = tile.ptr<float>(r);
+            const float* qp = qb.ptr<float>(r);
+            int c = 0;
+            for (; c + kTrainRegTile <= tb.rows; c += kTrainRegTile) {
+                l1RowAgainstFour(qp, tb.ptr<float>(c), tb.ptr<float>(c + 1), tb.ptr<float>(c + 2),
+                                 tb.ptr<float>(c + 3), n, dp + c);
+            }
+            for (; c < tb.rows; ++c) dp[c] = l1Distance(qp, tb.ptr<float>(c), n);
+        }
+    }
+
+    int normType_;
+    bool integer_ = false;
+    bool half_ = false;
+    cv::Mat q_;
+    cv::Mat t_;
+    std::vector<float> qNorms_;
+    std::vector<float> tNorms_;
+};
+
+} // namespace
+
+void TopTwo::reset(int rows) {
+    idx1.assign(rows, -1);
+    idx2.assign(rows, -1);
+    dist1.assign(rows, std::numeric_limits<float>::max());
+    dist2.assign(rows, std::numeric_limits<float>::max());
+}
+
+void topTwoNeighbours(const cv::Mat& query, const cv::Mat& train, int normType, TopTwo& out) {
+    out.reset(query.rows);
+    if (query.empty() || train.empty()) return;
+
+    const TileComputer tiles(query, train, normType);
+    const int numBlocks = (tiles.queryRows() + kQueryBlock - 1) / kQueryBlock;
+
+    cv::parallel_for_(cv::Range(0, numBlocks), [&](const cv::Range& range) {
+        cv::Mat tile;  // per-task tile buffer, reused across tiles
+        for (int b = range.start; b < range.end; ++b) {
+            const int q0 = b * kQueryBlock;
+            const int q1 = std::min(tiles.queryRows(), q0 + kQueryBlock);
+            for (int t0 = 0; t0 < tiles.trainRows(); t0 += kTrainBlock) {
+                const int t1 = std::min(tiles.trainRows(), t0 + kTrainBlock);
+                tiles.compute(q0, q1, t0, t1, tile);
+                for (int r = q0; r < q1; ++r) {
+                    const float* dp = tile.ptr<float>(r - q0);
+                    for (int c = t0; c < t1; ++c) {
+                        pushTopTwo(dp[c - t0], c, out.dist1[r], out.idx1[r], out.dist2[r], out.idx2[r]);
+                    }
+                }
+            }
+        }
+    });
+
+    if (tiles.needsSqrt()) {
+        for (int r = 0; r < tiles.queryRows(); ++r) {
+            out.dist1[r] = std::sqrt(out.dist1[r]);
+            if (out.idx2[r] >= 0) out.dist2[r] = std::sqrt(out.dist2[r]);
+        }
+    }
+}
+
+void TopK::reset(int rows, int kNearest) {
+    k = kNearest;
+    idx.assign(static_cast<size_t>(rows) * k, -1);
+    dist.assign(static_cast<size_t>(rows) * k, std::numeric_limits<float>::max());
+    targetDist.assign(rows, std::numeric_limits<float>::max());
+    better.assign(rows, 0);
+    ties.assign(rows, 0);
+}
+
+void topKNeighbours(const cv::Mat& query, const cv::Mat& train, int normType, int k,
+                    const std::vector<int>& targets, TopK& out) {
+    if (k <= 0) {
+        throw std::invalid_argument("DistanceKernels: top-K search requires k > 0");
+    }
+    if (!targets.empty() && static_cast<int>(targets.size()) != query.rows) {
+        throw std::invalid_argument("DistanceKernels: top-K targets need one entry per query row");
+    }
+    out.reset(query.rows, k);
+    if (query.empty() || train.empty()) return;
+
+    const TileComputer tiles(query, train, normType);
+    const int numBlocks = (tiles.queryRows() + kQueryBlock - 1) / kQueryBlock;
+    const int trainRows = tiles.trainRows();
+
+    cv::parallel_for_(cv::Range(0, numBlocks), [&](const cv::Range& range) {
+        cv::Mat tile;
+        std::vector<std::pair<float, int>> heaps;  // per block: one k-entry max-heap per query row
+        std::vector<int> sizes;
+        std::vector<float> provisional, band;    // per row: 1x1 target distance and its roundoff
+        std::vector<std::vector<float>> near;    // per row: candidates within band of it
+        for (int b = range.start; b < range.end; ++b) {
+            const int q0 = b * kQueryBlock;
+            const int q1 = std::min(tiles.queryRows(), q0 + kQueryBlock);
+            heaps.assign(static_cast<size_t>(q1 - q0) * k, {});
+            sizes.assign(q1 - q0, 0);
+
+            // A 1x1 tile gives each target's distance up front, so every tile can count
+            // competitors as it streams past. Its summation order differs from the scan
+            // tiles, though, so candidates within roundoff of it are held back and settled
+            // against the target's own scan-tile distance (same arithmetic) at the end.
+            if (!targets.empty()) {
+                provisional.assign(q1 - q0, 0.f);
+                band.assign(q1 - q0, 0.f);
+                near.resize(q1 - q0);
+                for (int r = q0; r < q1; ++r) {
+                    near[r - q0].clear();
+                    const int t = targets[r];
+                    if (t < 0 || t >= trainRows) continue;
+                    tiles.compute(r, r + 1, t, t + 1, tile);
+                    provisional[r - q0] = tile.ptr<float>(0)[0];
+                    band[r - q0] = tiles.roundoff(r, t, provisional[r - q0]);
+                }
+            }
+
+            for (int t0 = 0; t0 < trainRows; t0 += kTrainBlock) {
+                const int t1 = std::min(trainRows, t0 + kTrainBlock);
+                tiles.compute(q0, q1, t0, t1, tile);
+                for (int r = q0; r < q1; ++r) {
+                    const float* dp = tile.ptr<float>(r - q0);
+                    std::pair<float, int>* heap = heaps.data() + static_cast<size_t>(r - q0) * k;
+                    int& size = sizes[r - q0];
+                    for (int c = t0; c < t1; ++c) {
+                        const float d = dp[c - t0];
+                        if (size < k) {
+                            heap[size++] = {d, c};
+                            std::push_heap(heap, heap + size);
+                        } else if (d < heap[0].first) {  // strict: earlier (lower) index wins ties
+                            std::pop_heap(heap, heap + k);
+                            heap[k - 1] = {d, c};
+                            std::push_heap(heap, heap + k);
+                        }
+                    }
+
+                    const int target = targets.empty() ? -1 : targets[r];
+                    if (target < 0 || target >= trainRows) continue;
+                    if (target >= t0 && target < t1) out.targetDist[r] = dp[target - t0];
+                    const float lo = provisional[r - q0] - band[r - q0];
+                    const float hi = provisional[r - q0] + band[r - q0];
+                    std::vector<float>& held = near[r - q0];
+                    int better = 0;
+                    for (int c = t0; c < t1; ++c) {
+                        const float d = dp[c - t0];
+                        if (d < lo) {
+                            ++better;
+                        } else if (d <= hi && c != target) {
+                            held.push_back(d);
+                        }
+                    }
+                    out.better[r] += better;
+                }
+            }
+
+            if (!targets.empty()) {
+                for (int r = q0; r < q1; ++r) {
+                    const float td = out.targetDist[r];
+                    for (const float d : near[r - q0]) {
+                        out.better[r] += d < td;
+                        out.ties[r] += d == td;
+                    }
+                }
+            }
+
+            for (int r = q0; r < q1; ++r) {
+                std::pair<float, int>* heap = heaps.data() + static_cast<size_t>(r - q0) * k;
+                const int size = sizes[r - q0];
+                std::sort_heap(heap, heap + size);
+                for (int j = 0; j < size; ++j) {
+                    out.dist[static_cast<size_t>(r) * k + j] = heap[j].first;
+                    out.idx[static_cast<size_t>(r) * k + j] = heap[j].second;
+                }
+            }
+        }
+    });
+
+    if (tiles.needsSqrt()) {
+        for (size_t j = 0; j < out.idx.size(); ++j) {
+            if (out.idx[j] >= 0) out.dist[j] = std::sqrt(out.dist[j]);
+        }
+        for (int r = 0; r < tiles.queryRows(); ++r) {
+            if (!targets.empty() && targets[r] >= 0 && targets[r] < trainRows) out.targetDist[r] = std::sqrt(out.targetDist[r]);
+        }
+    }
+}
+
+void BestBothWays::reset(int queryRows, int trainRows) {
+    rowIdx.assign(queryRows, -1);
+    rowDist.assign(queryRows, std::numeric_limits<float>::max());
+    colIdx.assign(trainRows, -1);
+    colDist.assign(trainRows, std::numeric_limits<float>::max());
+}
+
+void bestBothWays(const cv::Mat& query, const cv::Mat& train, int normType, BestBothWays& out) {
+    out.reset(query.rows, train.rows);
+    if (query.empty() || train.empty()) return;
+
+    const TileComputer tiles(query, train, normType);
+    const int numBlocks = (tiles.queryRows() + kQueryBlock - 1) / kQueryBlock;
+    const int trainRows = tiles.trainRows();
+
+    // Query blocks are split into one contiguous stripe per worker; each stripe
+    // keeps its own column minima (O(stripes * T), not O(Q * T / 64)), so
+    // workers never write to shared state
+    const int numStripes = std::max(1, std::min(numBlocks, cv::getNumThreads()));
+    std::vector<float> stripeColDist(static_cast<size_t>(numStripes) * trainRows, std::numeric_limits<float>::max());
+    std::vector<int> stripeColIdx(static_cast<size_t>(numStripes) * trainRows, -1);
+
+    cv::parallel_for_(cv::Range(0, numStripes), [&](const cv::Range& range) {
+        cv::Mat tile;
+        for (int s = range.start; s < range.end; ++s) {
+            float* colDist = stripeColDist.data() + static_cast<size_t>(s) * trainRows;
+            int* colIdx = stripeColIdx.data() + static_cast<size_t>(s) * trainRows;
+            const int b1 = static_cast<int>(static_cast<int64_t>(numBlocks) * (s + 1) / numStripes);
+            for (int b = static_cast<int>(static_cast<int64_t>(numBlocks) * s / numStripes); b < b1; ++b) {
+                const int q0 = b * kQueryBlock;
+                const int q1 = std::min(tiles.queryRows(), q0 + kQueryBlock);
+                for (int t0 = 0; t0 < trainRows; t0 += kTrainBlock) {
+                    const int t1 = std::min(trainRows, t0 + kTrainBlock);
+                    tiles.compute(q0, q1, t0, t1, tile);
+                    for (int r = q0; r < q1; ++r) {
+                        const float* dp = tile.ptr<float>(r - q0);
+                        float best = out.rowDist[r];
+                        int bestIdx = out.rowIdx[r];
+                        for (int c = t0; c < t1; ++c) {
+                            const float d = dp[c - t0];
+                            if (d < best) { best = d; bestIdx = c; }
+                            if (d < colDist[c]) { colDist[c] = d; colIdx[c] = r; }
+                        }
+                        out.rowDist[r] = best;
+                        out.rowIdx[r] = bestIdx;
+                    }
+                }
+            }
+        }
+    });
+
+    // Stripes cover increasing query ranges; strict '<' keeps the lowest
+    // query index on ties, matching a sequential scan
+    for (int s = 0; s < numStripes; ++s) {
+        const float* colDist = stripeColDist.data() + static_cast<size_t>(s) * trainRows;
+        const int* colIdx = stripeColIdx.data() + static_cast<size_t>(s) * trainRows;
+        for (int c = 0; c < trainRows; ++c) {
+            if (colDist[c] < out.colDist[c]) {
+                out.colDist[c] = colDist[c];
+                out.colIdx[c] = colIdx[c];
+            }
+        }
+    }
+
+    // Report exact distances for the row winners (GEMM-derived L2 loses precision)
+    for (int r = 0; r < tiles.queryRows(); ++r) {
+        if (out.rowIdx[r] >= 0) out.rowDist[r] = tiles.exact(r, out.rowIdx[r]);
+    }
+    if (tiles.needsSqrt()) {
+        for (float& d : out.colDist) d = std::sqrt(d);
+    }
+}
+
+cv::Mat distanceMatrix(const cv::Mat& query, const cv::Mat& train, int normType) {
+    if (query.empty() || train.empty()) return cv::Mat(query.rows, train.rows, CV_32F);
+
+    const TileComputer tiles(query, train, normType);
+    cv::Mat out(tiles.queryRows(), tiles.trainRows(), CV_32F);
+    const int numBlocks = (tiles.queryRows() + kQueryBlock - 1) / kQueryBlock;
+
+    cv::parallel_for_(cv::Range(0, numBlocks), [&](const cv::Range& range) {
+        cv::Mat tile;
+        for (int b = range.start; b < range.end; ++b) {
+            const int q0 = b * kQueryBlock;
+            const int q1 = std::min(tiles.queryRows(), q0 + kQueryBlock);
+            for (int t0 = 0; t0 < tiles.trainRows(); t0 += kTrainBlock) {
+                const int t1 = std::min(tiles.trainRows(), t0 + kTrainBlock);
+                tiles.compute(q0, q1, t0, t1, tile);
+                tile.copyTo(out(cv::Range(q0, q1), cv::Range(t0, t1)));
+            }
+        }
+    });
+
+    if (tiles.needsSqrt()) cv::sqrt(out, out);
+    return out;
+}
+
+cv::Mat toBFloat16(const cv::Mat& descriptors) {
+    const cv::Mat src = descriptors.depth() == CV_32F ? descriptors : toFloat(descriptors);
+    cv::Mat out(src.rows, src.cols, CV_16U);
+    for (int r = 0; r < src.rows; ++r) {
+        const float* p = src.ptr<float>(r);
+        uint16_t* dst = out.ptr<uint16_t>(r);
+        for (int c = 0; c < src.cols; ++c) {
+            uint32_t bits;
+            std::memcpy(&bits, &p[c], sizeof(bits));
+            if ((bits & 0x7f800000u) == 0x7f800000u && (bits & 0x007fffffu)) {
+                dst[c] = static_cast<uint16_t>((bits >> 16) | 0x0040u);  // keep NaN quiet
+                continue;
+            }
+            bits += 0x7fffu + ((bits >> 16) & 1u);  // round to nearest even
+            dst[c] = static_cast<uint16_t>(bits >> 16);
+        }
+    }
+    return out;
+}
+
+cv::Mat toFloat(const cv::Mat& descriptors) {
+    if (descriptors.empty()) return cv::Mat();
+    cv::Mat f;
+    if (descriptors.depth() == CV_16U) {
+        widenRows(descriptors, 0, descriptors.rows, f);
+    } else {
+        descriptors.convertTo(f, CV_32F);
+    }
+    return f;
+}
+
+} // namespace thesis_project::matching::kernels
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <cmath>
+#include <vector>
+
+namespace thesis_project::matching::kernels {
+
+/**
+ * @brief Two nearest train rows per query row
+ *
+ * Flat per-query arrays (no vector-of-vectors). Distances are reported in
+ * the metric of the norm (L2 is not squared); idx2 is -1 when the train set
+ * has a single row.
+ */
+struct TopTwo {
+    std::vector<int> idx1;
+    std::vector<int> idx2;
+    std::vector<float> dist1;
+    std::vector<float> dist2;
+
+    void reset(int rows);
+};
+
+/**
+ * @brief Exact top-2 search with a cache-blocked, multi-threaded kernel
+ *
+ * Query rows are split into blocks processed with cv::parallel_for_; each
+ * block walks the train set in tiles so both stay cache resident. L2 tiles
+ * use ||q||^2 + ||t||^2 - 2 q.t with one GEMM per tile, L1 a register-tiled
+ * loop (one query chunk against four train rows) and NORM_HAMMING a popcount
+ * over packed CV_8U rows. CV_8U rows with L1/L2 are treated as quantized
+ * codes and use exact integer kernels; CV_16F / CV_16U (bfloat16) rows are
+ * widened per tile and use the fp32 kernels.
+ *
+ * @param query Query descriptors (one per row)
+ * @param train Train descriptors, same width as query
+ * @param normType cv::NORM_L2, cv::NORM_L1 or cv::NORM_HAMMING
+ * @param out Filled with one entry per query row
+ * @throws std::invalid_argument on width/type mismatch
+ */
+void topTwoNeighbours(const cv::Mat& query, const cv::Mat& train, int normType, TopTwo& out);
+
+/**
+ * @brief Nearest neighbour in both directions from a single pass
+ *
+ * rowIdx/rowDist: nearest train row per query row. colIdx/colDist: nearest
+ * query row per train row. Ties resolve to the lowest index, as in a
+ * sequential scan (and cv::BFMatcher).
+ */
+struct BestBothWays {
+    std::vector<int> rowIdx;
+    std::vector<float> rowDist;
+    std::vector<int> colIdx;
+    std::vector<float> colDist;
+
+    void reset(int queryRows, int trainRows);
+};
+
+/**
+ * @brief Exact row-wise and column-wise minima of the query x train distance matrix
+ *
+ * Same tiling as topTwoNeighbours; each distance tile updates the per-row
+ * best and a per-worker column best, merged once at the end. Cross-checked
+ * brute-force matching therefore needs one distance pass instead of two.
+ *
+ * @throws std::invalid_argument on width/type mismatch or unsupported norm
+ */
+void bestBothWays(const cv::Mat& query, const cv::Mat& train, int normType, BestBothWays& out);
+
+/**
+ * @brief K nearest train rows per query, plus competitor counts for one target row
+ *
+ * idx/dist are rows x k (row-major), ascending by (distance, index) and
+ * padded with -1 / FLT_MAX when the train set has fewer than k rows.
+ * For query r with target row targets[r] >= 0, better[r] counts the train
+ * rows strictly closer than the target and ties[r] counts the other rows
+ * at exactly the target distance. That is enough for an exact R=1 rank
+ * without keeping the distance row.
+ */
+struct TopK {
+    int k = 0;
+    std::vector<int> idx;
+    std::vector<float> dist;
+    std::vector<float> targetDist;
+    std::vector<int> better;
+    std::vector<int> ties;
+
+    void reset(int rows, int kNearest);
+};
+
+/**
+ * @brief Bounded top-K search inside the tiled kernel (no query x train matrix)
+ *
+ * Each query row keeps a k-entry max-heap that is updated tile by tile, so
+ * memory is O(rows * k) plus one tile per worker. The target distance is
+ * read from the same scan tile as its competitors, so the target never
+ * counts against itself and counts agree with a full distanceMatrix row
+ * up to GEMM summation order.
+ *
+ * @param targets Empty, or one train row per query (-1 = no target)
+ * @throws std::invalid_argument when k <= 0, targets has the wrong size, or on width/type mismatch
+ */
+void topKNeighbours(const cv::Mat& query, const cv::Mat& train, int normType, int k,
+                    const std::vector<int>& targets, TopK& out);
+
+/**
+ * @brief Pack descriptors as bfloat16 bit patterns (CV_16U, round to nearest even)
+ *
+ * The kernels treat CV_16U descriptor rows as bfloat16 and CV_16F rows as
+ * IEEE half. Both are widened to fp32 one tile at a time and accumulated in
+ * fp32, so resident descriptors and streamed tiles are half the size of fp32.
+ */
+cv::Mat toBFloat16(const cv::Mat& descriptors);
+
+/**
+ * @brief Widen descriptors to CV_32F (bfloat16 for CV_16U, cv::convertTo otherwise)
+ *
+ * CV_16F goes through cv::convertTo, which OpenCV dispatches at runtime to
+ * F16C / AVX-512 conversions when the CPU has them. bfloat16 widening is a
+ * 16-bit shift that needs no special instructions.
+ */
+cv::Mat toFloat(const cv::Mat& descriptors);
+
+/**
+ * @brief Full query x train distance matrix (CV_32F) from the same tiled kernels
+ *
+ * Pass cv::NORM_L2SQR for squared L2 (ranking-only consumers such as AP).
+ */
+cv::Mat distanceMatrix(const cv::Mat& query, const cv::Mat& train, int normType);
+
+// Eight independent partial sums so the loops vectorise without -ffast-math
+
+inline float l1Distance(const float* a, const float* b, int n) {
+    float acc[8] = {0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f};
+    int j = 0;
+    for (; j + 8 <= n; j += 8) {
+        for (int l = 0; l < 8; ++l) acc[l] += std::abs(a[j + l] - b[j + l]);
+    }
+    float s = 0.f;
+    for (float v : acc) s += v;
+    for (; j < n; ++j) s += std::abs(a[j] - b[j]);
+    return s;
+}
+
+// uint8 codes (quantized descriptors): exact integer accumulation, 16 lanes
+
+inline int l1DistanceU8(const uchar* a, const uchar* b, int n) {
+    int acc[16] = {0};
+    int j = 0;
+    for (; j + 16 <= n; j += 16) {
+        for (int l = 0; l < 16; ++l) acc[l] += std::abs(static_cast<int>(a[j + l]) - static_cast<int>(b[j + l]));
+    }
+    int s = 0;
+    for (int v : acc) s += v;
+    for (; j < n; ++j) s += std::abs(static_cast<int>(a[j]) - static_cast<int>(b[j]));
+    return s;
+}
+
+inline int l2SquaredDistanceU8(const uchar* a, const uchar* b, int n) {
+    int acc[16] = {0};
+    int j = 0;
+    for (; j + 16 <= n; j += 16) {
+        for (int l = 0; l < 16; ++l) {
+            const int d = static_cast<int>(a[j + l]) - static_cast<int>(b[j + l]);
+            acc[l] += d * d;
+        }
+    }
+    int s = 0;
+    for (int v : acc) s += v;
+    for (; j < n; ++j) {
+        const int d = static_cast<int>(a[j]) - static_cast<int>(b[j]);
+        s += d * d;
+    }
+    return s;
+}
+
+inline float l2SquaredDistance(const float* a, const float* b, int n) {
+    float acc[8] = {0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f};
+    int j = 0;
+    for (; j + 8 <= n; j += 8) {
+        for (int l = 0; l < 8; ++l) {
+            const float d = a[j + l] - b[j + l];
+            acc[l] += d * d;
+        }
+    }
+    float s = 0.f;
+    for (float v : acc) s += v;
+    for (; j < n; ++j) s += (a[j] - b[j]) * (a[j] - b[j]);
+    return s;
+}
+
+} // namespace thesis_project::matching::kernels
@@ -0,0 +1,161 @@
+#include "FlannMatching.hpp"
+#include "DistanceKernels.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace thesis_project::matching {
+
+namespace {
+// LSH defaults for binary descriptors (OpenCV / FLANN recommended range)
+constexpr int kLshTables = 12;
+constexpr int kLshKeySize = 20;
+constexpr int kLshMultiProbe = 2;
+}
+
+FlannMatching::FlannMatching(int normType, bool crossCheck, int trees, int checks)
+    : normType_(normType), crossCheck_(crossCheck),
+      trees_(std::max(1, trees)), checks_(std::max(1, checks)) {
+}
+
+FlannMatching::CachedIndex& FlannMatching::indexFor(const cv::Mat& train) {
+    for (auto it = cache_.begin(); it != cache_.end(); ++it) {
+        if (it->data == train.data && it->rows == train.rows &&
+            it->cols == train.cols && it->type == train.type()) {
+            if (it != cache_.begin()) {
+                CachedIndex hit = *it;
+                cache_.erase(it);
+                cache_.push_front(hit);
+            }
+            return cache_.front();
+        }
+    }
+
+    CachedIndex entry;
+    entry.data = train.data;
+    entry.rows = train.rows;
+    entry.cols = train.cols;
+    entry.type = train.type();
+    entry.source = train;
+
+    if (isBinary()) {
+        entry.features = train.isContinuous() ? train : train.clone();
+        entry.index = cv::makePtr<cv::flann::Index>(
+            entry.features,
+            cv::flann::LshIndexParams(kLshTables, kLshKeySize, kLshMultiProbe),
+            cvflann::FLANN_DIST_HAMMING);
+    } else {
+        if (train.type() == CV_32F && train.isContinuous()) {
+            entry.features = train;
+        } else {
+            entry.features = kernels::toFloat(train);
+        }
+        const auto dist = (normType_ == cv::NORM_L1) ? cvflann::FLANN_DIST_L1 : cvflann::FLANN_DIST_L2;
+        entry.index = cv::makePtr<cv::flann::Index>(
+            entry.features, cv::flann::KDTreeIndexParams(trees_), dist);
+    }
+
+    cache_.push_front(entry);
+    if (cache_.size() > kCacheSize) cache_.pop_back();
+    return cache_.front();
+}
+
+const FlannMatching::CachedIndex* FlannMatching::findIndex(const cv::Mat& train) const {
+    for (const auto& entry : cache_) {
+        if (entry.data == train.data && entry.rows == train.rows &&
+            entry.cols == train.cols && entry.type == train.type()) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void FlannMatching::search(const CachedIndex& entry, const cv::Mat& query,
+                           std::vector<int>& idx, std::vector<float>& dist) const {
+    cv::Mat q;
+    if (isBinary()) {
+        q = query;
+    } else if (query.type() == CV_32F) {
+        q = query;
+    } else {
+        q = kernels::toFloat(query);
+    }
+
+    cv::Mat indices, dists;
+    entry.index->knnSearch(q, indices, dists, 1, cv::flann::SearchParams(checks_));
+
+    idx.assign(query.rows, -1);
+    dist.assign(query.rows, 0.0f);
+    cv::Mat distsF;
+    dists.convertTo(distsF, CV_32F);   // Hamming returns integer distances
+    for (int r = 0; r < query.rows; ++r) {
+        idx[r] = indices.at<int>(r, 0);
+        float d = distsF.at<float>(r, 0);
+        // FLANN's L2 is squared; report the same metric as BFMatcher(NORM_L2)
+        if (!isBinary() && normType_ != cv::NORM_L1) d = std::sqrt(std::max(d, 0.0f));
+        dist[r] = d;
+    }
+}
+
+bool FlannMatching::prepareShared(const cv::Mat& train) {
+    indexFor(train);
+    return true;
+}
+
+void FlannMatching::nearestShared(const cv::Mat& query, const cv::Mat& train,
+                                  std::vector<int>& idx, std::vector<float>& dist) const {
+    const CachedIndex* entry = findIndex(train);
+    if (!entry) {
+        throw std::logic_error("FlannMatching: nearestShared() needs prepareShared() for this train matrix");
+    }
+    search(*entry, query, idx, dist);
+}
+
+std::vector<cv::DMatch> FlannMatching::matchDescriptors(
+    const cv::Mat& descriptors1,
+    const cv::Mat& descriptors2
+) {
+    std::vector<cv::DMatch> matches;
+    if (descriptors1.empty() || descriptors2.empty()) return matches;
+
+    std::vector<int> fwdIdx;
+    std::vector<float> fwdDist;
+    search(indexFor(descriptors2), descriptors1, fwdIdx, fwdDist);
+
+    std::vector<int> bwdIdx;
+    std::vector<float> bwdDist;
+    if (crossCheck_) search(indexFor(descriptors1), descriptors2, bwdIdx, bwdDist);
+
+    matches.reserve(descriptors1.rows);
+    for (int q = 0; q < descriptors1.rows; ++q) {
+        const int t = fwdIdx[q];
+        if (t < 0 || t >= descriptors2.rows) continue;
+        if (crossCheck_ && bwdIdx[t] != q) continue;
+        matches.emplace_back(q, t, fwdDist[q]);
+    }
+    return matches;
+}
+
+double FlannMatching::calculatePrecision(
+    const std::vector<cv::DMatch>& matches,
+    const std::vector<cv::KeyPoint>& keypoints2,
+    const std::vector<cv::Point2f>& projectedPoints,
+    double matchThreshold
+) {
+    int truePositives = 0;
+    for (const auto& match : matches) {
+        if (cv::norm(projectedPoints[match.queryIdx] - keypoints2[match.trainIdx].pt) <= matchThreshold) {
+            truePositives++;
+        }
+    }
+    return matches.empty() ? 0 : static_cast<double>(truePositives) / matches.size();
+}
+
+double FlannMatching::adjustMatchThreshold(
+    double baseThreshold,
+    double scaleFactor
+) {
+    return baseThreshold * scaleFactor;
+}
+
+} // namespace thesis_project::matching
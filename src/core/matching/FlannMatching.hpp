@@ -0,0 +1,114 @@
+#pragma once
+
+#include "MatchingStrategy.hpp"
+#include <opencv2/flann.hpp>
+#include <deque>
+
+namespace thesis_project::matching {
+
+/**
+ * @brief Approximate nearest-neighbour matching with cv::flann
+ *
+ * L1/L2 use a randomized k-d forest (trees / checks configurable, CV_8U
+ * codes are converted to float), NORM_HAMMING uses LSH over binary CV_8U rows. Query rows come
+ * from descriptors1, the index is built over descriptors2 (same convention as
+ * BFMatcher::match).
+ *
+ * Indexes are cached per train matrix (keyed by its data pointer and shape,
+ * holding a reference so the buffer cannot be recycled), so a reference image
+ * matched against several targets only builds its index once. With cross-check
+ * the reverse direction uses an index over descriptors1, which is the one that
+ * gets reused across image pairs of a scene.
+ *
+ * k-d and LSH searches only read the index, so once prepareShared() has built
+ * it, nearestShared() lets several threads query the same index.
+ */
+class FlannMatching : public MatchingStrategy {
+public:
+    /**
+     * @param normType cv::NORM_L2 / cv::NORM_L1 for float, cv::NORM_HAMMING for binary
+     * @param crossCheck Keep only mutual nearest neighbours
+     * @param trees Number of randomized k-d trees
+     * @param checks Leaves visited per query (higher = more accurate, slower)
+     */
+    explicit FlannMatching(
+        int normType = cv::NORM_L2,
+        bool crossCheck = true,
+        int trees = 4,
+        int checks = 32
+    );
+
+    std::vector<cv::DMatch> matchDescriptors(
+        const cv::Mat& descriptors1,
+        const cv::Mat& descriptors2
+    ) override;
+
+    double calculatePrecision(
+        const std::vector<cv::DMatch>& matches,
+        const std::vector<cv::KeyPoint>& keypoints2,
+        const std::vector<cv::Point2f>& projectedPoints,
+        double matchThreshold
+    ) override;
+
+    double adjustMatchThreshold(
+        double baseThreshold,
+        double scaleFactor
+    ) override;
+
+    std::string getName() const override {
+        return "FLANN";
+    }
+
+    bool supportsRatioTest() const override {
+        return false;
+    }
+
+    bool isApproximate() const override {
+        return true;
+    }
+
+    bool prepareShared(const cv::Mat& train) override;
+
+    void nearestShared(
+        const cv::Mat& query,
+        const cv::Mat& train,
+        std::vector<int>& idx,
+        std::vector<float>& dist
+    ) const override;
+
+    int trees() const { return trees_; }
+    int checks() const { return checks_; }
+
+private:
+    struct CachedIndex {
+        const uchar* data = nullptr;
+        int rows = 0;
+        int cols = 0;
+        int type = -1;
+        cv::Mat source;                      // keeps the caller's buffer alive so its address is not reused
+        cv::Mat features;                    // the indexed rows, in the index's format (may be a converted copy)
+        cv::Ptr<cv::flann::Index> index;
+    };
+
+    // Returns the index over train, building it if this matrix was not seen recently
+    CachedIndex& indexFor(const cv::Mat& train);
+
+    // Cached index over train without touching the LRU order; nullptr when not cached
+    const CachedIndex* findIndex(const cv::Mat& train) const;
+
+    // Nearest neighbour in entry's train matrix for every query row; -1 when the index returns none
+    void search(const CachedIndex& entry, const cv::Mat& query,
+                std::vector<int>& idx, std::vector<float>& dist) const;
+
+    // Hamming selects LSH; uint8 codes with L1/L2 (quantized descriptors) use the k-d forest
+    bool isBinary() const { return normType_ == cv::NORM_HAMMING || normType_ == cv::NORM_HAMMING2; }
+
+    int normType_;
+    bool crossCheck_;
+    int trees_;
+    int checks_;
+    std::deque<CachedIndex> cache_;          // most recent first; query + reference index fit
+    static constexpr size_t kCacheSize = 2;
+};
+
+} // namespace thesis_project::matching
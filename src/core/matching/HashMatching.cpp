@@ -0,0 +1,184 @@
+#include "HashMatching.hpp"
+#include "DistanceKernels.hpp"
+#include "thesis_project/logging.hpp"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+
+namespace thesis_project::matching {
+
+namespace {
+
+cv::Mat gatherRows(const cv::Mat& m, const std::vector<int>& rows) {
+    cv::Mat out(static_cast<int>(rows.size()), m.cols, m.type());
+    for (size_t i = 0; i < rows.size(); ++i) m.row(rows[i]).copyTo(out.row(static_cast<int>(i)));
+    return out;
+}
+
+} // namespace
+
+HashMatching::HashMatching(int normType, bool crossCheck, const quantization::BinaryHashParams& params,
+                           int rerank, std::string modelPath)
+    : normType_(normType), crossCheck_(crossCheck), params_(params),
+      rerank_(std::max(0, rerank)), modelPath_(std::move(modelPath)) {
+}
+
+void HashMatching::ensureHasher(const cv::Mat& train) {
+    if (hasher_.fitted()) return;
+
+    if (!modelPath_.empty() && std::filesystem::exists(modelPath_)) {
+        if (!hasher_.load(modelPath_)) {
+            throw std::runtime_error("Failed to load binary hasher: " + modelPath_);
+        }
+        LOG_INFO("Loaded binary hasher " + modelPath_ + " (" + std::to_string(hasher_.bits()) + " bits)");
+    } else {
+        hasher_ = quantization::BinaryHasher::fit(train, params_);
+        LOG_INFO("Fitted " + toString(params_.projection) + " binary hasher on " + std::to_string(train.rows) +
+                 " descriptors (" + std::to_string(hasher_.bits()) + " bits)");
+        if (!modelPath_.empty() && !hasher_.save(modelPath_)) {
+            LOG_WARNING("Failed to persist binary hasher to " + modelPath_);
+        }
+    }
+    if (hasher_.dims() != train.cols) {
+        throw std::invalid_argument("Binary hasher width " + std::to_string(hasher_.dims()) +
+                                    " does not match descriptor width " + std::to_string(train.cols));
+    }
+}
+
+cv::Mat HashMatching::codesFor(const cv::Mat& descriptors) {
+    for (auto it = cache_.begin(); it != cache_.end(); ++it) {
+        if (it->data == descriptors.data && it->rows == descriptors.rows &&
+            it->cols == descriptors.cols && it->type == descriptors.type()) {
+            if (it != cache_.begin()) {
+                CachedCodes hit = *it;
+                cache_.erase(it);
+                cache_.push_front(hit);
+            }
+            return cache_.front().codes;
+        }
+    }
+
+    CachedCodes entry;
+    entry.data = descriptors.data;
+    entry.rows = descriptors.rows;
+    entry.cols = descriptors.cols;
+    entry.type = descriptors.type();
+    entry.source = descriptors;
+    entry.codes = hasher_.encode(descriptors);
+
+    cache_.push_front(entry);
+    if (cache_.size() > kCacheSize) cache_.pop_back();
+    return cache_.front().codes;
+}
+
+void HashMatching::rerankNearest(const kernels::TopK& candidates, const cv::Mat& query, const cv::Mat& train,
+                                 std::vector<int>& idx, std::vector<float>& dist) const {
+    cv::Mat q, t;
+    q = query.type() == CV_32F ? query : kernels::toFloat(query);
+    t = train.type() == CV_32F ? train : kernels::toFloat(train);
+
+    idx.assign(q.rows, -1);
+    dist.assign(q.rows, 0.0f);
+    const int k = candidates.k;
+
+    cv::parallel_for_(cv::Range(0, q.rows), [&](const cv::Range& range) {
+        for (int r = range.start; r < range.end; ++r) {
+            const int* cands = candidates.idx.data() + static_cast<size_t>(r) * k;
+            int best = -1;
+            float bestDist = std::numeric_limits<float>::max();
+            for (int c = 0; c < k && cands[c] >= 0; ++c) {
+                const int cand = cands[c];
+                const float d = normType_ == cv::NORM_L1
+                    ? kernels::l1Distance(q.ptr<float>(r), t.ptr<float>(cand), q.cols)
+                    : kernels::l2SquaredDistance(q.ptr<float>(r), t.ptr<float>(cand), q.cols);
+                if (d < bestDist || (d == bestDist && cand < best)) {
+                    bestDist = d;
+                    best = cand;
+                }
+            }
+            idx[r] = best;
+            dist[r] = normType_ == cv::NORM_L1 ? bestDist : std::sqrt(std::max(bestDist, 0.0f));
+        }
+    });
+}
+
+std::vector<cv::DMatch> HashMatching::matchDescriptors(
+    const cv::Mat& descriptors1,
+    const cv::Mat& descriptors2
+) {
+    std::vector<cv::DMatch> matches;
+    if (descriptors1.empty() || descriptors2.empty()) return matches;
+    ensureHasher(descriptors2);
+
+    const cv::Mat codes1 = codesFor(descriptors1);
+    const cv::Mat codes2 = codesFor(descriptors2);
+
+    std::vector<int> fwdIdx, bwdIdx;
+    std::vector<float> fwdDist, bwdDist;
+    if (rerank_ == 0) {
+        // Hamming only: one popcount pass gives both directions
+        kernels::BestBothWays best;
+        kernels::bestBothWays(codes1, codes2, cv::NORM_HAMMING, best);
+        fwdIdx = std::move(best.rowIdx);
+        fwdDist = std::move(best.rowDist);
+        bwdIdx = std::move(best.colIdx);
+    } else {
+        // Hamming candidates come from a per-query top-k heap over the popcount
+        // tiles, so no query x train matrix is materialized
+        kernels::TopK candidates;
+        kernels::topKNeighbours(codes1, codes2, cv::NORM_HAMMING, std::min(rerank_, codes2.rows), {}, candidates);
+        rerankNearest(candidates, descriptors1, descriptors2, fwdIdx, fwdDist);
+        if (crossCheck_) {
+            // Only train rows that won a forward match can pass the check, so the
+            // backward search runs for those rows alone
+            std::vector<int> winners;
+            for (const int t : fwdIdx) {
+                if (t >= 0) winners.push_back(t);
+            }
+            std::sort(winners.begin(), winners.end());
+            winners.erase(std::unique(winners.begin(), winners.end()), winners.end());
+
+            std::vector<int> winnerIdx;
+            kernels::topKNeighbours(gatherRows(codes2, winners), codes1, cv::NORM_HAMMING,
+                                    std::min(rerank_, codes1.rows), {}, candidates);
+            rerankNearest(candidates, gatherRows(descriptors2, winners), descriptors1, winnerIdx, bwdDist);
+            bwdIdx.assign(descriptors2.rows, -1);
+            for (size_t i = 0; i < winners.size(); ++i) bwdIdx[winners[i]] = winnerIdx[i];
+        }
+    }
+
+    matches.reserve(descriptors1.rows);
+    for (int q = 0; q < descriptors1.rows; ++q) {
+        const int t = fwdIdx[q];
+        if (t < 0) continue;
+        if (crossCheck_ && bwdIdx[t] != q) continue;
+        matches.emplace_back(q, t, fwdDist[q]);
+    }
+    return matches;
+}
+
+double HashMatching::calculatePrecision(
+    const std::vector<cv::DMatch>& matches,
+    const std::vector<cv::KeyPoint>& keypoints2,
+    const std::vector<cv::Point2f>& projectedPoints,
+    double matchThreshold
+) {
+    int truePositives = 0;
+    for (const auto& match : matches) {
+        if (cv::norm(projectedPoints[match.queryIdx] - keypoints2[match.trainIdx].pt) <= matchThreshold) {
+            truePositives++;
+        }
+    }
+    return matches.empty() ? 0 : static_cast<double>(truePositives) / matches.size();
+}
+
+double HashMatching::adjustMatchThreshold(
+    double baseThreshold,
+    double scaleFactor
+) {
+    return baseThreshold * scaleFactor;
+}
+
+} // namespace thesis_project::matching
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "MatchingStrategy.hpp"
+#include "DistanceKernels.hpp"
+#include "src/core/descriptor/quantization/BinaryHasher.hpp"
+#include <deque>
+#include <string>
+
+namespace thesis_project::matching {
+
+/**
+ * @brief Hamming pre-filter over hashed float descriptors with optional exact re-rank
+ *
+ * Float descriptors are binarized with a BinaryHasher (256 bits = 32 bytes
+ * instead of 512 for 128-D float) and compared with the popcount kernel.
+ * With rerank > 0, the `rerank` nearest codes of each query are re-scored
+ * with the exact float distance and the best is kept. This recovers most of
+ * the accuracy lost to hashing while the full scan stays on bits. Candidates
+ * come from a bounded top-k search over the popcount tiles, and the backward
+ * cross-check only searches from train rows that won a forward match.
+ *
+ * The hasher is loaded from the configured file when it exists. Otherwise
+ * it is fitted on the first train set seen and written to the file if one
+ * is configured. Codes are cached per descriptor matrix like FlannMatching
+ * indexes.
+ */
+class HashMatching : public MatchingStrategy {
+public:
+    /**
+     * @param normType Re-rank metric: cv::NORM_L2 or cv::NORM_L1
+     * @param crossCheck Keep only mutual nearest neighbours
+     * @param params Code length / projection
+     * @param rerank Hamming candidates re-scored per query (0 = Hamming only)
+     * @param modelPath Hasher file to load, or to write after fitting (empty = in memory)
+     */
+    explicit HashMatching(
+        int normType = cv::NORM_L2,
+        bool crossCheck = true,
+        const quantization::BinaryHashParams& params = quantization::BinaryHashParams(),
+        int rerank = 8,
+        std::string modelPath = ""
+    );
+
+    std::vector<cv::DMatch> matchDescriptors(
+        const cv::Mat& descriptors1,
+        const cv::Mat& descriptors2
+    ) override;
+
+    double calculatePrecision(
+        const std::vector<cv::DMatch>& matches,
+        const std::vector<cv::KeyPoint>& keypoints2,
+        const std::vector<cv::Point2f>& projectedPoints,
+        double matchThreshold
+    ) override;
+
+    double adjustMatchThreshold(
+        double baseThreshold,
+        double scaleFactor
+    ) override;
+
+    std::string getName() const override {
+        return "Hash";
+    }
+
+    bool supportsRatioTest() const override {
+        return false;
+    }
+
+    bool isApproximate() const override {
+        return true;
+    }
+
+    bool parallelizesQueries() const override {
+        return true;
+    }
+
+    const quantization::BinaryHasher& hasher() const { return hasher_; }
+
+private:
+    struct CachedCodes {
+        const uchar* data = nullptr;
+        int rows = 0;
+        int cols = 0;
+        int type = -1;
+        cv::Mat source;   // keeps the hashed buffer alive
+        cv::Mat codes;
+    };
+
+    void ensureHasher(const cv::Mat& train);
+    cv::Mat codesFor(const cv::Mat& descriptors);
+    void rerankNearest(const kernels::TopK& candidates, const cv::Mat& query, const cv::Mat& train,
+                       std::vector<int>& idx, std::vector<float>& dist) const;
+
+    int normType_;
+    bool crossCheck_;
+    quantization::BinaryHashParams params_;
+    int rerank_;
+    std::string modelPath_;
+    quantization::BinaryHasher hasher_;
+    std::deque<CachedCodes> cache_;          // most recent first
+    static constexpr size_t kCacheSize = 2;
+};
+
+} // namespace thesis_project::matching
@@ -0,0 +1,344 @@
+#include "HnswIndex.hpp"
+#include "DistanceKernels.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <queue>
+#include <stdexcept>
+
+namespace thesis_project::matching {
+
+namespace {
+
+constexpr uint32_t kFileMagic = 0x57534E48;  // "HNSW"
+constexpr uint32_t kFileVersion = 1;
+// build() floors u at 1e-12, so no level exceeds -log(1e-12) / log(2) ~ 40
+constexpr int32_t kMaxFileLevel = 64;
+
+// Generation-stamped visited marks, one per worker thread, so a search
+// does not clear an O(N) array
+struct VisitedList {
+    std::vector<uint32_t> marks;
+    uint32_t generation = 0;
+
+    void reset(size_t n) {
+        if (marks.size() < n) {
+            marks.assign(n, 0);
+            generation = 0;
+        }
+        if (++generation == 0) {
+            std::fill(marks.begin(), marks.end(), 0);
+            generation = 1;
+        }
+    }
+    bool visit(int node) {
+        if (marks[node] == generation) return false;
+        marks[node] = generation;
+        return true;
+    }
+};
+
+thread_local VisitedList tls_visited;
+
+template <typename T>
+void writePod(std::ofstream& out, const T& v) { out.write(reinterpret_cast<const char*>(&v), sizeof(T)); }
+
+template <typename T>
+bool readPod(std::ifstream& in, T& v) { return static_cast<bool>(in.read(reinterpret_cast<char*>(&v), sizeof(T))); }
+
+} // namespace
+
+HnswIndex::HnswIndex(int normType, const HnswParams& params)
+    : normType_(normType), params_(params) {
+    if (normType_ != cv::NORM_L2 && normType_ != cv::NORM_L1 && normType_ != cv::NORM_HAMMING) {
+        throw std::invalid_argument("HnswIndex: unsupported norm type " + std::to_string(normType_));
+    }
+    params_.M = std::max(2, params_.M);
+    params_.ef_construction = std::max(params_.M, params_.ef_construction);
+    params_.ef_search = std::max(1, params_.ef_search);
+}
+
+cv::Mat HnswIndex::prepare(const cv::Mat& m) const {
+    if (normType_ == cv::NORM_HAMMING) {
+        if (m.depth() != CV_8U) throw std::invalid_argument("HnswIndex: NORM_HAMMING requires CV_8U descriptors");
+        return m.isContinuous() ? m : m.clone();
+    }
+    if (m.type() == CV_32F && m.isContinuous()) return m;
+    return kernels::toFloat(m);
+}
+
+float HnswIndex::distance(const uchar* a, const uchar* b) const {
+    const int n = data_.cols;
+    switch (normType_) {
+        case cv::NORM_HAMMING:
+            return static_cast<float>(cv::hal::normHamming(a, b, n));
+        case cv::NORM_L1:
+            return kernels::l1Distance(reinterpret_cast<const float*>(a), reinterpret_cast<const float*>(b), n);
+        default:  // L2 searched as squared distance, same ordering
+            return kernels::l2SquaredDistance(reinterpret_cast<const float*>(a), reinterpret_cast<const float*>(b), n);
+    }
+}
+
+std::vector<int> HnswIndex::neighbours(int node, int level) const {
+    std::lock_guard<std::mutex> lock(link_locks_[node]);
+    return links_[node][level];
+}
+
+int HnswIndex::greedyClosest(const uchar* q, int entry, int fromLevel, int toLevel) const {
+    int current = entry;
+    float currentDist = distanceTo(q, current);
+    for (int level = fromLevel; level > toLevel; --level) {
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (int n : neighbours(current, level)) {
+                const float d = distanceTo(q, n);
+                if (d < currentDist) {
+                    currentDist = d;
+                    current = n;
+                    changed = true;
+                }
+            }
+        }
+    }
+    return current;
+}
+
+std::vector<HnswIndex::Candidate> HnswIndex::searchLayer(const uchar* q, int entry, int ef, int level) const {
+    VisitedList& visited = tls_visited;
+    visited.reset(static_cast<size_t>(data_.rows));
+
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> candidates;  // closest first
+    std::priority_queue<Candidate> results;                                                    // farthest first
+
+    const float d0 = distanceTo(q, entry);
+    visited.visit(entry);
+    candidates.emplace(d0, entry);
+    results.emplace(d0, entry);
+
+    while (!candidates.empty()) {
+        const Candidate c = candidates.top();
+        if (c.first > results.top().first && static_cast<int>(results.size()) >= ef) break;
+        candidates.pop();
+
+        for (int n : neighbours(c.second, level)) {
+            if (!visited.visit(n)) continue;
+            const float d = distanceTo(q, n);
+            if (static_cast<int>(results.size()) < ef || d < results.top().first) {
+                candidates.emplace(d, n);
+                results.emplace(d, n);
+                if (static_cast<int>(results.size()) > ef) results.pop();
+            }
+        }
+    }
+
+    std::vector<Candidate> sorted(results.size());
+    for (size_t i = sorted.size(); i-- > 0;) {
+        sorted[i] = results.top();
+        results.pop();
+    }
+    return sorted;
+}
+
+// Diversity heuristic: keep a candidate only if it is closer to the base
+// node than to every neighbour already kept
+std::vector<int> HnswIndex::selectNeighbours(const std::vector<Candidate>& sorted, int m) const {
+    std::vector<int> selected;
+    selected.reserve(m);
+    for (const auto& c : sorted) {
+        if (static_cast<int>(selected.size()) >= m) break;
+        bool keep = true;
+        for (int s : selected) {
+            if (distance(data_.ptr(c.second), data_.ptr(s)) < c.first) {
+                keep = false;
+                break;
+            }
+        }
+        if (keep) selected.push_back(c.second);
+    }
+    return selected;
+}
+
+void HnswIndex::insert(int node) {
+    const int level = levels_[node];
+    const uchar* q = data_.ptr(node);
+
+    // Nodes that raise the top level keep the entry lock for the whole insertion
+    std::unique_lock<std::mutex> entryLock(entry_lock_);
+    const int entry = entry_point_;
+    const int topLevel = max_level_;
+    if (level <= topLevel) entryLock.unlock();
+
+    int current = greedyClosest(q, entry, topLevel, level);
+    for (int l = std::min(level, topLevel); l >= 0; --l) {
+        const auto candidates = searchLayer(q, current, params_.ef_construction, l);
+        const auto chosen = selectNeighbours(candidates, params_.M);
+        {
+            std::lock_guard<std::mutex> lock(link_locks_[node]);
+            links_[node][l] = chosen;
+        }
+        for (int n : chosen) {
+            std::lock_guard<std::mutex> lock(link_locks_[n]);
+            auto& list = links_[n][l];
+            list.push_back(node);
+            if (static_cast<int>(list.size()) > maxLinks(l)) {
+                std::vector<Candidate> pruned;
+                pruned.reserve(list.size());
+                for (int x : list) pruned.emplace_back(distance(data_.ptr(n), data_.ptr(x)), x);
+                std::sort(pruned.begin(), pruned.end());
+                list = selectNeighbours(pruned, maxLinks(l));
+            }
+        }
+        current = candidates.front().second;
+    }
+
+    if (level > topLevel) {
+        entry_point_ = node;
+        max_level_ = level;
+    }
+}
+
+void HnswIndex::resetLocks() {
+    link_locks_.reset(new std::mutex[std::max(1, data_.rows)]);
+}
+
+void HnswIndex::build(const cv::Mat& data) {
+    data_ = prepare(data);
+    const int n = data_.rows;
+    levels_.assign(n, 0);
+    links_.assign(n, {});
+    entry_point_ = -1;
+    max_level_ = -1;
+    resetLocks();
+    if (n == 0) return;
+
+    const double levelMult = 1.0 / std::log(static_cast<double>(params_.M));
+    cv::RNG rng(static_cast<uint64_t>(params_.seed));
+    for (int i = 0; i < n; ++i) {
+        const double u = std::max(rng.uniform(0.0, 1.0), 1e-12);
+        levels_[i] = static_cast<int>(-std::log(u) * levelMult);
+        links_[i].resize(levels_[i] + 1);
+    }
+
+    entry_point_ = 0;
+    max_level_ = levels_[0];
+    cv::parallel_for_(cv::Range(1, n), [&](const cv::Range& range) {
+        for (int i = range.start; i < range.end; ++i) insert(i);
+    });
+}
+
+void HnswIndex::search(const cv::Mat& queries, std::vector<int>& idx, std::vector<float>& dist) const {
+    idx.assign(queries.rows, -1);
+    dist.assign(queries.rows, 0.0f);
+    if (data_.empty() || queries.empty()) return;
+    if (queries.cols != data_.cols) throw std::invalid_argument("HnswIndex: query width does not match index");
+
+    const cv::Mat q = prepare(queries);
+    cv::parallel_for_(cv::Range(0, q.rows), [&](const cv::Range& range) {
+        for (int r = range.start; r < range.end; ++r) {
+            const uchar* qp = q.ptr(r);
+            const int entry = greedyClosest(qp, entry_point_, max_level_, 0);
+            const auto best = searchLayer(qp, entry, params_.ef_search, 0);
+            idx[r] = best.front().second;
+            dist[r] = normType_ == cv::NORM_L2 ? std::sqrt(best.front().first) : best.front().first;
+        }
+    });
+}
+
+void HnswIndex::search(const cv::Mat& queries, int k, std::vector<int>& idx, std::vector<float>& dist) const {
+    if (k <= 0) throw std::invalid_argument("HnswIndex: k must be > 0");
+    idx.assign(static_cast<size_t>(queries.rows) * k, -1);
+    dist.assign(static_cast<size_t>(queries.rows) * k, 0.0f);
+    if (data_.empty() || queries.empty()) return;
+    if (queries.cols != data_.cols) throw std::invalid_argument("HnswIndex: query width does not match index");
+
+    const cv::Mat q = prepare(queries);
+    const int ef = std::max(params_.ef_search, k);
+    cv::parallel_for_(cv::Range(0, q.rows), [&](const cv::Range& range) {
+        for (int r = range.start; r < range.end; ++r) {
+            const uchar* qp = q.ptr(r);
+            const int entry = greedyClosest(qp, entry_point_, max_level_, 0);
+            const auto best = searchLayer(qp, entry, ef, 0);
+            const int found = std::min(k, static_cast<int>(best.size()));
+            for (int j = 0; j < found; ++j) {
+                idx[static_cast<size_t>(r) * k + j] = best[j].second;
+                dist[static_cast<size_t>(r) * k + j] = normType_ == cv::NORM_L2 ? std::sqrt(best[j].first) : best[j].first;
+            }
+        }
+    });
+}
+
+bool HnswIndex::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return false;
+    writePod(out, kFileMagic);
+    writePod(out, kFileVersion);
+    writePod(out, static_cast<int32_t>(normType_));
+    writePod(out, static_cast<int32_t>(params_.M));
+    writePod(out, static_cast<int32_t>(data_.rows));
+    writePod(out, static_cast<int32_t>(data_.cols));
+    writePod(out, static_cast<int32_t>(entry_point_));
+    writePod(out, static_cast<int32_t>(max_level_));
+    for (int i = 0; i < data_.rows; ++i) {
+        writePod(out, static_cast<int32_t>(levels_[i]));
+        for (const auto& list : links_[i]) {
+            writePod(out, static_cast<int32_t>(list.size()));
+            out.write(reinterpret_cast<const char*>(list.data()), static_cast<std::streamsize>(list.size() * sizeof(int)));
+        }
+    }
+    return static_cast<bool>(out);
+}
+
+bool HnswIndex::load(const std::string& path, const cv::Mat& data) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+
+    uint32_t magic = 0, version = 0;
+    int32_t normType = 0, M = 0, rows = 0, cols = 0, entry = -1, maxLevel = -1;
+    if (!readPod(in, magic) || magic != kFileMagic || !readPod(in, version) || version != kFileVersion) return false;
+    if (!readPod(in, normType) || !readPod(in, M) || !readPod(in, rows) || !readPod(in, cols) ||
+        !readPod(in, entry) || !readPod(in, maxLevel)) return false;
+    if (normType != normType_ || M != params_.M || rows != data.rows || cols != data.cols) return false;
+
+    // A stale, truncated or colliding file must not reach search(): the entry point,
+    // every level and every neighbour id is checked against this matrix
+    if (rows == 0 ? (entry != -1 || maxLevel != -1)
+                  : (entry < 0 || entry >= rows || maxLevel < 0 || maxLevel > kMaxFileLevel)) return false;
+
+    std::vector<int> levels(rows);
+    std::vector<std::vector<std::vector<int>>> links(rows);
+    for (int i = 0; i < rows; ++i) {
+        int32_t level = 0;
+        if (!readPod(in, level) || level < 0 || level > maxLevel) return false;
+        levels[i] = level;
+        links[i].resize(level + 1);
+        for (auto& list : links[i]) {
+            int32_t count = 0;
+            if (!readPod(in, count) || count < 0 || count > 2 * M) return false;
+            list.resize(count);
+            if (!in.read(reinterpret_cast<char*>(list.data()), static_cast<std::streamsize>(count * sizeof(int)))) return false;
+        }
+    }
+
+    if (in.peek() != std::char_traits<char>::eof()) return false;  // trailing bytes: not this graph
+    if (rows > 0 && levels[entry] != maxLevel) return false;
+    for (int i = 0; i < rows; ++i) {
+        for (int level = 0; level <= levels[i]; ++level) {
+            for (const int nb : links[i][level]) {
+                // search() follows links[nb][level], so the neighbour must exist on this level
+                if (nb < 0 || nb >= rows || levels[nb] < level) return false;
+            }
+        }
+    }
+
+    data_ = prepare(data);
+    levels_ = std::move(levels);
+    links_ = std::move(links);
+    entry_point_ = entry;
+    max_level_ = maxLevel;
+    resetLocks();
+    return true;
+}
+
+} // namespace thesis_project::matching
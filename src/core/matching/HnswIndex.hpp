@@ -0,0 +1,98 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace thesis_project::matching {
+
+/**
+ * @brief HNSW build / query parameters
+ */
+struct HnswParams {
+    int M = 16;                 // links per node (2*M on the base layer)
+    int ef_construction = 200;  // candidate list size while building
+    int ef_search = 64;         // candidate list size while querying
+    int seed = 100;             // level assignment RNG
+};
+
+/**
+ * @brief In-process HNSW (hierarchical navigable small world) graph index
+ *
+ * Approximate nearest-neighbour index over the rows of a descriptor matrix
+ * (Malkov & Yashunin). Float descriptors use L2 or L1, CV_8U descriptors
+ * with NORM_HAMMING use popcount distance.
+ *
+ * Construction inserts nodes concurrently with cv::parallel_for_ (per-node
+ * link locks, entry point guarded separately); queries are read-only and run
+ * in parallel as well. The graph can be saved and reloaded for the same
+ * descriptor matrix so repeated runs skip construction.
+ */
+class HnswIndex {
+public:
+    explicit HnswIndex(int normType = cv::NORM_L2, const HnswParams& params = HnswParams());
+
+    /**
+     * @brief Build the graph over all rows of data (replaces any previous graph)
+     */
+    void build(const cv::Mat& data);
+
+    /**
+     * @brief Nearest indexed row for every query row
+     * @param idx -1 for an empty index
+     * @param dist Distance in the index metric (L2 is not squared)
+     */
+    void search(const cv::Mat& queries, std::vector<int>& idx, std::vector<float>& dist) const;
+
+    /**
+     * @brief k nearest indexed rows per query row (candidate list max(ef_search, k))
+     * @param idx rows x k, nearest first, -1 padded when fewer than k are found
+     * @param dist rows x k in the index metric (L2 is not squared)
+     */
+    void search(const cv::Mat& queries, int k, std::vector<int>& idx, std::vector<float>& dist) const;
+
+    /**
+     * @brief Write the graph (not the descriptors) to a binary file
+     */
+    bool save(const std::string& path) const;
+
+    /**
+     * @brief Load a graph written by save() for the same descriptor matrix
+     * @return false if the file is missing, does not match data / norm / M, or holds
+     *         an entry point, level or neighbour id that is out of range for data
+     */
+    bool load(const std::string& path, const cv::Mat& data);
+
+    int size() const { return data_.rows; }
+    bool empty() const { return data_.empty(); }
+    const HnswParams& params() const { return params_; }
+
+private:
+    using Candidate = std::pair<float, int>;  // (distance, node)
+
+    cv::Mat prepare(const cv::Mat& m) const;
+    float distance(const uchar* a, const uchar* b) const;
+    float distanceTo(const uchar* q, int node) const { return distance(q, data_.ptr(node)); }
+    std::vector<int> neighbours(int node, int level) const;
+    int greedyClosest(const uchar* q, int entry, int fromLevel, int toLevel) const;
+    std::vector<Candidate> searchLayer(const uchar* q, int entry, int ef, int level) const;
+    std::vector<int> selectNeighbours(const std::vector<Candidate>& sorted, int m) const;
+    void insert(int node);
+    void resetLocks();
+    int maxLinks(int level) const { return level == 0 ? 2 * params_.M : params_.M; }
+
+    int normType_;
+    HnswParams params_;
+    cv::Mat data_;                                  // CV_32F (L1/L2) or CV_8U (Hamming), continuous
+    std::vector<int> levels_;
+    std::vector<std::vector<std::vector<int>>> links_;  // [node][level] -> neighbour ids
+    std::unique_ptr<std::mutex[]> link_locks_;
+    mutable std::mutex entry_lock_;
+    int entry_point_ = -1;
+    int max_level_ = -1;
+};
+
+} // namespace thesis_project::matching
@@ -0,0 +1,127 @@
+#include "HnswMatching.hpp"
+#include "thesis_project/logging.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+
+namespace thesis_project::matching {
+
+namespace {
+
+uint64_t hashDescriptors(const cv::Mat& m) {
+    uint64_t h = 1469598103934665603ULL;
+    auto mix = [&h](const void* p, size_t n) {
+        const auto* bytes = static_cast<const unsigned char*>(p);
+        for (size_t i = 0; i < n; ++i) {
+            h ^= bytes[i];
+            h *= 1099511628211ULL;
+        }
+    };
+    const int header[3] = {m.rows, m.cols, m.type()};
+    mix(header, sizeof(header));
+    const size_t rowBytes = m.cols * m.elemSize();
+    for (int r = 0; r < m.rows; ++r) mix(m.ptr(r), rowBytes);
+    return h;
+}
+
+} // namespace
+
+HnswMatching::HnswMatching(int normType, bool crossCheck, const HnswParams& params, std::string indexDir)
+    : normType_(normType), crossCheck_(crossCheck), params_(params), indexDir_(std::move(indexDir)) {
+}
+
+std::string HnswMatching::indexPathFor(const cv::Mat& train) const {
+    if (indexDir_.empty()) return "";
+    char name[96];
+    std::snprintf(name, sizeof(name), "hnsw_%016llx_n%d_m%d_efc%d.bin",
+                  static_cast<unsigned long long>(hashDescriptors(train)),
+                  normType_, params_.M, params_.ef_construction);
+    return (std::filesystem::path(indexDir_) / name).string();
+}
+
+const HnswIndex& HnswMatching::indexFor(const cv::Mat& train) {
+    for (auto it = cache_.begin(); it != cache_.end(); ++it) {
+        if (it->data == train.data && it->rows == train.rows &&
+            it->cols == train.cols && it->type == train.type()) {
+            if (it != cache_.begin()) {
+                CachedIndex hit = *it;
+                cache_.erase(it);
+                cache_.push_front(hit);
+            }
+            return *cache_.front().index;
+        }
+    }
+
+    CachedIndex entry;
+    entry.data = train.data;
+    entry.rows = train.rows;
+    entry.cols = train.cols;
+    entry.type = train.type();
+    entry.features = train;
+    entry.index = std::make_shared<HnswIndex>(normType_, params_);
+
+    const std::string path = indexPathFor(train);
+    if (path.empty() || !entry.index->load(path, train)) {
+        entry.index->build(train);
+        if (!path.empty()) {
+            std::error_code ec;
+            std::filesystem::create_directories(indexDir_, ec);
+            if (!entry.index->save(path)) {
+                LOG_WARNING("Failed to persist HNSW index to " + path);
+            }
+        }
+    }
+
+    cache_.push_front(entry);
+    if (cache_.size() > kCacheSize) cache_.pop_back();
+    return *cache_.front().index;
+}
+
+std::vector<cv::DMatch> HnswMatching::matchDescriptors(
+    const cv::Mat& descriptors1,
+    const cv::Mat& descriptors2
+) {
+    std::vector<cv::DMatch> matches;
+    if (descriptors1.empty() || descriptors2.empty()) return matches;
+
+    std::vector<int> fwdIdx;
+    std::vector<float> fwdDist;
+    indexFor(descriptors2).search(descriptors1, fwdIdx, fwdDist);
+
+    std::vector<int> bwdIdx;
+    std::vector<float> bwdDist;
+    if (crossCheck_) indexFor(descriptors1).search(descriptors2, bwdIdx, bwdDist);
+
+    matches.reserve(descriptors1.rows);
+    for (int q = 0; q < descriptors1.rows; ++q) {
+        const int t = fwdIdx[q];
+        if (t < 0) continue;
+        if (crossCheck_ && bwdIdx[t] != q) continue;
+        matches.emplace_back(q, t, fwdDist[q]);
+    }
+    return matches;
+}
+
+double HnswMatching::calculatePrecision(
+    const std::vector<cv::DMatch>& matches,
+    const std::vector<cv::KeyPoint>& keypoints2,
+    const std::vector<cv::Point2f>& projectedPoints,
+    double matchThreshold
+) {
+    int truePositives = 0;
+    for (const auto& match : matches) {
+        if (cv::norm(projectedPoints[match.queryIdx] - keypoints2[match.trainIdx].pt) <= matchThreshold) {
+            truePositives++;
+        }
+    }
+    return matches.empty() ? 0 : static_cast<double>(truePositives) / matches.size();
+}
+
+double HnswMatching::adjustMatchThreshold(
+    double baseThreshold,
+    double scaleFactor
+) {
+    return baseThreshold * scaleFactor;
+}
+
+} // namespace thesis_project::matching
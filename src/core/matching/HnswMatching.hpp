@@ -0,0 +1,95 @@
+#pragma once
+
+#include "MatchingStrategy.hpp"
+#include "HnswIndex.hpp"
+#include <deque>
+#include <memory>
+#include <string>
+
+namespace thesis_project::matching {
+
+/**
+ * @brief Approximate matching backed by an HNSW graph index
+ *
+ * Intended for large keypoint sets where brute force is quadratic. The
+ * index is built over descriptors2 (and over descriptors1 for the
+ * cross-check direction) and cached per train matrix, like FlannMatching.
+ *
+ * When an index directory is configured, built graphs are written there
+ * keyed by a hash of the descriptor bytes and the build parameters, and are
+ * loaded instead of rebuilt on later runs over the same descriptors.
+ */
+class HnswMatching : public MatchingStrategy {
+public:
+    /**
+     * @param normType cv::NORM_L2 / cv::NORM_L1 for float, cv::NORM_HAMMING for binary
+     * @param crossCheck Keep only mutual nearest neighbours
+     * @param params M / ef_construction / ef_search
+     * @param indexDir Directory for persisted graphs (empty = do not persist)
+     */
+    explicit HnswMatching(
+        int normType = cv::NORM_L2,
+        bool crossCheck = true,
+        const HnswParams& params = HnswParams(),
+        std::string indexDir = ""
+    );
+
+    std::vector<cv::DMatch> matchDescriptors(
+        const cv::Mat& descriptors1,
+        const cv::Mat& descriptors2
+    ) override;
+
+    double calculatePrecision(
+        const std::vector<cv::DMatch>& matches,
+        const std::vector<cv::KeyPoint>& keypoints2,
+        const std::vector<cv::Point2f>& projectedPoints,
+        double matchThreshold
+    ) override;
+
+    double adjustMatchThreshold(
+        double baseThreshold,
+        double scaleFactor
+    ) override;
+
+    std::string getName() const override {
+        return "HNSW";
+    }
+
+    bool supportsRatioTest() const override {
+        return false;
+    }
+
+    bool isApproximate() const override {
+        return true;
+    }
+
+    bool parallelizesQueries() const override {
+        return true;
+    }
+
+    /**
+     * @brief Persisted index file for a descriptor matrix (empty if no index directory)
+     */
+    std::string indexPathFor(const cv::Mat& train) const;
+
+private:
+    struct CachedIndex {
+        const uchar* data = nullptr;
+        int rows = 0;
+        int cols = 0;
+        int type = -1;
+        cv::Mat features;                    // keeps the indexed buffer alive
+        std::shared_ptr<HnswIndex> index;
+    };
+
+    const HnswIndex& indexFor(const cv::Mat& train);
+
+    int normType_;
+    bool crossCheck_;
+    HnswParams params_;
+    std::string indexDir_;
+    std::deque<CachedIndex> cache_;          // most recent first
+    static constexpr size_t kCacheSize = 2;
+};
+
+} // namespace thesis_project::matching
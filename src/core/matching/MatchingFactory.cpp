@@ -1,5 +1,13 @@
 #include "MatchingFactory.hpp"
 #include "BruteForceMatching.hpp"
+#include "FlannMatching.hpp"
+#include "RatioTestMatching.hpp"
+#include "HnswMatching.hpp"
+#include "PQMatching.hpp"
+#include "HashMatching.hpp"
+#include "ReverseIndexMatching.hpp"
+#include "ParallelMatching.hpp"
+#include "thesis_project/logging.hpp"
 #include <stdexcept>
 
 namespace thesis_project::matching {
@@ -10,10 +18,10 @@ MatchingStrategyPtr MatchingFactory::createStrategy(::MatchingStrategy strategy)
             return std::make_unique<BruteForceMatching>();
             
         case FLANN:
-            throw std::runtime_error("FLANN matching strategy not yet implemented");
+            return std::make_unique<FlannMatching>();
             
         case RATIO_TEST:
-            throw std::runtime_error("Ratio test matching strategy not yet implemented");
+            return std::make_unique<RatioTestMatching>();
             
         default:
             throw std::runtime_error("Unknown matching strategy: " + std::to_string(static_cast<int>(strategy)));
@@ -24,11 +32,97 @@ MatchingStrategyPtr MatchingFactory::createFromConfig(const experiment_config& c
     return createStrategy(config.matchingStrategy);
 }
 
+namespace {
+
+bool isIndexBased(thesis_project::MatchingMethod method) {
+    switch (method) {
+        case thesis_project::MatchingMethod::FLANN:
+        case thesis_project::MatchingMethod::HNSW:
+        case thesis_project::MatchingMethod::PQ:
+        case thesis_project::MatchingMethod::HASH:
+            return true;
+        default:
+            return false;
+    }
+}
+
+MatchingStrategyPtr createForMethod(const thesis_project::EvaluationParams& params, bool crossCheck) {
+    switch (params.matching_method) {
+        case thesis_project::MatchingMethod::BRUTE_FORCE:
+            return std::make_unique<BruteForceMatching>(params.norm_type, crossCheck);
+
+        case thesis_project::MatchingMethod::FLANN:
+            return std::make_unique<FlannMatching>(
+                params.norm_type, crossCheck, params.flann_trees, params.flann_checks);
+
+        case thesis_project::MatchingMethod::RATIO_TEST:
+            return std::make_unique<RatioTestMatching>(params.norm_type, params.match_threshold);
+
+        case thesis_project::MatchingMethod::HNSW: {
+            HnswParams hnsw;
+            hnsw.M = params.hnsw_m;
+            hnsw.ef_construction = params.hnsw_ef_construction;
+            hnsw.ef_search = params.hnsw_ef_search;
+            return std::make_unique<HnswMatching>(params.norm_type, crossCheck, hnsw, params.hnsw_index_dir);
+        }
+
+        case thesis_project::MatchingMethod::PQ: {
+            quantization::PQParams pq;
+            pq.m = params.pq_m;
+            pq.bits = params.pq_bits;
+            return std::make_unique<PQMatching>(crossCheck, pq, params.pq_codebook);
+        }
+
+        case thesis_project::MatchingMethod::HASH: {
+            quantization::BinaryHashParams hash;
+            hash.bits = params.hash_bits;
+            hash.projection = params.hash_projection;
+            return std::make_unique<HashMatching>(
+                params.norm_type, crossCheck, hash, params.hash_rerank, params.hash_model);
+        }
+
+        default:
+            throw std::runtime_error("Unknown matching method: " + thesis_project::toString(params.matching_method));
+    }
+}
+
+} // namespace
+
+MatchingStrategyPtr MatchingFactory::createFromConfig(const thesis_project::EvaluationParams& params) {
+    // The reverse-index wrapper runs descriptors2 -> descriptors1 without a backward pass
+    const bool reverse = params.reuse_query_index && isIndexBased(params.matching_method);
+    const bool crossCheck = !reverse && params.cross_check;
+    if (reverse && params.cross_check) {
+        // A backward pass would need the per-pair index over descriptors2 that reuse avoids
+        LOG_WARNING("matching.cross_check is not applied with reuse_query_index for " +
+                    thesis_project::toString(params.matching_method) +
+                    ": matches keep every mutual pair plus some one-sided ones");
+    }
+
+    MatchingStrategyPtr matcher;
+    if (params.match_threads != 1) {
+        // Ratio-test matching has no cross-check step to resolve
+        const bool parallelCrossCheck = crossCheck &&
+            params.matching_method != thesis_project::MatchingMethod::RATIO_TEST;
+        matcher = std::make_unique<ParallelMatching>(
+            [params](bool workerCrossCheck) { return createForMethod(params, workerCrossCheck); },
+            parallelCrossCheck, params.match_threads);
+    } else {
+        matcher = createForMethod(params, crossCheck);
+    }
+
+    if (reverse) return std::make_unique<ReverseIndexMatching>(std::move(matcher));
+    return matcher;
+}
+
 std::vector<std::string> MatchingFactory::getAvailableStrategies() {
     return {
         "BruteForce",
-        "FLANN (future)",
-        "RatioTest (future)"
+        "FLANN",
+        "RatioTest",
+        "HNSW",
+        "PQ",
+        "Hash"
     };
 }
 
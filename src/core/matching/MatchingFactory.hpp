@@ -2,6 +2,7 @@
 
 #include "MatchingStrategy.hpp"
 #include "src/core/config/experiment_config.hpp"
+#include "thesis_project/types.hpp"
 #include <memory>
 #include <vector>
 #include <string>
@@ -17,10 +18,13 @@ namespace thesis_project::matching {
  * 
  * Supported strategies:
  * - BruteForce: Simple brute-force matching with cross-check
+ * - FLANN: Approximate matching (k-d forest for float, LSH for binary)
+ * - RatioTest: Lowe's ratio test for better quality
+ * - HNSW: Graph-index approximate matching for large descriptor sets (Schema v1 only)
+ * - PQ: Asymmetric-distance scan over product-quantized codes (Schema v1 only)
+ * - Hash: Hamming pre-filter over binarized descriptors with float re-rank (Schema v1 only)
  * 
  * Future strategies could include:
- * - FLANN: Fast approximate matching
- * - RatioTest: Lowe's ratio test for better quality
  * - Hybrid: Combining multiple strategies
  */
 class MatchingFactory {
@@ -45,6 +49,19 @@ public:
      */
     static MatchingStrategyPtr createFromConfig(const experiment_config& config);
 
+    /**
+     * @brief Create a matching strategy from Schema v1 evaluation parameters
+     *
+     * Honours method, norm, cross_check, the ratio (threshold) and the
+     * FLANN / HNSW / PQ / hash settings. With reuse_query_index, index-based
+     * methods are wrapped in ReverseIndexMatching, which replaces cross_check
+     * (a warning is logged when both are set).
+     *
+     * @param params evaluation.params from the YAML configuration
+     * @return MatchingStrategyPtr Unique pointer to the created strategy
+     */
+    static MatchingStrategyPtr createFromConfig(const thesis_project::EvaluationParams& params);
+
     /**
      * @brief Get list of all available matching strategy names
      * @return std::vector<std::string> List of strategy names for display/logging
@@ -3,6 +3,8 @@
 #include <opencv2/opencv.hpp>
 #include <vector>
 #include <memory>
+#include <stdexcept>
+#include <string>
 
 namespace thesis_project::matching {
 
@@ -70,6 +72,46 @@ public:
      * @return bool True if ratio testing is supported
      */
     virtual bool supportsRatioTest() const = 0;
+
+    /**
+     * @brief Check if this strategy returns approximate nearest neighbours
+     * @return bool True if results may differ from exact search (scored against brute force)
+     */
+    virtual bool isApproximate() const { return false; }
+
+    /**
+     * @brief Check if matchDescriptors() already spreads query rows over cv::parallel_for_
+     * @return bool True if query-splitting wrappers should call it directly, cross-check included
+     */
+    virtual bool parallelizesQueries() const { return false; }
+
+    /**
+     * @brief Build (or fetch from cache) the search structure over train for shared use
+     * @return bool True if nearestShared() may then run concurrently against train
+     */
+    virtual bool prepareShared(const cv::Mat& train) {
+        (void)train;
+        return false;
+    }
+
+    /**
+     * @brief Nearest train row per query row, read-only against a prepareShared() structure
+     *
+     * Safe to call from several threads at once until the next non-const call.
+     * idx is -1 where no neighbour is found.
+     */
+    virtual void nearestShared(
+        const cv::Mat& query,
+        const cv::Mat& train,
+        std::vector<int>& idx,
+        std::vector<float>& dist
+    ) const {
+        (void)query;
+        (void)train;
+        (void)idx;
+        (void)dist;
+        throw std::logic_error(getName() + " does not support shared search");
+    }
 };
 
 using MatchingStrategyPtr = std::unique_ptr<MatchingStrategy>;
@@ -0,0 +1,146 @@
+#include "PQMatching.hpp"
+#include "DistanceKernels.hpp"
+#include "thesis_project/logging.hpp"
+#include <cmath>
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+
+namespace thesis_project::matching {
+
+PQMatching::PQMatching(bool crossCheck, const quantization::PQParams& params, std::string codebookPath)
+    : crossCheck_(crossCheck), params_(params), codebookPath_(std::move(codebookPath)) {
+}
+
+void PQMatching::ensureQuantizer(const cv::Mat& train) {
+    if (quantizer_.fitted()) return;
+
+    if (!codebookPath_.empty() && std::filesystem::exists(codebookPath_)) {
+        if (!quantizer_.load(codebookPath_)) {
+            throw std::runtime_error("Failed to load PQ codebook: " + codebookPath_);
+        }
+        LOG_INFO("Loaded PQ codebook " + codebookPath_ + " (m=" + std::to_string(quantizer_.subspaces()) +
+                 ", " + std::to_string(quantizer_.centroids()) + " centroids)");
+    } else {
+        quantizer_ = quantization::ProductQuantizer::fit(train, params_);
+        LOG_INFO("Trained PQ codebook on " + std::to_string(train.rows) + " descriptors (m=" +
+                 std::to_string(quantizer_.subspaces()) + ", " + std::to_string(quantizer_.centroids()) + " centroids)");
+        if (!codebookPath_.empty() && !quantizer_.save(codebookPath_)) {
+            LOG_WARNING("Failed to persist PQ codebook to " + codebookPath_);
+        }
+    }
+    if (quantizer_.dims() != train.cols) {
+        throw std::invalid_argument("PQ codebook width " + std::to_string(quantizer_.dims()) +
+                                    " does not match descriptor width " + std::to_string(train.cols));
+    }
+}
+
+const cv::Mat& PQMatching::codesFor(const cv::Mat& train) {
+    for (auto it = cache_.begin(); it != cache_.end(); ++it) {
+        if (it->data == train.data && it->rows == train.rows &&
+            it->cols == train.cols && it->type == train.type()) {
+            if (it != cache_.begin()) {
+                CachedCodes hit = *it;
+                cache_.erase(it);
+                cache_.push_front(hit);
+            }
+            return cache_.front().codes;
+        }
+    }
+
+    CachedCodes entry;
+    entry.data = train.data;
+    entry.rows = train.rows;
+    entry.cols = train.cols;
+    entry.type = train.type();
+    entry.source = train;
+    entry.codes = quantizer_.encode(train);
+
+    cache_.push_front(entry);
+    if (cache_.size() > kCacheSize) cache_.pop_back();
+    return cache_.front().codes;
+}
+
+void PQMatching::nearest(const cv::Mat& query, const cv::Mat& train,
+                         std::vector<int>& idx, std::vector<float>& dist) {
+    const cv::Mat& codes = codesFor(train);
+
+    cv::Mat q;
+    if (query.type() == CV_32F) {
+        q = query;
+    } else {
+        q = kernels::toFloat(query);
+    }
+
+    idx.assign(q.rows, -1);
+    dist.assign(q.rows, 0.0f);
+    const int tableSize = quantizer_.subspaces() * quantizer_.centroids();
+
+    cv::parallel_for_(cv::Range(0, q.rows), [&](const cv::Range& range) {
+        std::vector<float> table(tableSize);
+        for (int r = range.start; r < range.end; ++r) {
+            quantizer_.distanceTable(q.ptr<float>(r), table.data());
+            int best = -1;
+            float bestDist = std::numeric_limits<float>::max();
+            for (int t = 0; t < codes.rows; ++t) {
+                const float d = quantizer_.adcDistance(table.data(), codes.ptr<uchar>(t));
+                if (d < bestDist) {
+                    bestDist = d;
+                    best = t;
+                }
+            }
+            idx[r] = best;
+            dist[r] = best >= 0 ? std::sqrt(std::max(bestDist, 0.0f)) : 0.0f;
+        }
+    });
+}
+
+std::vector<cv::DMatch> PQMatching::matchDescriptors(
+    const cv::Mat& descriptors1,
+    const cv::Mat& descriptors2
+) {
+    std::vector<cv::DMatch> matches;
+    if (descriptors1.empty() || descriptors2.empty()) return matches;
+    ensureQuantizer(descriptors2);
+
+    std::vector<int> fwdIdx;
+    std::vector<float> fwdDist;
+    nearest(descriptors1, descriptors2, fwdIdx, fwdDist);
+
+    std::vector<int> bwdIdx;
+    std::vector<float> bwdDist;
+    if (crossCheck_) nearest(descriptors2, descriptors1, bwdIdx, bwdDist);
+
+    matches.reserve(descriptors1.rows);
+    for (int q = 0; q < descriptors1.rows; ++q) {
+        const int t = fwdIdx[q];
+        if (t < 0) continue;
+        if (crossCheck_ && bwdIdx[t] != q) continue;
+        matches.emplace_back(q, t, fwdDist[q]);
+    }
+    return matches;
+}
+
+double PQMatching::calculatePrecision(
+    const std::vector<cv::DMatch>& matches,
+    const std::vector<cv::KeyPoint>& keypoints2,
+    const std::vector<cv::Point2f>& projectedPoints,
+    double matchThreshold
+) {
+    int truePositives = 0;
+    for (const auto& match : matches) {
+        if (cv::norm(projectedPoints[match.queryIdx] - keypoints2[match.trainIdx].pt) <= matchThreshold) {
+            truePositives++;
+        }
+    }
+    return matches.empty() ? 0 : static_cast<double>(truePositives) / matches.size();
+}
+
+double PQMatching::adjustMatchThreshold(
+    double baseThreshold,
+    double scaleFactor
+) {
+    return baseThreshold * scaleFactor;
+}
+
+} // namespace thesis_project::matching
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "MatchingStrategy.hpp"
+#include "src/core/descriptor/quantization/ProductQuantizer.hpp"
+#include <deque>
+#include <string>
+
+namespace thesis_project::matching {
+
+/**
+ * @brief Approximate L2 matching over product-quantized train descriptors
+ *
+ * Train descriptors are stored as PQ codes (m bytes per row). Each query
+ * stays float and is scanned against the codes with asymmetric distance
+ * lookup tables. That scans 16-32x fewer bytes than brute force over
+ * float rows.
+ *
+ * Codebooks are loaded from the configured file when it exists. Otherwise
+ * they are trained on the first train set seen, and saved to the file if a
+ * path is configured. Later pairs reuse them, as with a dataset-level
+ * codebook. Encoded rows are cached per train matrix like FlannMatching
+ * indexes.
+ */
+class PQMatching : public MatchingStrategy {
+public:
+    /**
+     * @param crossCheck Keep only mutual nearest neighbours
+     * @param params Subspaces / bits per sub-code
+     * @param codebookPath Codebook file to load, or to write after training (empty = train in memory)
+     */
+    explicit PQMatching(
+        bool crossCheck = true,
+        const quantization::PQParams& params = quantization::PQParams(),
+        std::string codebookPath = ""
+    );
+
+    std::vector<cv::DMatch> matchDescriptors(
+        const cv::Mat& descriptors1,
+        const cv::Mat& descriptors2
+    ) override;
+
+    double calculatePrecision(
+        const std::vector<cv::DMatch>& matches,
+        const std::vector<cv::KeyPoint>& keypoints2,
+        const std::vector<cv::Point2f>& projectedPoints,
+        double matchThreshold
+    ) override;
+
+    double adjustMatchThreshold(
+        double baseThreshold,
+        double scaleFactor
+    ) override;
+
+    std::string getName() const override {
+        return "PQ";
+    }
+
+    bool supportsRatioTest() const override {
+        return false;
+    }
+
+    bool isApproximate() const override {
+        return true;
+    }
+
+    bool parallelizesQueries() const override {
+        return true;
+    }
+
+    const quantization::ProductQuantizer& quantizer() const { return quantizer_; }
+
+private:
+    struct CachedCodes {
+        const uchar* data = nullptr;
+        int rows = 0;
+        int cols = 0;
+        int type = -1;
+        cv::Mat source;   // keeps the encoded buffer alive
+        cv::Mat codes;
+    };
+
+    void ensureQuantizer(const cv::Mat& train);
+    const cv::Mat& codesFor(const cv::Mat& train);
+    void nearest(const cv::Mat& query, const cv::Mat& train,
+                 std::vector<int>& idx, std::vector<float>& dist);
+
+    bool crossCheck_;
+    quantization::PQParams params_;
+    std::string codebookPath_;
+    quantization::ProductQuantizer quantizer_;
+    std::deque<CachedCodes> cache_;          // most recent first
+    static constexpr size_t kCacheSize = 2;
+};
+
+} // namespace thesis_project::matching
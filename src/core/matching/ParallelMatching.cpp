@@ -0,0 +1,150 @@
+#include "ParallelMatching.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <stdexcept>
+
+namespace thesis_project::matching {
+
+ParallelMatching::ParallelMatching(const WorkerFactory& makeWorker, bool crossCheck, int threads)
+    : makeWorker_(makeWorker), crossCheck_(crossCheck),
+      threads_(threads > 0 ? threads : std::max(1, cv::getNumThreads())) {
+    if (!makeWorker_) {
+        throw std::invalid_argument("ParallelMatching requires a worker factory");
+    }
+    primary_ = makeWorker_(crossCheck_);
+    if (!primary_) {
+        throw std::invalid_argument("ParallelMatching worker factory returned no matcher");
+    }
+}
+
+namespace {
+
+// Runs body(c, r0, r1) for each of `chunks` contiguous row ranges of rows, one
+// stripe per chunk, and rethrows the first failure after all chunks finish
+template <typename Body>
+void forEachChunk(int rows, int chunks, const Body& body) {
+    std::vector<std::exception_ptr> errors(chunks);
+    cv::parallel_for_(cv::Range(0, chunks), [&](const cv::Range& range) {
+        for (int c = range.start; c < range.end; ++c) {
+            const int r0 = static_cast<int>(static_cast<int64_t>(rows) * c / chunks);
+            const int r1 = static_cast<int>(static_cast<int64_t>(rows) * (c + 1) / chunks);
+            try {
+                body(c, r0, r1);
+            } catch (...) {
+                errors[c] = std::current_exception();
+            }
+        }
+    }, chunks);
+
+    for (const auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+}
+
+} // namespace
+
+void ParallelMatching::nearestChunked(const cv::Mat& query, const cv::Mat& train,
+                                      std::vector<int>& idx, std::vector<float>& dist) const {
+    idx.assign(query.rows, -1);
+    dist.assign(query.rows, 0.0f);
+    const int chunks = std::min(threads_, query.rows);
+    forEachChunk(query.rows, chunks, [&](int, int r0, int r1) {
+        std::vector<int> chunkIdx;
+        std::vector<float> chunkDist;
+        primary_->nearestShared(query.rowRange(r0, r1), train, chunkIdx, chunkDist);
+        std::copy(chunkIdx.begin(), chunkIdx.end(), idx.begin() + r0);
+        std::copy(chunkDist.begin(), chunkDist.end(), dist.begin() + r0);
+    });
+}
+
+std::vector<cv::DMatch> ParallelMatching::matchChunked(const cv::Mat& query, const cv::Mat& train) {
+    const int chunks = std::min(threads_, query.rows);
+    while (static_cast<int>(workers_.size()) < chunks) {
+        auto worker = makeWorker_(false);
+        if (!worker) {
+            throw std::invalid_argument("ParallelMatching worker factory returned no matcher");
+        }
+        workers_.push_back(std::move(worker));
+    }
+
+    // Chunk c is only ever touched by worker c
+    std::vector<std::vector<cv::DMatch>> parts(chunks);
+    forEachChunk(query.rows, chunks, [&](int c, int r0, int r1) {
+        parts[c] = workers_[c]->matchDescriptors(query.rowRange(r0, r1), train);
+        for (auto& m : parts[c]) m.queryIdx += r0;
+    });
+
+    std::vector<cv::DMatch> merged;
+    size_t total = 0;
+    for (const auto& part : parts) total += part.size();
+    merged.reserve(total);
+    for (auto& part : parts) merged.insert(merged.end(), part.begin(), part.end());
+    return merged;
+}
+
+std::vector<cv::DMatch> ParallelMatching::matchDescriptors(
+    const cv::Mat& descriptors1,
+    const cv::Mat& descriptors2
+) {
+    if (descriptors1.empty() || descriptors2.empty()) return {};
+
+    // Already query-parallel: splitting again would only repeat its train-side work
+    if (primary_->parallelizesQueries()) return primary_->matchDescriptors(descriptors1, descriptors2);
+
+    if (primary_->prepareShared(descriptors2) && (!crossCheck_ || primary_->prepareShared(descriptors1))) {
+        // Each index is built once above; chunks only read it
+        std::vector<int> fwdIdx, bwdIdx;
+        std::vector<float> fwdDist, bwdDist;
+        nearestChunked(descriptors1, descriptors2, fwdIdx, fwdDist);
+        if (crossCheck_) nearestChunked(descriptors2, descriptors1, bwdIdx, bwdDist);
+
+        std::vector<cv::DMatch> matches;
+        matches.reserve(descriptors1.rows);
+        for (int q = 0; q < descriptors1.rows; ++q) {
+            const int t = fwdIdx[q];
+            if (t < 0 || t >= descriptors2.rows) continue;
+            if (crossCheck_ && bwdIdx[t] != q) continue;
+            matches.emplace_back(q, t, fwdDist[q]);
+        }
+        return matches;
+    }
+
+    std::vector<cv::DMatch> forward = matchChunked(descriptors1, descriptors2);
+    if (!crossCheck_) return forward;
+
+    // Backward pass: nearest descriptors1 row of every descriptors2 row
+    std::vector<int> backward(descriptors2.rows, -1);
+    for (const auto& m : matchChunked(descriptors2, descriptors1)) {
+        if (m.queryIdx >= 0 && m.queryIdx < descriptors2.rows && backward[m.queryIdx] < 0) {
+            backward[m.queryIdx] = m.trainIdx;
+        }
+    }
+
+    std::vector<cv::DMatch> matches;
+    matches.reserve(forward.size());
+    for (const auto& m : forward) {
+        if (m.trainIdx >= 0 && m.trainIdx < descriptors2.rows && backward[m.trainIdx] == m.queryIdx) {
+            matches.push_back(m);
+        }
+    }
+    return matches;
+}
+
+double ParallelMatching::calculatePrecision(
+    const std::vector<cv::DMatch>& matches,
+    const std::vector<cv::KeyPoint>& keypoints2,
+    const std::vector<cv::Point2f>& projectedPoints,
+    double matchThreshold
+) {
+    return primary_->calculatePrecision(matches, keypoints2, projectedPoints, matchThreshold);
+}
+
+double ParallelMatching::adjustMatchThreshold(
+    double baseThreshold,
+    double scaleFactor
+) {
+    return primary_->adjustMatchThreshold(baseThreshold, scaleFactor);
+}
+
+} // namespace thesis_project::matching
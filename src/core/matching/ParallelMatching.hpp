@@ -0,0 +1,88 @@
+#pragma once
+
+#include "MatchingStrategy.hpp"
+#include <functional>
+
+namespace thesis_project::matching {
+
+/**
+ * @brief Runs any matcher on query-row chunks in parallel
+ *
+ * One primary matcher is created with the requested cross-check, and the
+ * work is split in the cheapest way it allows:
+ *
+ * - Matchers that already spread query rows over cv::parallel_for_
+ *   (brute force, HNSW, PQ, hash) are called directly, so cross-check stays
+ *   their single-pass or cached-index implementation.
+ * - Matchers with a shared read-only search (FLANN) build each index once
+ *   via prepareShared(), then query-row chunks call nearestShared() against
+ *   it from every thread. Cross-check searches the index over descriptors1
+ *   the same way.
+ * - Anything else gets one non-cross-checking worker per chunk, so stateful
+ *   matchers are never shared between threads. Cross-check is then resolved
+ *   here with a chunked backward pass.
+ *
+ * Chunk results are shifted back to global query indices and concatenated
+ * in query order. For exact matchers the result is the same as running the
+ * primary matcher single-threaded.
+ */
+class ParallelMatching : public MatchingStrategy {
+public:
+    using WorkerFactory = std::function<MatchingStrategyPtr(bool crossCheck)>;
+
+    /**
+     * @param makeWorker Creates a matcher with or without cross-check
+     * @param crossCheck Keep only mutual nearest neighbours
+     * @param threads Chunk count (<= 0 = cv::getNumThreads())
+     */
+    explicit ParallelMatching(const WorkerFactory& makeWorker, bool crossCheck = true, int threads = 0);
+
+    std::vector<cv::DMatch> matchDescriptors(
+        const cv::Mat& descriptors1,
+        const cv::Mat& descriptors2
+    ) override;
+
+    double calculatePrecision(
+        const std::vector<cv::DMatch>& matches,
+        const std::vector<cv::KeyPoint>& keypoints2,
+        const std::vector<cv::Point2f>& projectedPoints,
+        double matchThreshold
+    ) override;
+
+    double adjustMatchThreshold(
+        double baseThreshold,
+        double scaleFactor
+    ) override;
+
+    std::string getName() const override {
+        return primary_->getName() + "+Parallel";
+    }
+
+    bool supportsRatioTest() const override {
+        return primary_->supportsRatioTest();
+    }
+
+    bool isApproximate() const override {
+        return primary_->isApproximate();
+    }
+
+    bool parallelizesQueries() const override {
+        return true;
+    }
+
+    int threads() const { return threads_; }
+
+private:
+    // Nearest train row per query row from chunks of query sharing primary_'s structure
+    void nearestChunked(const cv::Mat& query, const cv::Mat& train,
+                        std::vector<int>& idx, std::vector<float>& dist) const;
+    std::vector<cv::DMatch> matchChunked(const cv::Mat& query, const cv::Mat& train);
+
+    WorkerFactory makeWorker_;
+    bool crossCheck_;
+    int threads_;
+    MatchingStrategyPtr primary_;
+    std::vector<MatchingStrategyPtr> workers_;   // per-chunk fallback, created on first use
+};
+
+} // namespace thesis_project::matching
@@ -0,0 +1,52 @@
+#include "RatioTestMatching.hpp"
+#include "DistanceKernels.hpp"
+
+namespace thesis_project::matching {
+
+RatioTestMatching::RatioTestMatching(int normType, float ratio)
+    : normType_(normType), ratio_(ratio) {
+}
+
+std::vector<cv::DMatch> RatioTestMatching::matchDescriptors(
+    const cv::Mat& descriptors1,
+    const cv::Mat& descriptors2
+) {
+    std::vector<cv::DMatch> matches;
+    if (descriptors1.empty() || descriptors2.empty()) return matches;
+
+    kernels::TopTwo nn;
+    kernels::topTwoNeighbours(descriptors1, descriptors2, normType_, nn);
+
+    matches.reserve(descriptors1.rows);
+    for (int q = 0; q < descriptors1.rows; ++q) {
+        if (nn.idx1[q] < 0) continue;
+        // A lone train row has no second neighbour to compare against; keep it
+        if (nn.idx2[q] >= 0 && !(nn.dist1[q] < ratio_ * nn.dist2[q])) continue;
+        matches.emplace_back(q, nn.idx1[q], nn.dist1[q]);
+    }
+    return matches;
+}
+
+double RatioTestMatching::calculatePrecision(
+    const std::vector<cv::DMatch>& matches,
+    const std::vector<cv::KeyPoint>& keypoints2,
+    const std::vector<cv::Point2f>& projectedPoints,
+    double matchThreshold
+) {
+    int truePositives = 0;
+    for (const auto& match : matches) {
+        if (cv::norm(projectedPoints[match.queryIdx] - keypoints2[match.trainIdx].pt) <= matchThreshold) {
+            truePositives++;
+        }
+    }
+    return matches.empty() ? 0 : static_cast<double>(truePositives) / matches.size();
+}
+
+double RatioTestMatching::adjustMatchThreshold(
+    double baseThreshold,
+    double scaleFactor
+) {
+    return baseThreshold * scaleFactor;
+}
+
+} // namespace thesis_project::matching
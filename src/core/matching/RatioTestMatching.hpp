@@ -0,0 +1,63 @@
+#pragma once
+
+#include "MatchingStrategy.hpp"
+
+namespace thesis_project::matching {
+
+/**
+ * @brief Lowe ratio-test matching
+ *
+ * Keeps a nearest neighbour only if it is clearly better than the second
+ * nearest: d1 < ratio * d2. The two neighbours come from the blocked exact
+ * top-2 kernel (kernels::topTwoNeighbours), so no knnMatch
+ * vector-of-vectors is allocated.
+ *
+ * Features:
+ * - L2 / L1 for float descriptors, Hamming for binary
+ * - Ratio taken from evaluation.matching.threshold (default 0.8)
+ * - Query rows matched in parallel blocks
+ */
+class RatioTestMatching : public MatchingStrategy {
+public:
+    /**
+     * @param normType cv::NORM_L2 / cv::NORM_L1 for float, cv::NORM_HAMMING for binary
+     * @param ratio Maximum d1/d2 for a match to be kept
+     */
+    explicit RatioTestMatching(
+        int normType = cv::NORM_L2,
+        float ratio = 0.8f
+    );
+
+    std::vector<cv::DMatch> matchDescriptors(
+        const cv::Mat& descriptors1,
+        const cv::Mat& descriptors2
+    ) override;
+
+    double calculatePrecision(
+        const std::vector<cv::DMatch>& matches,
+        const std::vector<cv::KeyPoint>& keypoints2,
+        const std::vector<cv::Point2f>& projectedPoints,
+        double matchThreshold
+    ) override;
+
+    double adjustMatchThreshold(
+        double baseThreshold,
+        double scaleFactor
+    ) override;
+
+    std::string getName() const override {
+        return "RatioTest";
+    }
+
+    bool supportsRatioTest() const override {
+        return true;
+    }
+
+    float ratio() const { return ratio_; }
+
+private:
+    int normType_;
+    float ratio_;
+};
+
+} // namespace thesis_project::matching
@@ -0,0 +1,60 @@
+#include "ReverseIndexMatching.hpp"
+#include <stdexcept>
+
+namespace thesis_project::matching {
+
+ReverseIndexMatching::ReverseIndexMatching(MatchingStrategyPtr inner)
+    : inner_(std::move(inner)) {
+    if (!inner_) {
+        throw std::invalid_argument("ReverseIndexMatching requires a matcher to wrap");
+    }
+}
+
+std::vector<cv::DMatch> ReverseIndexMatching::matchDescriptors(
+    const cv::Mat& descriptors1,
+    const cv::Mat& descriptors2
+) {
+    std::vector<cv::DMatch> matches;
+    if (descriptors1.empty() || descriptors2.empty()) return matches;
+
+    // descriptors2 queries the (cached) index over descriptors1
+    const std::vector<cv::DMatch> reverse = inner_->matchDescriptors(descriptors2, descriptors1);
+
+    // Transpose: keep, per descriptors1 row, the closest descriptors2 row that chose it
+    std::vector<int> bestTrain(descriptors1.rows, -1);
+    std::vector<float> bestDist(descriptors1.rows, 0.0f);
+    for (const auto& m : reverse) {
+        const int q = m.trainIdx;
+        const int t = m.queryIdx;
+        if (q < 0 || q >= descriptors1.rows) continue;
+        if (bestTrain[q] < 0 || m.distance < bestDist[q] ||
+            (m.distance == bestDist[q] && t < bestTrain[q])) {
+            bestTrain[q] = t;
+            bestDist[q] = m.distance;
+        }
+    }
+
+    matches.reserve(reverse.size());
+    for (int q = 0; q < descriptors1.rows; ++q) {
+        if (bestTrain[q] >= 0) matches.emplace_back(q, bestTrain[q], bestDist[q]);
+    }
+    return matches;
+}
+
+double ReverseIndexMatching::calculatePrecision(
+    const std::vector<cv::DMatch>& matches,
+    const std::vector<cv::KeyPoint>& keypoints2,
+    const std::vector<cv::Point2f>& projectedPoints,
+    double matchThreshold
+) {
+    return inner_->calculatePrecision(matches, keypoints2, projectedPoints, matchThreshold);
+}
+
+double ReverseIndexMatching::adjustMatchThreshold(
+    double baseThreshold,
+    double scaleFactor
+) {
+    return inner_->adjustMatchThreshold(baseThreshold, scaleFactor);
+}
+
+} // namespace thesis_project::matching
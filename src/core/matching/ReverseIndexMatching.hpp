@@ -0,0 +1,63 @@
+#pragma once
+
+#include "MatchingStrategy.hpp"
+
+namespace thesis_project::matching {
+
+/**
+ * @brief Serves image1-vs-N matching from one index over descriptors1
+ *
+ * Index-based matchers build their index over the train side. In
+ * image 1 vs 2..6 evaluation the train side changes on every pair while
+ * descriptors1 stays the same. This decorator therefore runs the wrapped
+ * matcher in the reverse direction: descriptors2 rows query an index over
+ * descriptors1. That index is built once per scene and then hit in the
+ * wrapped matcher's cache.
+ *
+ * Results are transposed back to queryIdx = descriptors1 row. Each
+ * descriptors1 row keeps the closest descriptors2 row that selected it, so
+ * there is at most one match per query row. Every mutual nearest-neighbour
+ * pair survives, so this is a superset of cross-checked matching that needs
+ * no index over descriptors2. The wrapped matcher should be created without
+ * cross-check, because its own backward pass would index descriptors2 again.
+ */
+class ReverseIndexMatching : public MatchingStrategy {
+public:
+    explicit ReverseIndexMatching(MatchingStrategyPtr inner);
+
+    std::vector<cv::DMatch> matchDescriptors(
+        const cv::Mat& descriptors1,
+        const cv::Mat& descriptors2
+    ) override;
+
+    double calculatePrecision(
+        const std::vector<cv::DMatch>& matches,
+        const std::vector<cv::KeyPoint>& keypoints2,
+        const std::vector<cv::Point2f>& projectedPoints,
+        double matchThreshold
+    ) override;
+
+    double adjustMatchThreshold(
+        double baseThreshold,
+        double scaleFactor
+    ) override;
+
+    std::string getName() const override {
+        return inner_->getName() + "+ReverseIndex";
+    }
+
+    bool supportsRatioTest() const override {
+        return false;
+    }
+
+    bool isApproximate() const override {
+        return true;
+    }
+
+    const MatchingStrategy& inner() const { return *inner_; }
+
+private:
+    MatchingStrategyPtr inner_;
+};
+
+} // namespace thesis_project::matching
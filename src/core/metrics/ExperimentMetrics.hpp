@@ -1,6 +1,11 @@
 #ifndef CORE_METRICS_EXPERIMENT_METRICS_HPP
 #define CORE_METRICS_EXPERIMENT_METRICS_HPP
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <random>
 #include <string>
 #include <vector>
 #include <map>
@@ -13,6 +18,55 @@
  * previously scattered throughout the image processing pipeline.
  */
 struct ExperimentMetrics {
+    /**
+     * @brief Running AP sum and query count for one scene
+     */
+    struct SceneAP {
+        double ap_sum = 0.0;
+        int queries = 0;   // queries with a potential match (R>0)
+        int ranked = 0;    // queries with a valid rank (P@1 denominator)
+        int hits_at_1 = 0;
+
+        double mean() const { return queries > 0 ? ap_sum / static_cast<double>(queries) : 0.0; }
+    };
+
+    /**
+     * @brief Exact counts of 1-based true-match ranks up to kCap, one overflow bucket above
+     *
+     * Fixed size, so P@K for any K <= kCap is exact and memory does not grow
+     * with the number of queries.
+     */
+    struct RankHistogram {
+        static constexpr int kCap = 100;
+        std::array<long, kCap + 1> counts{};  // counts[r] for r in [1, kCap]; counts[0] unused
+        long overflow = 0;                    // ranks > kCap
+        long missing = 0;                     // no rank (R=0 queries)
+
+        void add(int rank) {
+            if (rank <= 0) ++missing;
+            else if (rank > kCap) ++overflow;
+            else ++counts[rank];
+        }
+
+        void merge(const RankHistogram& other) {
+            for (int r = 1; r <= kCap; ++r) counts[r] += other.counts[r];
+            overflow += other.overflow;
+            missing += other.missing;
+        }
+
+        long ranked() const {
+            long n = overflow;
+            for (int r = 1; r <= kCap; ++r) n += counts[r];
+            return n;
+        }
+
+        long atMost(int k) const {
+            long n = 0;
+            for (int r = 1; r <= k && r <= kCap; ++r) n += counts[r];
+            return n;
+        }
+    };
+
     // Per-image precision values
     std::vector<double> precisions_per_image;
     
@@ -43,15 +97,26 @@ struct ExperimentMetrics {
     std::map<std::string, int> per_scene_keypoints;
     std::map<std::string, int> per_scene_image_count; // Track number of images per scene
     
-    // True IR-style mAP storage
-    std::vector<double> ap_per_query;                               // All query APs (micro mAP calculation)
-    std::map<std::string, std::vector<double>> per_scene_ap;        // Per-scene AP values (macro mAP calculation)
+    // True IR-style mAP: running sums only, so memory is independent of the query count
+    double ap_sum = 0.0;                                           // Sum of query APs (micro mAP calculation)
+    std::map<std::string, SceneAP> per_scene_ap;                   // Per-scene AP sums (macro mAP calculation)
     std::map<std::string, int> per_scene_excluded;                 // Count R=0 queries per scene
     int total_queries_processed = 0;                               // Total queries with potential matches
     int total_queries_excluded = 0;                                // Queries excluded (R=0)
     
-    // Rank data for Precision@K/Recall@K calculation
-    std::vector<int> ranks_per_query;                              // Rank of true match for each query (1-based, -1 if R=0)
+    // Rank histogram for Precision@K/Recall@K calculation
+    RankHistogram rank_histogram;
+
+    // Scene-level bootstrap confidence intervals (filled by computeBootstrapCI)
+    struct ConfidenceInterval {
+        double lower = 0.0;
+        double upper = 0.0;
+    };
+    int bootstrap_resamples = 0;                                   // 0 = not computed
+    double bootstrap_confidence = 0.0;
+    ConfidenceInterval true_map_micro_ci;
+    ConfidenceInterval true_map_macro_ci;
+    ConfidenceInterval precision_at_1_ci;
     
     // Processing metadata
     double processing_time_ms = 0.0;
@@ -118,14 +183,10 @@ struct ExperimentMetrics {
             legacy_macro_precision_by_scene = mean_precision; // fallback if no scene breakdown
         }
         
-        // Calculate true IR-style mAP metrics
-        if (!ap_per_query.empty()) {
+        // Calculate true IR-style mAP metrics (O(1) per scene from the running sums)
+        if (total_queries_processed > 0) {
             // Micro mAP: average over all queries
-            double ap_sum = 0.0;
-            for (double ap : ap_per_query) {
-                ap_sum += ap;
-            }
-            true_map_micro = ap_sum / static_cast<double>(ap_per_query.size());
+            true_map_micro = ap_sum / static_cast<double>(total_queries_processed);
         }
         
         if (!per_scene_ap.empty()) {
@@ -134,15 +195,8 @@ struct ExperimentMetrics {
             int scene_count = 0;
             
             for (const auto& kv : per_scene_ap) {
-                const auto& scene_aps = kv.second;
-                if (scene_aps.empty()) continue;
-                
-                double scene_ap_sum = 0.0;
-                for (double ap : scene_aps) {
-                    scene_ap_sum += ap;
-                }
-                double scene_map = scene_ap_sum / static_cast<double>(scene_aps.size());
-                scene_map_sum += scene_map;
+                if (kv.second.queries == 0) continue;
+                scene_map_sum += kv.second.mean();
                 scene_count++;
             }
             
@@ -157,7 +211,6 @@ struct ExperimentMetrics {
         const int total_all_queries = total_queries_processed + total_queries_excluded;
         if (total_all_queries > 0) {
             // Micro including zeros: sum of APs / total queries (including R=0)
-            double ap_sum = std::accumulate(ap_per_query.begin(), ap_per_query.end(), 0.0);
             true_map_micro_including_zeros = ap_sum / static_cast<double>(total_all_queries);
         }
         
@@ -166,15 +219,13 @@ struct ExperimentMetrics {
             double sum_scene_all = 0.0;
             int scene_cnt_all = 0;
             
-            for (const auto& [scene, aps] : per_scene_ap) {
+            for (const auto& [scene, stats] : per_scene_ap) {
                 int excluded_count = per_scene_excluded.count(scene) ? per_scene_excluded.at(scene) : 0;
-                int total_scene_queries = static_cast<int>(aps.size()) + excluded_count;
+                int total_scene_queries = stats.queries + excluded_count;
                 
                 if (total_scene_queries == 0) continue; // Empty scene
                 
-                double scene_ap_sum = std::accumulate(aps.begin(), aps.end(), 0.0);
-                double scene_map = scene_ap_sum / static_cast<double>(total_scene_queries);
-                sum_scene_all += scene_map;
+                sum_scene_all += stats.ap_sum / static_cast<double>(total_scene_queries);
                 scene_cnt_all++;
             }
             
@@ -185,39 +236,22 @@ struct ExperimentMetrics {
             true_map_macro_by_scene_including_zeros = true_map_micro_including_zeros; // fallback
         }
         
-        // Calculate Precision@K and Recall@K from rank data
-        if (!ranks_per_query.empty()) {
-            int queries_with_ranks = 0;
-            int hits_at_1 = 0, hits_at_5 = 0, hits_at_10 = 0;
-            
-            // DEBUG: Count rank distribution
-            std::map<int, int> rank_histogram;
-            
-            for (int rank : ranks_per_query) {
-                if (rank > 0) { // Valid rank (not R=0)
-                    queries_with_ranks++;
-                    rank_histogram[rank]++;
-                    if (rank <= 1) hits_at_1++;
-                    if (rank <= 5) hits_at_5++;
-                    if (rank <= 10) hits_at_10++;
-                } else {
-                    rank_histogram[-1]++; // R=0 queries
-                }
-            }
-            
+        // Calculate Precision@K and Recall@K from the rank histogram
+        const long queries_with_ranks = rank_histogram.ranked();
+        if (queries_with_ranks + rank_histogram.missing > 0) {
             // DEBUG: Print rank distribution for first few ranks
-            std::cout << "[DEBUG] Rank distribution - Total queries: " << ranks_per_query.size() 
+            std::cout << "[DEBUG] Rank distribution - Total queries: " << (queries_with_ranks + rank_histogram.missing)
                       << ", Valid ranks: " << queries_with_ranks << std::endl;
             std::cout << "[DEBUG] Ranks 1-10: ";
             for (int r = 1; r <= 10; r++) {
-                std::cout << "R" << r << ":" << rank_histogram[r] << " ";
+                std::cout << "R" << r << ":" << rank_histogram.counts[r] << " ";
             }
-            std::cout << " R=0:" << rank_histogram[-1] << std::endl;
+            std::cout << " R=0:" << rank_histogram.missing << std::endl;
             
             if (queries_with_ranks > 0) {
-                precision_at_1 = static_cast<double>(hits_at_1) / static_cast<double>(queries_with_ranks);
-                precision_at_5 = static_cast<double>(hits_at_5) / static_cast<double>(queries_with_ranks);
-                precision_at_10 = static_cast<double>(hits_at_10) / static_cast<double>(queries_with_ranks);
+                precision_at_1 = static_cast<double>(rank_histogram.atMost(1)) / static_cast<double>(queries_with_ranks);
+                precision_at_5 = static_cast<double>(rank_histogram.atMost(5)) / static_cast<double>(queries_with_ranks);
+                precision_at_10 = static_cast<double>(rank_histogram.atMost(10)) / static_cast<double>(queries_with_ranks);
                 
                 // For R=1 (single ground truth), Precision@K = Recall@K
                 recall_at_1 = precision_at_1;
@@ -230,6 +264,79 @@ struct ExperimentMetrics {
         }
     }
     
+    /**
+     * @brief Scene-level bootstrap confidence intervals for true mAP and P@1
+     *
+     * Scenes (not queries) are resampled with replacement, because queries
+     * within a scene are correlated through the shared images. Each resample
+     * recomputes micro mAP, macro mAP and P@1 from the per-scene running
+     * sums, and the percentile interval at `confidence` is stored.
+     *
+     * Resamples are processed in fixed blocks across threads. Each block
+     * draws from its own RNG stream seeded by (seed, block), so the
+     * intervals do not depend on the thread count.
+     */
+    void computeBootstrapCI(int resamples, double confidence = 0.95, uint64_t seed = 42) {
+        bootstrap_resamples = 0;
+        bootstrap_confidence = confidence;
+        true_map_micro_ci = {};
+        true_map_macro_ci = {};
+        precision_at_1_ci = {};
+
+        std::vector<SceneAP> scenes;
+        for (const auto& kv : per_scene_ap) {
+            if (kv.second.queries > 0) scenes.push_back(kv.second);
+        }
+        if (resamples <= 0 || scenes.empty()) return;
+
+        const int scene_count = static_cast<int>(scenes.size());
+        std::vector<double> micro(resamples), macro(resamples), p_at_1(resamples);
+        constexpr int kBlock = 64;
+        const int blocks = (resamples + kBlock - 1) / kBlock;
+
+        cv::parallel_for_(cv::Range(0, blocks), [&](const cv::Range& range) {
+            for (int b = range.start; b < range.end; ++b) {
+                std::seed_seq seq{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32),
+                                  static_cast<uint32_t>(b)};
+                std::mt19937_64 rng(seq);
+                std::uniform_int_distribution<int> pick(0, scene_count - 1);
+
+                const int end = std::min(resamples, (b + 1) * kBlock);
+                for (int r = b * kBlock; r < end; ++r) {
+                    double ap_sum = 0.0, scene_map_sum = 0.0;
+                    long queries = 0, ranked = 0, hits = 0;
+                    for (int i = 0; i < scene_count; ++i) {
+                        const SceneAP& s = scenes[pick(rng)];
+                        ap_sum += s.ap_sum;
+                        queries += s.queries;
+                        scene_map_sum += s.mean();
+                        ranked += s.ranked;
+                        hits += s.hits_at_1;
+                    }
+                    micro[r] = ap_sum / static_cast<double>(queries);
+                    macro[r] = scene_map_sum / static_cast<double>(scene_count);
+                    p_at_1[r] = ranked > 0 ? static_cast<double>(hits) / static_cast<double>(ranked) : 0.0;
+                }
+            }
+        });
+
+        const double alpha = (1.0 - confidence) / 2.0;
+        auto interval = [alpha](std::vector<double>& v) {
+            std::sort(v.begin(), v.end());
+            auto quantile = [&v](double q) {
+                const double pos = q * static_cast<double>(v.size() - 1);
+                const size_t lo = static_cast<size_t>(pos);
+                const size_t hi = std::min(lo + 1, v.size() - 1);
+                return v[lo] + (pos - static_cast<double>(lo)) * (v[hi] - v[lo]);
+            };
+            return ConfidenceInterval{quantile(alpha), quantile(1.0 - alpha)};
+        };
+        true_map_micro_ci = interval(micro);
+        true_map_macro_ci = interval(macro);
+        precision_at_1_ci = interval(p_at_1);
+        bootstrap_resamples = resamples;
+    }
+
     /**
      * @brief Add precision result for a specific image and scene
      */
@@ -262,14 +369,20 @@ struct ExperimentMetrics {
      */
     void addQueryAP(const std::string& scene_name, const TrueAveragePrecision::QueryAPResult& ap_result) {
         if (ap_result.has_potential_match) {
-            ap_per_query.push_back(ap_result.ap);
-            per_scene_ap[scene_name].push_back(ap_result.ap);
-            ranks_per_query.push_back(ap_result.rank_of_true_match);  // Store rank for P@K/R@K
+            ap_sum += ap_result.ap;
+            SceneAP& scene = per_scene_ap[scene_name];
+            scene.ap_sum += ap_result.ap;
+            scene.queries++;
+            if (ap_result.rank_of_true_match > 0) {
+                scene.ranked++;
+                if (ap_result.rank_of_true_match == 1) scene.hits_at_1++;
+            }
+            rank_histogram.add(ap_result.rank_of_true_match);  // Rank for P@K/R@K
             total_queries_processed++;
         } else {
             total_queries_excluded++;
             per_scene_excluded[scene_name]++; // Track R=0 queries per scene
-            ranks_per_query.push_back(-1);    // R=0 query (no rank)
+            rank_histogram.add(-1);           // R=0 query (no rank)
         }
     }
 
@@ -320,19 +433,14 @@ struct ExperimentMetrics {
                                            static_cast<int>(precisions.size())); // fallback to precision count
         }
         
-        // Merge true mAP AP values
-        ap_per_query.insert(
-            ap_per_query.end(),
-            other.ap_per_query.begin(),
-            other.ap_per_query.end()
-        );
-        
+        // Merge true mAP running sums
+        ap_sum += other.ap_sum;
         for (const auto& kv : other.per_scene_ap) {
-            const auto& scene = kv.first;
-            const auto& aps = kv.second;
-            
-            auto& dst_aps = per_scene_ap[scene];
-            dst_aps.insert(dst_aps.end(), aps.begin(), aps.end());
+            auto& dst = per_scene_ap[kv.first];
+            dst.ap_sum += kv.second.ap_sum;
+            dst.queries += kv.second.queries;
+            dst.ranked += kv.second.ranked;
+            dst.hits_at_1 += kv.second.hits_at_1;
         }
         
         // Merge per-scene excluded counts (R=0 queries)
@@ -340,12 +448,8 @@ struct ExperimentMetrics {
             per_scene_excluded[kv.first] += kv.second;
         }
         
-        // Merge ranks per query (critical for P@K/R@K calculation)
-        ranks_per_query.insert(
-            ranks_per_query.end(),
-            other.ranks_per_query.begin(),
-            other.ranks_per_query.end()
-        );
+        // Merge rank histograms (critical for P@K/R@K calculation)
+        rank_histogram.merge(other.rank_histogram);
     }
 
     /**
@@ -0,0 +1,245 @@
+#include "HPatchesTasks.hpp"
+#include "TrueAveragePrecision.hpp"
+#include "src/core/matching/DistanceKernels.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+namespace HPatchesTasks {
+
+namespace kernels = thesis_project::matching::kernels;
+
+ScoreHistogram::ScoreHistogram(double max_score, int bins)
+    : scale_(max_score > 0.0 ? std::max(1, bins) / max_score : 0.0),
+      pos_(std::max(1, bins), 0), neg_(std::max(1, bins), 0) {}
+
+int ScoreHistogram::bin(double score) const {
+    const double b = score * scale_;
+    if (!(b > 0.0)) return 0;
+    return static_cast<int>(std::min<double>(b, static_cast<double>(pos_.size() - 1)));
+}
+
+void ScoreHistogram::add(double score, bool positive) {
+    if (positive) {
+        pos_[bin(score)]++;
+        positives_++;
+    } else {
+        neg_[bin(score)]++;
+        negatives_++;
+    }
+}
+
+void ScoreHistogram::merge(const ScoreHistogram& other) {
+    if (other.pos_.size() != pos_.size() || other.scale_ != scale_) {
+        throw std::invalid_argument("ScoreHistogram: cannot merge histograms with different bins");
+    }
+    for (size_t b = 0; b < pos_.size(); ++b) {
+        pos_[b] += other.pos_[b];
+        neg_[b] += other.neg_[b];
+    }
+    positives_ += other.positives_;
+    negatives_ += other.negatives_;
+}
+
+double ScoreHistogram::averagePrecision() const {
+    if (positives_ == 0) return 0.0;
+    long tp = 0, fp = 0;
+    double ap = 0.0;
+    for (size_t b = 0; b < pos_.size(); ++b) {
+        tp += pos_[b];
+        fp += neg_[b];
+        if (pos_[b] > 0) ap += static_cast<double>(pos_[b]) * tp / static_cast<double>(tp + fp);
+    }
+    return ap / static_cast<double>(positives_);
+}
+
+double ScoreHistogram::rocAuc() const {
+    if (positives_ == 0 || negatives_ == 0) return 0.0;
+    long negatives_above = negatives_;
+    double auc = 0.0;
+    for (size_t b = 0; b < pos_.size(); ++b) {
+        negatives_above -= neg_[b];
+        auc += static_cast<double>(pos_[b]) * (static_cast<double>(negatives_above) + 0.5 * neg_[b]);
+    }
+    return auc / (static_cast<double>(positives_) * static_cast<double>(negatives_));
+}
+
+double ScoreHistogram::fprAtRecall(double recall) const {
+    if (positives_ == 0 || negatives_ == 0) return 0.0;
+    const double target = recall * static_cast<double>(positives_);
+    long tp = 0, fp = 0;
+    for (size_t b = 0; b < pos_.size(); ++b) {
+        tp += pos_[b];
+        fp += neg_[b];
+        if (static_cast<double>(tp) >= target) break;
+    }
+    return static_cast<double>(fp) / static_cast<double>(negatives_);
+}
+
+Evaluator::Evaluator(int normType) : normType_(normType) {
+    if (normType_ != cv::NORM_L2SQR && normType_ != cv::NORM_L2 && normType_ != cv::NORM_L1 &&
+        normType_ != cv::NORM_HAMMING) {
+        throw std::invalid_argument("HPatchesTasks: unsupported norm type " + std::to_string(normType_));
+    }
+    pos_begin_.push_back(0);
+}
+
+void Evaluator::addTrack(const std::string& scene, const cv::Mat& reference, const std::vector<cv::Mat>& positives) {
+    auto checkRow = [this](const cv::Mat& row) {
+        if (row.rows != 1) throw std::invalid_argument("HPatchesTasks: tracks take one descriptor row each");
+        if (!refs_.empty() && (row.cols != refs_.cols || row.type() != refs_.type())) {
+            throw std::invalid_argument("HPatchesTasks: descriptor width/type differs from earlier tracks");
+        }
+    };
+    checkRow(reference);
+    for (const auto& p : positives) checkRow(p);
+    if (positives.empty()) return;
+
+    auto it = scene_ids_.find(scene);
+    if (it == scene_ids_.end()) {
+        it = scene_ids_.emplace(scene, static_cast<int>(scene_names_.size())).first;
+        scene_names_.push_back(scene);
+        scene_tracks_.emplace_back();
+    }
+    const int scene_id = it->second;
+    const int track = static_cast<int>(track_scene_.size());
+
+    refs_.push_back(reference);
+    for (size_t j = 0; j < positives.size(); ++j) {
+        pool_.push_back(positives[j]);
+        pool_image_.push_back(static_cast<int>(j));
+    }
+    track_scene_.push_back(scene_id);
+    pos_begin_.push_back(pool_.rows);
+    scene_tracks_[scene_id].push_back(track);
+}
+
+cv::Mat Evaluator::widened(const cv::Mat& m) const {
+    if (normType_ == cv::NORM_HAMMING || m.depth() == CV_32F) return m;
+    return kernels::toFloat(m);
+}
+
+double Evaluator::distance(const cv::Mat& a, int ra, const cv::Mat& b, int rb) const {
+    if (normType_ == cv::NORM_HAMMING) {
+        return cv::hal::normHamming(a.ptr<uchar>(ra), b.ptr<uchar>(rb), a.cols);
+    }
+    const float* pa = a.ptr<float>(ra);
+    const float* pb = b.ptr<float>(rb);
+    if (normType_ == cv::NORM_L1) return kernels::l1Distance(pa, pb, a.cols);
+    const double d2 = kernels::l2SquaredDistance(pa, pb, a.cols);
+    return normType_ == cv::NORM_L2 ? std::sqrt(d2) : d2;
+}
+
+VerificationResult Evaluator::evaluateVerification(uint64_t seed, int bins) const {
+    VerificationResult result;
+    if (track_scene_.empty()) return result;
+
+    // Pair list first (cheap, sequential, seeded) so scoring can run in parallel
+    enum Kind : uchar { POSITIVE, INTRA, INTER };
+    struct Pair { int track; int row; Kind kind; };
+    std::vector<Pair> pairs;
+    pairs.reserve(static_cast<size_t>(pool_.rows) * 3);
+
+    std::seed_seq seq{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)};
+    std::mt19937_64 rng(seq);
+    const int tracks = static_cast<int>(track_scene_.size());
+    auto rowFor = [this](int track, int slot) {
+        const int count = pos_begin_[track + 1] - pos_begin_[track];
+        return pos_begin_[track] + std::min(slot, count - 1);
+    };
+
+    for (int t = 0; t < tracks; ++t) {
+        const auto& same_scene = scene_tracks_[track_scene_[t]];
+        for (int row = pos_begin_[t]; row < pos_begin_[t + 1]; ++row) {
+            const int slot = pool_image_[row];
+            pairs.push_back({t, row, POSITIVE});
+            if (same_scene.size() > 1) {
+                int u = t;
+                while (u == t) u = same_scene[std::uniform_int_distribution<size_t>(0, same_scene.size() - 1)(rng)];
+                pairs.push_back({t, rowFor(u, slot), INTRA});
+            }
+            if (scene_names_.size() > 1) {
+                int u = t;
+                while (track_scene_[u] == track_scene_[t]) u = std::uniform_int_distribution<int>(0, tracks - 1)(rng);
+                pairs.push_back({t, rowFor(u, slot), INTER});
+            }
+        }
+    }
+
+    const cv::Mat refs = widened(refs_);
+    const cv::Mat pool = widened(pool_);
+    std::vector<float> scores(pairs.size());
+    cv::parallel_for_(cv::Range(0, static_cast<int>(pairs.size())), [&](const cv::Range& range) {
+        for (int i = range.start; i < range.end; ++i) {
+            scores[i] = static_cast<float>(distance(refs, pairs[i].track, pool, pairs[i].row));
+        }
+    });
+
+    const double max_score = scores.empty() ? 0.0 : *std::max_element(scores.begin(), scores.end());
+    ScoreHistogram intra(max_score, bins), inter(max_score, bins), all(max_score, bins);
+    for (size_t i = 0; i < pairs.size(); ++i) {
+        switch (pairs[i].kind) {
+            case POSITIVE:
+                intra.add(scores[i], true);
+                inter.add(scores[i], true);
+                all.add(scores[i], true);
+                break;
+            case INTRA:
+                intra.add(scores[i], false);
+                all.add(scores[i], false);
+                break;
+            case INTER:
+                inter.add(scores[i], false);
+                all.add(scores[i], false);
+                break;
+        }
+    }
+
+    result.ap_intra = intra.negatives() > 0 ? intra.averagePrecision() : 0.0;
+    result.ap_inter = inter.negatives() > 0 ? inter.averagePrecision() : 0.0;
+    result.roc_auc = all.rocAuc();
+    result.fpr95 = all.fprAtRecall(0.95);
+    result.positive_pairs = all.positives();
+    result.negative_pairs = all.negatives();
+    return result;
+}
+
+RetrievalResult Evaluator::evaluateRetrieval(int top_k, const thesis_project::matching::HnswParams* ann) const {
+    RetrievalResult result;
+    if (top_k <= 0) throw std::invalid_argument("HPatchesTasks: retrieval needs top_k > 0");
+    if (track_scene_.empty()) return result;
+
+    const cv::Mat refs = widened(refs_);
+    const cv::Mat pool = widened(pool_);
+    const int k = std::min(top_k, pool.rows);
+    result.top_k = k;
+    result.pool_size = pool.rows;
+    result.approximate = ann != nullptr;
+
+    std::vector<int> idx;
+    if (ann) {
+        // The graph ranks by L2 (monotone in squared L2)
+        thesis_project::matching::HnswIndex index(normType_ == cv::NORM_L2SQR ? cv::NORM_L2 : normType_, *ann);
+        index.build(pool);
+        std::vector<float> dist;
+        index.search(refs, k, idx, dist);
+    } else {
+        kernels::TopK top;
+        kernels::topKNeighbours(refs, pool, normType_, k, {}, top);
+        idx = std::move(top.idx);
+    }
+
+    double ap_sum = 0.0;
+    std::vector<int> relevant;
+    for (int t = 0; t < refs.rows; ++t) {
+        relevant.clear();
+        for (int row = pos_begin_[t]; row < pos_begin_[t + 1]; ++row) relevant.push_back(row);
+        ap_sum += TrueAveragePrecision::computeQueryAPFromTopK(idx.data() + static_cast<size_t>(t) * k, k, relevant).ap;
+    }
+    result.queries = refs.rows;
+    result.map = ap_sum / static_cast<double>(refs.rows);
+    return result;
+}
+
+} // namespace HPatchesTasks
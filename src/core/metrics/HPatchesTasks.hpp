@@ -0,0 +1,127 @@
+#ifndef CORE_METRICS_HPATCHES_TASKS_HPP
+#define CORE_METRICS_HPATCHES_TASKS_HPP
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <opencv2/core.hpp>
+#include "src/core/matching/HnswIndex.hpp"
+
+/**
+ * @brief HPatches-style verification and retrieval tasks over keypoint tracks
+ *
+ * A track is one image-1 keypoint (the reference) plus the descriptors of
+ * its homography correspondences in images 2..6. This is the per-keypoint
+ * analogue of an HPatches patch sequence. Tracks are collected during the
+ * matching run and both tasks are evaluated once at the end:
+ *
+ * - Verification: pairs (reference, positive) are scored against intra-scene
+ *   negatives (another track of the same scene, same image) and inter-scene
+ *   negatives (a track of another scene). AP, ROC AUC and FPR@95 come from
+ *   a distance histogram, with no sort over the pairs.
+ * - Retrieval: each reference queries the pool of all non-reference track
+ *   descriptors across scenes (other tracks act as distractors). AP uses the
+ *   K nearest pool rows, from the exact tiled top-K kernel or from an HNSW
+ *   graph.
+ *
+ * Lower distance means more similar throughout.
+ */
+namespace HPatchesTasks {
+
+    /**
+     * @brief Fixed-bin distance histogram for positives and negatives (sort-free ranking metrics)
+     *
+     * Scores above max_score land in the last bin. Pairs that share a bin
+     * count as tied, so the metrics are exact up to the bin width.
+     */
+    class ScoreHistogram {
+    public:
+        explicit ScoreHistogram(double max_score, int bins = 4096);
+
+        void add(double score, bool positive);
+        void merge(const ScoreHistogram& other);
+
+        /** Area under the precision-recall curve (threshold swept upward) */
+        double averagePrecision() const;
+        /** P(positive distance < negative distance), ties counted as one half */
+        double rocAuc() const;
+        /** False positive rate at the first threshold reaching the given recall */
+        double fprAtRecall(double recall = 0.95) const;
+
+        long positives() const { return positives_; }
+        long negatives() const { return negatives_; }
+
+    private:
+        int bin(double score) const;
+
+        double scale_;
+        std::vector<long> pos_;
+        std::vector<long> neg_;
+        long positives_ = 0;
+        long negatives_ = 0;
+    };
+
+    struct VerificationResult {
+        double ap_intra = 0.0;     // positives vs same-scene negatives
+        double ap_inter = 0.0;     // positives vs other-scene negatives
+        double roc_auc = 0.0;      // positives vs all negatives
+        double fpr95 = 0.0;
+        long positive_pairs = 0;
+        long negative_pairs = 0;
+    };
+
+    struct RetrievalResult {
+        double map = 0.0;          // mean AP@K over reference queries
+        long queries = 0;
+        long pool_size = 0;
+        int top_k = 0;
+        bool approximate = false;  // HNSW candidate search
+    };
+
+    class Evaluator {
+    public:
+        /**
+         * @param normType cv::NORM_L2SQR / cv::NORM_L2 / cv::NORM_L1 for real-valued descriptors
+         *                 (any depth, widened to float), cv::NORM_HAMMING for CV_8U bit codes
+         */
+        explicit Evaluator(int normType = cv::NORM_L2SQR);
+
+        /**
+         * @brief Add one track: a single reference row and its correspondences (one row each)
+         * @throws std::invalid_argument on width/type mismatch with earlier tracks
+         */
+        void addTrack(const std::string& scene, const cv::Mat& reference, const std::vector<cv::Mat>& positives);
+
+        size_t tracks() const { return track_scene_.size(); }
+        size_t scenes() const { return scene_names_.size(); }
+
+        /**
+         * @brief One intra and one inter negative per positive pair, drawn with a fixed seed
+         */
+        VerificationResult evaluateVerification(uint64_t seed = 42, int bins = 4096) const;
+
+        /**
+         * @brief AP@K of every reference against the whole positive pool
+         * @param ann HNSW parameters for the candidate search (nullptr = exact top-K)
+         */
+        RetrievalResult evaluateRetrieval(int top_k, const thesis_project::matching::HnswParams* ann = nullptr) const;
+
+    private:
+        cv::Mat widened(const cv::Mat& m) const;
+        double distance(const cv::Mat& a, int ra, const cv::Mat& b, int rb) const;
+
+        int normType_;
+        cv::Mat refs_;                          // one row per track
+        cv::Mat pool_;                          // all positives, grouped by track
+        std::vector<int> track_scene_;          // track -> scene id
+        std::vector<int> pos_begin_;            // track -> first pool row (size tracks + 1)
+        std::vector<int> pool_image_;           // pool row -> correspondence slot (0 = image 2)
+        std::vector<std::vector<int>> scene_tracks_;
+        std::unordered_map<std::string, int> scene_ids_;
+        std::vector<std::string> scene_names_;
+    };
+
+} // namespace HPatchesTasks
+
+#endif // CORE_METRICS_HPATCHES_TASKS_HPP
@@ -0,0 +1,168 @@
+#ifndef CORE_METRICS_METRICS_ACCUMULATOR_HPP
+#define CORE_METRICS_METRICS_ACCUMULATOR_HPP
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ExperimentMetrics.hpp"
+#include "TrueAveragePrecision.hpp"
+
+/**
+ * @brief Per-thread metrics accumulator with running sums and O(scenes) merge
+ *
+ * Each worker owns one accumulator, so adding results needs no locking.
+ * Scene names are interned once to dense ids (sceneId). Per-scene totals
+ * then live in a flat array of running sums and counters, and ranks go
+ * into one fixed-size rank histogram. Nothing is stored per query or per
+ * image, so merge() costs O(scenes) whatever the query count.
+ *
+ * toExperimentMetrics() fills the streaming fields of ExperimentMetrics in
+ * scene-name order and runs calculateMeanPrecision() on them. The result
+ * therefore does not depend on which worker saw a scene first. The counts
+ * (P@K, totals) match exactly. Means match up to floating-point summation
+ * order.
+ */
+class MetricsAccumulator {
+public:
+    struct SceneTotals {
+        // Legacy per-image precision
+        double precision_sum = 0.0;
+        int images = 0;
+        int matches = 0;
+        int keypoints = 0;
+        // True mAP (queries with a potential match) and R=0 exclusions
+        double ap_sum = 0.0;
+        int queries = 0;
+        int excluded = 0;
+        int ranked = 0;
+        int hits_at_1 = 0;
+
+        void add(const SceneTotals& o) {
+            precision_sum += o.precision_sum;
+            images += o.images;
+            matches += o.matches;
+            keypoints += o.keypoints;
+            ap_sum += o.ap_sum;
+            queries += o.queries;
+            excluded += o.excluded;
+            ranked += o.ranked;
+            hits_at_1 += o.hits_at_1;
+        }
+    };
+
+    /**
+     * @brief Dense id for a scene name (interned on first use)
+     */
+    int sceneId(const std::string& scene_name) {
+        auto it = ids_.find(scene_name);
+        if (it != ids_.end()) return it->second;
+        const int id = static_cast<int>(names_.size());
+        ids_.emplace(scene_name, id);
+        names_.push_back(scene_name);
+        scenes_.emplace_back();
+        return id;
+    }
+
+    void addImageResult(int scene, double precision, int matches, int keypoints) {
+        SceneTotals& s = scenes_[scene];
+        s.precision_sum += precision;
+        s.images++;
+        s.matches += matches;
+        s.keypoints += keypoints;
+    }
+
+    void addQueryAP(int scene, const TrueAveragePrecision::QueryAPResult& ap_result) {
+        SceneTotals& s = scenes_[scene];
+        if (!ap_result.has_potential_match) {
+            s.excluded++;
+            ranks_.add(-1);
+            return;
+        }
+        s.ap_sum += ap_result.ap;
+        s.queries++;
+        if (ap_result.rank_of_true_match > 0) {
+            s.ranked++;
+            if (ap_result.rank_of_true_match == 1) s.hits_at_1++;
+        }
+        ranks_.add(ap_result.rank_of_true_match);
+    }
+
+    /**
+     * @brief Fold another accumulator in (scene ids are re-mapped by name)
+     */
+    void merge(const MetricsAccumulator& other) {
+        for (size_t i = 0; i < other.names_.size(); ++i) {
+            scenes_[sceneId(other.names_[i])].add(other.scenes_[i]);
+        }
+        ranks_.merge(other.ranks_);
+    }
+
+    const std::vector<std::string>& sceneNames() const { return names_; }
+    const SceneTotals& scene(int id) const { return scenes_[id]; }
+    bool empty() const { return names_.empty(); }
+
+    /**
+     * @brief Streaming ExperimentMetrics with all summary fields computed
+     *
+     * Per-image precision vectors stay empty. The legacy precision means are
+     * set from the running sums after calculateMeanPrecision().
+     */
+    ExperimentMetrics toExperimentMetrics() const {
+        ExperimentMetrics m;
+        m.success = true;
+
+        std::vector<int> order(names_.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = static_cast<int>(i);
+        std::sort(order.begin(), order.end(), [this](int a, int b) { return names_[a] < names_[b]; });
+
+        double precision_sum = 0.0;
+        double scene_precision_sum = 0.0;
+        int precision_scenes = 0;
+        for (int id : order) {
+            const std::string& name = names_[id];
+            const SceneTotals& s = scenes_[id];
+
+            m.total_matches += s.matches;
+            m.total_keypoints += s.keypoints;
+            m.total_images_processed += s.images;
+            m.total_queries_processed += s.queries;
+            m.total_queries_excluded += s.excluded;
+            m.ap_sum += s.ap_sum;
+
+            if (s.images > 0) {
+                m.per_scene_matches[name] = s.matches;
+                m.per_scene_keypoints[name] = s.keypoints;
+                m.per_scene_image_count[name] = s.images;
+                precision_sum += s.precision_sum;
+                scene_precision_sum += s.precision_sum / static_cast<double>(s.images);
+                precision_scenes++;
+            }
+            if (s.queries > 0) {
+                ExperimentMetrics::SceneAP& scene_ap = m.per_scene_ap[name];
+                scene_ap.ap_sum = s.ap_sum;
+                scene_ap.queries = s.queries;
+                scene_ap.ranked = s.ranked;
+                scene_ap.hits_at_1 = s.hits_at_1;
+            }
+            if (s.excluded > 0) m.per_scene_excluded[name] = s.excluded;
+        }
+        m.rank_histogram = ranks_;
+        m.calculateMeanPrecision();
+
+        if (m.total_images_processed > 0) {
+            m.mean_precision = precision_sum / static_cast<double>(m.total_images_processed);
+        }
+        m.legacy_macro_precision_by_scene = precision_scenes > 0
+            ? scene_precision_sum / static_cast<double>(precision_scenes) : m.mean_precision;
+        return m;
+    }
+
+private:
+    std::unordered_map<std::string, int> ids_;
+    std::vector<std::string> names_;   // id -> scene name
+    std::vector<SceneTotals> scenes_;  // id -> running totals
+    ExperimentMetrics::RankHistogram ranks_;
+};
+
+#endif // CORE_METRICS_METRICS_ACCUMULATOR_HPP
@@ -0,0 +1,119 @@
+#ifndef CORE_METRICS_PRECISION_RECALL_CURVE_HPP
+#define CORE_METRICS_PRECISION_RECALL_CURVE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <queue>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Dataset-level precision-recall curve from per-thread score streams
+ *
+ * Each worker appends (distance, is_relevant) for its queries' nearest
+ * neighbours to its own stream and sorts it once (finish()). merge() then
+ * does a k-way merge of the sorted streams. It sweeps the distance
+ * threshold upward in a single pass, so the run never builds or sorts one
+ * global (score, label) array. Lower distance means a more confident match.
+ */
+namespace PrecisionRecallCurve {
+
+    struct Point {
+        double threshold = 0.0;  // distance at or below which matches are accepted
+        double precision = 0.0;
+        double recall = 0.0;
+    };
+
+    struct Curve {
+        std::vector<Point> points;   // downsampled, ascending threshold
+        double average_precision = 0.0;  // area under the full (not downsampled) curve
+        long positives = 0;          // recall denominator
+        long scored = 0;             // total stream entries merged
+    };
+
+    class Stream {
+    public:
+        void add(double distance, bool relevant) { entries_.emplace_back(distance, relevant); }
+
+        /**
+         * @brief Sort by distance (relevant first within ties); call once before merge
+         */
+        void finish() {
+            std::sort(entries_.begin(), entries_.end(), [](const Entry& a, const Entry& b) {
+                return a.first < b.first || (a.first == b.first && a.second > b.second);
+            });
+        }
+
+        void append(const Stream& other) {
+            entries_.insert(entries_.end(), other.entries_.begin(), other.entries_.end());
+        }
+
+        size_t size() const { return entries_.size(); }
+        bool empty() const { return entries_.empty(); }
+
+    private:
+        using Entry = std::pair<double, bool>;
+        std::vector<Entry> entries_;
+        friend Curve merge(const std::vector<Stream>&, long, int);
+    };
+
+    /**
+     * @brief K-way merge of finished streams into one PR curve
+     * @param positives Number of relevant items the curve's recall is measured against
+     * @param max_points Upper bound on emitted curve points (the last threshold is always kept)
+     */
+    inline Curve merge(const std::vector<Stream>& streams, long positives, int max_points = 100) {
+        Curve curve;
+        curve.positives = positives;
+        for (const auto& s : streams) curve.scored += static_cast<long>(s.entries_.size());
+        if (curve.scored == 0 || positives <= 0) return curve;
+
+        // (distance, relevant, stream, offset); min-heap by distance, relevant first on ties
+        struct Head { double distance; bool relevant; size_t stream; size_t offset; };
+        auto later = [](const Head& a, const Head& b) {
+            return a.distance > b.distance || (a.distance == b.distance && a.relevant < b.relevant);
+        };
+        std::priority_queue<Head, std::vector<Head>, decltype(later)> heap(later);
+        for (size_t s = 0; s < streams.size(); ++s) {
+            if (!streams[s].entries_.empty()) {
+                const auto& e = streams[s].entries_.front();
+                heap.push({e.first, e.second, s, 0});
+            }
+        }
+
+        const long stride = std::max<long>(1, (curve.scored + std::max(1, max_points) - 1) / std::max(1, max_points));
+        long tp = 0, fp = 0, consumed = 0, next_emit = stride;
+        double ap = 0.0;
+        while (!heap.empty()) {
+            const Head h = heap.top();
+            heap.pop();
+            const auto& entries = streams[h.stream].entries_;
+            if (h.offset + 1 < entries.size()) {
+                const auto& e = entries[h.offset + 1];
+                heap.push({e.first, e.second, h.stream, h.offset + 1});
+            }
+
+            if (h.relevant) {
+                ++tp;
+                ap += static_cast<double>(tp) / static_cast<double>(tp + fp);
+            } else {
+                ++fp;
+            }
+            ++consumed;
+
+            // Emit only at threshold boundaries so a point never splits a tie
+            const bool boundary = heap.empty() || heap.top().distance != h.distance;
+            if (boundary && (consumed >= next_emit || heap.empty())) {
+                curve.points.push_back({h.distance,
+                                        static_cast<double>(tp) / static_cast<double>(tp + fp),
+                                        static_cast<double>(tp) / static_cast<double>(positives)});
+                next_emit = consumed + stride;
+            }
+        }
+        curve.average_precision = ap / static_cast<double>(positives);
+        return curve;
+    }
+
+} // namespace PrecisionRecallCurve
+
+#endif // CORE_METRICS_PRECISION_RECALL_CURVE_HPP
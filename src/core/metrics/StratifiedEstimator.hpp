@@ -0,0 +1,129 @@
+#ifndef CORE_METRICS_STRATIFIED_ESTIMATOR_HPP
+#define CORE_METRICS_STRATIFIED_ESTIMATOR_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Stratified-sample mean with standard error (query subsampling)
+ *
+ * Each stratum (a scene) records its population size N_h and the values of
+ * the n_h queries actually evaluated. estimate() returns the weighted mean
+ * sum_h W_h * mean_h with W_h = N_h / N. Its standard error is
+ * sqrt(sum_h W_h^2 * (1 - n_h/N_h) * s_h^2 / n_h), with the finite-population
+ * correction. A stratum with a single sample contributes no variance.
+ * Only running sums are kept per stratum.
+ */
+class StratifiedEstimator {
+public:
+    struct Estimate {
+        double mean = 0.0;
+        double standard_error = 0.0;
+        long sampled = 0;
+        long population = 0;
+    };
+
+    void addPopulation(const std::string& stratum, long count) { strata_[stratum].population += count; }
+
+    void addSample(const std::string& stratum, double value) {
+        Stratum& s = strata_[stratum];
+        s.sum += value;
+        s.sum_sq += value * value;
+        s.sampled++;
+    }
+
+    void merge(const StratifiedEstimator& other) {
+        for (const auto& [name, o] : other.strata_) {
+            Stratum& s = strata_[name];
+            s.population += o.population;
+            s.sampled += o.sampled;
+            s.sum += o.sum;
+            s.sum_sq += o.sum_sq;
+        }
+    }
+
+    /**
+     * @brief Estimate over strata whose name starts with prefix (empty = all)
+     */
+    Estimate estimate(const std::string& prefix = "") const {
+        Estimate e;
+        for (const auto& [name, s] : strata_) {
+            if (name.compare(0, prefix.size(), prefix) != 0 || s.sampled == 0) continue;
+            e.population += s.population;
+            e.sampled += s.sampled;
+        }
+        if (e.population == 0) return e;
+
+        double variance = 0.0;
+        for (const auto& [name, s] : strata_) {
+            if (name.compare(0, prefix.size(), prefix) != 0 || s.sampled == 0) continue;
+            const double w = static_cast<double>(s.population) / static_cast<double>(e.population);
+            const double n = static_cast<double>(s.sampled);
+            const double mean = s.sum / n;
+            e.mean += w * mean;
+            if (s.sampled > 1) {
+                const double s2 = std::max(0.0, (s.sum_sq - n * mean * mean) / (n - 1.0));
+                const double fpc = std::max(0.0, 1.0 - n / static_cast<double>(std::max(s.population, s.sampled)));
+                variance += w * w * fpc * s2 / n;
+            }
+        }
+        e.standard_error = std::sqrt(variance);
+        return e;
+    }
+
+    /**
+     * @brief Sorted sample of ceil(rate * population) indices, capped at max_count (0 = no cap)
+     *
+     * Sampling is without replacement (partial Fisher-Yates) and fully
+     * determined by seed. At least one index is drawn from a non-empty population.
+     */
+    static std::vector<int> sampleIndices(int population, double rate, int max_count, uint64_t seed) {
+        if (population <= 0) return {};
+        int count = static_cast<int>(std::ceil(std::clamp(rate, 0.0, 1.0) * population));
+        if (max_count > 0) count = std::min(count, max_count);
+        count = std::clamp(count, 1, population);
+
+        std::vector<int> indices(population);
+        for (int i = 0; i < population; ++i) indices[i] = i;
+        if (count < population) {
+            std::seed_seq seq{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)};
+            std::mt19937_64 rng(seq);
+            for (int i = 0; i < count; ++i) {
+                std::uniform_int_distribution<int> pick(i, population - 1);
+                std::swap(indices[i], indices[pick(rng)]);
+            }
+            indices.resize(count);
+            std::sort(indices.begin(), indices.end());
+        }
+        return indices;
+    }
+
+    /**
+     * @brief Stable seed for one (scene, image pair) from the run seed (FNV-1a over the scene name)
+     */
+    static uint64_t pairSeed(uint64_t seed, const std::string& stratum, int pair) {
+        uint64_t h = 1469598103934665603ull ^ seed;
+        for (unsigned char c : stratum) {
+            h ^= c;
+            h *= 1099511628211ull;
+        }
+        h ^= static_cast<uint64_t>(pair) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+        return h;
+    }
+
+private:
+    struct Stratum {
+        long population = 0;
+        long sampled = 0;
+        double sum = 0.0;
+        double sum_sq = 0.0;
+    };
+    std::map<std::string, Stratum> strata_;
+};
+
+#endif // CORE_METRICS_STRATIFIED_ESTIMATOR_HPP
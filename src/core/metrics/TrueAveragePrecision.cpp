@@ -2,6 +2,107 @@
 
 namespace TrueAveragePrecision {
 
+namespace {
+
+// Projection of the query into B, or false when it is unusable
+bool projectQuery(const Point2D& queryA, const std::array<double, 9>& H_A_to_B, Point2D& projected) {
+    projected = projectPoint(H_A_to_B, queryA);
+    if (!std::isfinite(projected.x) || !std::isfinite(projected.y)) {
+        return false;
+    }
+    // Early-out for projections far outside reasonable image bounds
+    constexpr double MAX_IMAGE_BOUND = 2000.0;
+    return projected.x >= -MAX_IMAGE_BOUND && projected.x <= MAX_IMAGE_BOUND &&
+           projected.y >= -MAX_IMAGE_BOUND && projected.y <= MAX_IMAGE_BOUND;
+}
+
+} // namespace
+
+KeypointGrid::KeypointGrid(const std::vector<Point2D>& points, double cell_size)
+    : points_(points), cell_(cell_size > 0.0 ? cell_size : 1.0) {
+    double max_x = -std::numeric_limits<double>::infinity();
+    double max_y = -std::numeric_limits<double>::infinity();
+    min_x_ = std::numeric_limits<double>::infinity();
+    min_y_ = std::numeric_limits<double>::infinity();
+    for (const auto& p : points_) {
+        if (!std::isfinite(p.x) || !std::isfinite(p.y)) continue;
+        min_x_ = std::min(min_x_, p.x);
+        min_y_ = std::min(min_y_, p.y);
+        max_x = std::max(max_x, p.x);
+        max_y = std::max(max_y, p.y);
+    }
+    if (!std::isfinite(min_x_)) {
+        min_x_ = min_y_ = 0.0;
+        cols_ = rows_ = 0;
+        cell_start_.assign(1, 0);
+        return;
+    }
+
+    // Coarsen cells so the grid never has many more cells than points
+    const double max_cells = 4.0 * static_cast<double>(points_.size()) + 1024.0;
+    while (((max_x - min_x_) / cell_ + 1.0) * ((max_y - min_y_) / cell_ + 1.0) > max_cells) {
+        cell_ *= 2.0;
+    }
+    cols_ = static_cast<int>((max_x - min_x_) / cell_) + 1;
+    rows_ = static_cast<int>((max_y - min_y_) / cell_) + 1;
+
+    std::vector<int> cell_of(points_.size(), -1);
+    cell_start_.assign(static_cast<size_t>(cols_) * rows_ + 1, 0);
+    for (size_t i = 0; i < points_.size(); ++i) {
+        const auto& p = points_[i];
+        if (!std::isfinite(p.x) || !std::isfinite(p.y)) continue;
+        const int cx = static_cast<int>((p.x - min_x_) / cell_);
+        const int cy = static_cast<int>((p.y - min_y_) / cell_);
+        cell_of[i] = cy * cols_ + cx;
+        cell_start_[cell_of[i] + 1]++;
+    }
+    for (size_t c = 1; c < cell_start_.size(); ++c) cell_start_[c] += cell_start_[c - 1];
+
+    indices_.resize(cell_start_.back());
+    std::vector<int> fill(cell_start_.begin(), cell_start_.end() - 1);
+    for (size_t i = 0; i < points_.size(); ++i) {
+        if (cell_of[i] >= 0) indices_[fill[cell_of[i]]++] = static_cast<int>(i);
+    }
+}
+
+template <typename Visit>
+void KeypointGrid::forEachCandidate(const Point2D& p, double radius, Visit&& visit) const {
+    if (cols_ == 0 || !std::isfinite(p.x) || !std::isfinite(p.y)) return;
+    const int cx0 = static_cast<int>(std::floor((p.x - radius - min_x_) / cell_));
+    const int cx1 = static_cast<int>(std::floor((p.x + radius - min_x_) / cell_));
+    const int cy0 = static_cast<int>(std::floor((p.y - radius - min_y_) / cell_));
+    const int cy1 = static_cast<int>(std::floor((p.y + radius - min_y_) / cell_));
+    for (int cy = std::max(cy0, 0); cy <= std::min(cy1, rows_ - 1); ++cy) {
+        for (int cx = std::max(cx0, 0); cx <= std::min(cx1, cols_ - 1); ++cx) {
+            const int cell = cy * cols_ + cx;
+            for (int k = cell_start_[cell]; k < cell_start_[cell + 1]; ++k) {
+                visit(indices_[k]);
+            }
+        }
+    }
+}
+
+void KeypointGrid::withinRadius(const Point2D& p, double radius, std::vector<int>& out) const {
+    out.clear();
+    forEachCandidate(p, radius, [&](int idx) {
+        if (euclideanDistance(p, points_[idx]) <= radius) out.push_back(idx);
+    });
+    std::sort(out.begin(), out.end());
+}
+
+int KeypointGrid::nearestWithin(const Point2D& p, double radius) const {
+    int best_idx = -1;
+    double best_distance = std::numeric_limits<double>::infinity();
+    forEachCandidate(p, radius, [&](int idx) {
+        const double d = euclideanDistance(p, points_[idx]);
+        if (d < best_distance || (d == best_distance && idx < best_idx)) {
+            best_distance = d;
+            best_idx = idx;
+        }
+    });
+    return best_distance <= radius ? best_idx : -1;
+}
+
 Point2D projectPoint(const std::array<double, 9>& H, const Point2D& p) {
     const double X = H[0] * p.x + H[1] * p.y + H[2];
     const double Y = H[3] * p.x + H[4] * p.y + H[5];
@@ -64,6 +165,26 @@ int findSingleRelevantIndex(const Point2D& queryA,
     return (best_distance <= tau_px) ? best_idx : -1;
 }
 
+int findSingleRelevantIndex(const Point2D& queryA,
+                           const std::array<double, 9>& H_A_to_B,
+                           const KeypointGrid& gridB,
+                           double tau_px) {
+    Point2D projected;
+    if (!projectQuery(queryA, H_A_to_B, projected)) return -1;
+    return gridB.nearestWithin(projected, tau_px);
+}
+
+void findRelevantIndices(const Point2D& queryA,
+                         const std::array<double, 9>& H_A_to_B,
+                         const KeypointGrid& gridB,
+                         double tau_px,
+                         std::vector<int>& relevant) {
+    relevant.clear();
+    Point2D projected;
+    if (!projectQuery(queryA, H_A_to_B, projected)) return;
+    gridB.withinRadius(projected, tau_px, relevant);
+}
+
 double computeAveragePrecision(const std::vector<int>& relevance_ranked) {
     int total_relevant = std::accumulate(relevance_ranked.begin(), relevance_ranked.end(), 0);
     if (total_relevant <= 0) {
@@ -84,16 +205,11 @@ double computeAveragePrecision(const std::vector<int>& relevance_ranked) {
     return ap_sum / static_cast<double>(total_relevant);
 }
 
-QueryAPResult computeQueryAP(const Point2D& queryA,
-                            const std::array<double, 9>& H_A_to_B,
-                            const std::vector<Point2D>& keypointsB,
-                            const std::vector<double>& distances_to_B,
-                            double tau_px) {
+namespace {
+
+QueryAPResult singleRelevantAP(int gt_idx, const std::vector<double>& distances_to_B) {
     QueryAPResult result;
 
-    // Find ground truth relevant keypoint
-    const int gt_idx = findSingleRelevantIndex(queryA, H_A_to_B, keypointsB, tau_px);
-    
     if (gt_idx == -1) {
         // No relevant item found - this query has R=0
         result.ap = 0.0;
@@ -103,9 +219,6 @@ QueryAPResult computeQueryAP(const Point2D& queryA,
         return result;
     }
 
-    result.has_potential_match = true;
-    result.total_relevant = 1; // Single-GT policy
-
     // Optimized O(N) ranking for R=1 case (no full sort needed)
     const double gt_distance = distances_to_B[gt_idx];
     
@@ -123,6 +236,16 @@ QueryAPResult computeQueryAP(const Point2D& queryA,
         }
     }
     
+    return computeQueryAPFromCounts(better_count, tie_count);
+}
+
+} // namespace
+
+QueryAPResult computeQueryAPFromCounts(int better_count, int tie_count) {
+    QueryAPResult result;
+    result.has_potential_match = true;
+    result.total_relevant = 1; // Single-GT policy
+
     // Rank calculation with tie-breaking (use average rank for ties)
     int rank_1_based = 1 + better_count + (tie_count + 1) / 2;
     
@@ -133,6 +256,85 @@ QueryAPResult computeQueryAP(const Point2D& queryA,
     return result;
 }
 
+QueryAPResult computeQueryAPFromTopK(const int* ranked_indices, int k,
+                                     const std::vector<int>& relevant) {
+    QueryAPResult result;
+    if (relevant.empty()) {
+        return result;  // R=0
+    }
+    result.has_potential_match = true;
+    result.total_relevant = static_cast<int>(relevant.size());
+
+    int hits = 0;
+    double ap_sum = 0.0;
+    for (int j = 0; j < k; ++j) {
+        if (ranked_indices[j] < 0 ||
+            !std::binary_search(relevant.begin(), relevant.end(), ranked_indices[j])) continue;
+        ++hits;
+        if (hits == 1) result.rank_of_true_match = j + 1;
+        ap_sum += static_cast<double>(hits) / static_cast<double>(j + 1);
+    }
+    if (hits == 0) result.rank_of_true_match = kRankBeyondTopK;
+    result.ap = ap_sum / static_cast<double>(result.total_relevant);
+    return result;
+}
+
+QueryAPResult computeQueryAP(const Point2D& queryA,
+                            const std::array<double, 9>& H_A_to_B,
+                            const std::vector<Point2D>& keypointsB,
+                            const std::vector<double>& distances_to_B,
+                            double tau_px) {
+    // Find ground truth relevant keypoint
+    return singleRelevantAP(findSingleRelevantIndex(queryA, H_A_to_B, keypointsB, tau_px), distances_to_B);
+}
+
+QueryAPResult computeQueryAP(const Point2D& queryA,
+                            const std::array<double, 9>& H_A_to_B,
+                            const KeypointGrid& gridB,
+                            const std::vector<double>& distances_to_B,
+                            double tau_px) {
+    return singleRelevantAP(findSingleRelevantIndex(queryA, H_A_to_B, gridB, tau_px), distances_to_B);
+}
+
+QueryAPResult computeQueryAPMultiRelevant(const Point2D& queryA,
+                                         const std::array<double, 9>& H_A_to_B,
+                                         const KeypointGrid& gridB,
+                                         const std::vector<double>& distances_to_B,
+                                         double tau_px) {
+    QueryAPResult result;
+    thread_local std::vector<int> relevant;
+    thread_local std::vector<int> candidates;
+    findRelevantIndices(queryA, H_A_to_B, gridB, tau_px, relevant);
+    if (relevant.empty()) {
+        return result;  // R=0
+    }
+
+    result.has_potential_match = true;
+    result.total_relevant = static_cast<int>(relevant.size());
+
+    // Only items no farther than the worst relevant one can precede a relevant hit
+    double worst = 0.0;
+    for (int idx : relevant) worst = std::max(worst, distances_to_B[idx]);
+    candidates.clear();
+    for (int i = 0; i < static_cast<int>(distances_to_B.size()); ++i) {
+        if (distances_to_B[i] <= worst) candidates.push_back(i);
+    }
+    std::sort(candidates.begin(), candidates.end(), [&](int a, int b) {
+        return distances_to_B[a] < distances_to_B[b] || (distances_to_B[a] == distances_to_B[b] && a < b);
+    });
+
+    int hits = 0;
+    double ap_sum = 0.0;
+    for (int k = 0; k < static_cast<int>(candidates.size()) && hits < result.total_relevant; ++k) {
+        if (!std::binary_search(relevant.begin(), relevant.end(), candidates[k])) continue;
+        ++hits;
+        if (hits == 1) result.rank_of_true_match = k + 1;
+        ap_sum += static_cast<double>(hits) / static_cast<double>(k + 1);
+    }
+    result.ap = ap_sum / static_cast<double>(result.total_relevant);
+    return result;
+}
+
 QueryAPResult computeQueryAP(const cv::KeyPoint& queryA,
                             const cv::Mat& H_A_to_B,
                             const std::vector<cv::KeyPoint>& keypointsB,
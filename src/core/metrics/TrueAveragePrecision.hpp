@@ -31,6 +31,14 @@ namespace TrueAveragePrecision {
         Point2D(const cv::KeyPoint& kp) : x(kp.pt.x), y(kp.pt.y) {}
     };
 
+    /**
+     * @brief rank_of_true_match for a query whose relevant items all fall outside a top-K cut-off
+     *
+     * The true rank is unknown but > K, so it lands in the rank histogram's
+     * overflow bucket and never counts as a hit for any P@k / R@k.
+     */
+    constexpr int kRankBeyondTopK = std::numeric_limits<int>::max();
+
     /**
      * @brief Result of AP computation for a single query
      */
@@ -41,6 +49,42 @@ namespace TrueAveragePrecision {
         bool has_potential_match = false; // Whether query had any potential ground truth match
     };
 
+    /**
+     * @brief Uniform grid over keypoints for fixed-radius lookups
+     *
+     * Cells are at least `cell_size` wide, so a lookup with radius <= cell
+     * size scans the 3x3 cells around the point instead of every keypoint.
+     * Points are bucketed once (CSR layout) and the grid is reused for every
+     * query against the same image.
+     */
+    class KeypointGrid {
+    public:
+        KeypointGrid(const std::vector<Point2D>& points, double cell_size);
+
+        /**
+         * @brief Indices of all points within `radius` of p, ascending
+         */
+        void withinRadius(const Point2D& p, double radius, std::vector<int>& out) const;
+
+        /**
+         * @brief Closest point within `radius` of p, or -1 (lowest index wins ties)
+         */
+        int nearestWithin(const Point2D& p, double radius) const;
+
+        size_t size() const { return points_.size(); }
+
+    private:
+        template <typename Visit>
+        void forEachCandidate(const Point2D& p, double radius, Visit&& visit) const;
+
+        std::vector<Point2D> points_;
+        double cell_ = 1.0;
+        double min_x_ = 0.0, min_y_ = 0.0;
+        int cols_ = 0, rows_ = 0;
+        std::vector<int> cell_start_;   // cols_*rows_ + 1 offsets into indices_
+        std::vector<int> indices_;      // point indices grouped by cell
+    };
+
     /**
      * @brief Project point using homography matrix
      * @param H Homography matrix in row-major format [h00,h01,h02, h10,h11,h12, h20,h21,h22]
@@ -73,6 +117,24 @@ namespace TrueAveragePrecision {
                                const std::vector<Point2D>& keypointsB,
                                double tau_px = 3.0);
 
+    /**
+     * @brief Grid-accelerated single-GT lookup (same result as the linear scan)
+     */
+    int findSingleRelevantIndex(const Point2D& queryA,
+                               const std::array<double, 9>& H_A_to_B,
+                               const KeypointGrid& gridB,
+                               double tau_px = 3.0);
+
+    /**
+     * @brief All keypoints in B within tau_px of the projected query (multi-relevant policy)
+     * @param relevant Output indices, ascending; empty when R=0
+     */
+    void findRelevantIndices(const Point2D& queryA,
+                             const std::array<double, 9>& H_A_to_B,
+                             const KeypointGrid& gridB,
+                             double tau_px,
+                             std::vector<int>& relevant);
+
     /**
      * @brief Compute Average Precision from ranked relevance labels
      * 
@@ -106,6 +168,51 @@ namespace TrueAveragePrecision {
                                 const std::vector<double>& distances_to_B,
                                 double tau_px = 3.0);
 
+    /**
+     * @brief Single-GT AP with the relevant keypoint found through a prebuilt grid
+     */
+    QueryAPResult computeQueryAP(const Point2D& queryA,
+                                const std::array<double, 9>& H_A_to_B,
+                                const KeypointGrid& gridB,
+                                const std::vector<double>& distances_to_B,
+                                double tau_px = 3.0);
+
+    /**
+     * @brief AP with every keypoint within tau_px relevant (R >= 1)
+     *
+     * Only candidates no farther than the worst relevant keypoint can
+     * affect AP. They are partitioned out in O(N) and only that prefix is
+     * sorted, by (distance, index). rank_of_true_match is the rank of the
+     * first relevant hit, and total_relevant is R.
+     */
+    QueryAPResult computeQueryAPMultiRelevant(const Point2D& queryA,
+                                             const std::array<double, 9>& H_A_to_B,
+                                             const KeypointGrid& gridB,
+                                             const std::vector<double>& distances_to_B,
+                                             double tau_px = 3.0);
+
+    /**
+     * @brief Single-GT AP from competitor counts (items closer than / tied with the GT)
+     *
+     * Same rank rule as computeQueryAP, for callers that count during a
+     * distance scan instead of keeping the row.
+     */
+    QueryAPResult computeQueryAPFromCounts(int better_count, int tie_count);
+
+    /**
+     * @brief Multi-relevant AP truncated at the K nearest candidates (AP@K)
+     *
+     * @param ranked_indices K candidate indices, nearest first (-1 entries are ignored)
+     * @param relevant Relevant indices, ascending (R = relevant.size())
+     *
+     * Relevant items beyond K contribute nothing, so this is a lower bound
+     * that equals the full AP when all R fall within K. When no relevant
+     * item is in the top K, rank_of_true_match is kRankBeyondTopK, so P@k
+     * stays exact for k <= K and never counts the miss for k > K.
+     */
+    QueryAPResult computeQueryAPFromTopK(const int* ranked_indices, int k,
+                                         const std::vector<int>& relevant);
+
     /**
      * @brief Convenience wrapper using OpenCV types
      */
@@ -221,6 +221,33 @@ const experiment_config& config
     return sum;
 }
 
+namespace {
+
+// Schema v1 weight for scale i: explicit scale_weights, else procedural weighting
+double scaleWeight(const thesis_project::DescriptorParams& params, size_t i) {
+    if (!params.scale_weights.empty()) {
+        return static_cast<double>(params.scale_weights[i]);
+    }
+    const float alpha = params.scales[i];
+    // Procedural weighting
+    switch (params.scale_weighting) {
+        case thesis_project::ScaleWeighting::GAUSSIAN: {
+            double sigma = params.scale_weight_sigma;
+            double x = std::log(alpha);
+            return std::exp(-0.5 * (x*x) / (sigma*sigma));
+        }
+        case thesis_project::ScaleWeighting::TRIANGULAR: {
+            double r = params.scale_weight_sigma; // treat as radius proxy
+            double d = std::abs(std::log(alpha));
+            return std::max(0.0, 1.0 - d / r);
+        }
+        case thesis_project::ScaleWeighting::UNIFORM:
+        default: return 1.0;
+    }
+}
+
+} // namespace
+
 // New-config overload: use descriptor params from YAML new config
 cv::Mat DomainSizePooling::computeDescriptors(
     const cv::Mat& image,
@@ -242,7 +269,6 @@ cv::Mat DomainSizePooling::computeDescriptors(
     // Prepare accumulators
     cv::Mat acc;
     double weight_sum = 0.0;
-    const bool use_weights = !params.scale_weights.empty();
 
     for (size_t i = 0; i < params.scales.size(); ++i) {
         float alpha = params.scales[i];
@@ -267,28 +293,7 @@ cv::Mat DomainSizePooling::computeDescriptors(
         if (params.normalize_before_pooling) normalizeRows(desc, params.norm_type);
 
         // Weight
-        double w = 1.0;
-        if (use_weights) {
-            w = static_cast<double>(params.scale_weights[i]);
-        } else {
-            // Procedural weighting
-            switch (params.scale_weighting) {
-                case thesis_project::ScaleWeighting::GAUSSIAN: {
-                    double sigma = params.scale_weight_sigma;
-                    double x = std::log(alpha);
-                    w = std::exp(-0.5 * (x*x) / (sigma*sigma));
-                    break;
-                }
-                case thesis_project::ScaleWeighting::TRIANGULAR: {
-                    double r = params.scale_weight_sigma; // treat as radius proxy
-                    double d = std::abs(std::log(alpha));
-                    w = std::max(0.0, 1.0 - d / r);
-                    break;
-                }
-                case thesis_project::ScaleWeighting::UNIFORM:
-                default: w = 1.0; break;
-            }
-        }
+        const double w = scaleWeight(params, i);
 
         // Accumulate
         if (acc.empty()) {
@@ -307,4 +312,73 @@ cv::Mat DomainSizePooling::computeDescriptors(
     return acc;
 }
 
+// Batched new-config overload: one extractBatch call per scale covers every image
+std::vector<cv::Mat> DomainSizePooling::computeDescriptorsBatch(
+    const std::vector<cv::Mat>& images,
+    const std::vector<std::vector<cv::KeyPoint>>& keypointSets,
+    thesis_project::IDescriptorExtractor& extractor,
+    const thesis_project::config::ExperimentConfig::DescriptorConfig& descCfg
+) {
+    using namespace thesis_project::pooling::utils;
+    const auto& params = descCfg.params;
+    if (images.size() != keypointSets.size()) {
+        throw std::invalid_argument("computeDescriptorsBatch: images and keypointSets differ in size");
+    }
+    const size_t n = images.size();
+
+    if (params.scales.empty()) {
+        // No scales means act like NoPooling
+        std::vector<cv::Mat> out = extractor.extractBatch(images, keypointSets);
+        if (params.normalize_after_pooling) {
+            for (auto& d : out) normalizeRows(d, params.norm_type);
+        }
+        return out;
+    }
+
+    std::vector<cv::Mat> acc(n);
+    double weight_sum = 0.0;
+
+    for (size_t i = 0; i < params.scales.size(); ++i) {
+        const float alpha = params.scales[i];
+        const bool identity = std::abs(alpha - 1.0f) < 1e-6;
+
+        // Scale every image and its keypoints by alpha
+        std::vector<cv::Mat> scaled_images(n);
+        std::vector<std::vector<cv::KeyPoint>> scaled_kps(n);
+        for (size_t k = 0; k < n; ++k) {
+            if (identity) {
+                scaled_images[k] = images[k];
+            } else {
+                cv::resize(images[k], scaled_images[k], cv::Size(), alpha, alpha, cv::INTER_LINEAR);
+            }
+            scaled_kps[k] = keypointSets[k];
+            for (auto& kp : scaled_kps[k]) {
+                kp.pt.x *= alpha; kp.pt.y *= alpha; kp.size *= alpha;
+            }
+        }
+
+        std::vector<cv::Mat> descs = extractor.extractBatch(scaled_images, scaled_kps);
+        const double w = scaleWeight(params, i);
+
+        for (size_t k = 0; k < n; ++k) {
+            cv::Mat& desc = descs[k];
+            // Normalize before pooling if requested
+            if (params.normalize_before_pooling) normalizeRows(desc, params.norm_type);
+            if (acc[k].empty()) {
+                acc[k] = cv::Mat::zeros(desc.size(), desc.type());
+            }
+            acc[k] += desc * w;
+        }
+        weight_sum += w;
+    }
+
+    for (auto& a : acc) {
+        // Average
+        if (weight_sum > 0.0) a /= weight_sum;
+        // Normalize after pooling if requested
+        if (params.normalize_after_pooling) normalizeRows(a, params.norm_type);
+    }
+    return acc;
+}
+
 } // namespace thesis_project::pooling
@@ -42,6 +42,13 @@ public:
         const thesis_project::config::ExperimentConfig::DescriptorConfig& descCfg
     ) override;
 
+    std::vector<cv::Mat> computeDescriptorsBatch(
+        const std::vector<cv::Mat>& images,
+        const std::vector<std::vector<cv::KeyPoint>>& keypointSets,
+        thesis_project::IDescriptorExtractor& extractor,
+        const thesis_project::config::ExperimentConfig::DescriptorConfig& descCfg
+    ) override;
+
     std::string getName() const override {
         return "DomainSizePooling";
     }
@@ -51,4 +51,13 @@ cv::Mat NoPooling::computeDescriptors(
     return extractor.extract(image, keypoints);
 }
 
+std::vector<cv::Mat> NoPooling::computeDescriptorsBatch(
+    const std::vector<cv::Mat>& images,
+    const std::vector<std::vector<cv::KeyPoint>>& keypointSets,
+    thesis_project::IDescriptorExtractor& extractor,
+    const thesis_project::config::ExperimentConfig::DescriptorConfig& /*descCfg*/
+) {
+    return extractor.extractBatch(images, keypointSets);
+}
+
 } // namespace thesis_project::pooling
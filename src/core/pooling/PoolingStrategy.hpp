@@ -65,6 +65,30 @@ public:
         throw std::runtime_error("PoolingStrategy v1 path not implemented for this strategy");
     }
 
+    /**
+     * @brief Batched Schema v1 path: descriptors for several images in one call
+     *
+     * Default loops over computeDescriptors(); strategies override it to hand
+     * whole batches to IDescriptorExtractor::extractBatch().
+     */
+    virtual std::vector<cv::Mat> computeDescriptorsBatch(
+        const std::vector<cv::Mat>& images,
+        const std::vector<std::vector<cv::KeyPoint>>& keypointSets,
+        thesis_project::IDescriptorExtractor& extractor,
+        const thesis_project::config::ExperimentConfig::DescriptorConfig& descCfg
+    )
+    {
+        if (images.size() != keypointSets.size()) {
+            throw std::invalid_argument("computeDescriptorsBatch: images and keypointSets differ in size");
+        }
+        std::vector<cv::Mat> out;
+        out.reserve(images.size());
+        for (size_t i = 0; i < images.size(); ++i) {
+            out.push_back(computeDescriptors(images[i], keypointSets[i], extractor, descCfg));
+        }
+        return out;
+    }
+
     /**
      * @brief Get human-readable name of the pooling strategy
      * @return std::string Strategy name for logging and identification
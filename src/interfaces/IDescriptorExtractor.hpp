@@ -4,6 +4,7 @@
 #include <opencv2/opencv.hpp>
 #include <vector>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include "thesis_project/types.hpp"
 
@@ -25,6 +26,27 @@ namespace thesis_project {
                                const std::vector<cv::KeyPoint>& keypoints,
                                const DescriptorParams& params = {}) = 0;
 
+        /**
+         * @brief Extract descriptors for several images in one call
+         *
+         * Result i corresponds to images[i] / keypointSets[i]. The default loops
+         * over extract(); wrappers override it to share batches or run images
+         * in parallel.
+         */
+        virtual std::vector<cv::Mat> extractBatch(const std::vector<cv::Mat>& images,
+                                                  const std::vector<std::vector<cv::KeyPoint>>& keypointSets,
+                                                  const DescriptorParams& params = {}) {
+            if (images.size() != keypointSets.size()) {
+                throw std::invalid_argument("extractBatch: images and keypointSets differ in size");
+            }
+            std::vector<cv::Mat> out;
+            out.reserve(images.size());
+            for (size_t i = 0; i < images.size(); ++i) {
+                out.push_back(extract(images[i], keypointSets[i], params));
+            }
+            return out;
+        }
+
         /**
          * @brief Get the descriptor name
          */
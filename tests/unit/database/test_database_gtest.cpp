@@ -1,7 +1,21 @@
 #include <gtest/gtest.h>
+#include <atomic>
 #include <filesystem>
+#include <thread>
 #include "thesis_project/database/DatabaseManager.hpp"
 
+namespace {
+// Keypoints on a 7px grid, ten per row, with strictly decreasing responses
+std::vector<cv::KeyPoint> gridKeypoints(int count) {
+    std::vector<cv::KeyPoint> keypoints;
+    for (int i = 0; i < count; ++i) {
+        keypoints.emplace_back(cv::Point2f(static_cast<float>(i % 10) * 7.0f, static_cast<float>(i / 10) * 7.0f),
+                               3.0f, 0.0f, 1.0f / (1.0f + i), 0, -1);
+    }
+    return keypoints;
+}
+} // namespace
+
 class DatabaseTest : public ::testing::Test {
 protected:
     void SetUp() override {
@@ -204,4 +218,226 @@ TEST_F(DatabaseIntegrationTest, MultipleExperiments) {
     // Verify we can retrieve results
     auto recent_results = db->getRecentResults(10);
     EXPECT_GE(recent_results.size(), 3) << "Should retrieve at least 3 results";
-}
\ No newline at end of file
+}
+// Write-behind queue: writes return once queued, reads and flush() see them committed
+class DatabaseAsyncWriteTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_db_name = "test_gtest_async_writes.db";
+        if (std::filesystem::exists(test_db_name)) {
+            std::filesystem::remove(test_db_name);
+        }
+        config = thesis_project::database::DatabaseConfig::sqlite(test_db_name);
+        config.async_writes = true;
+        config.write_queue_capacity = 4;  // small, so producers hit backpressure
+    }
+
+    void TearDown() override {
+        if (std::filesystem::exists(test_db_name)) {
+            std::filesystem::remove(test_db_name);
+        }
+    }
+
+    std::string test_db_name;
+    thesis_project::database::DatabaseConfig config;
+};
+
+TEST_F(DatabaseAsyncWriteTest, QueuedResultsAreVisibleToReads) {
+    thesis_project::database::DatabaseManager db(config);
+    ASSERT_TRUE(db.isEnabled());
+
+    thesis_project::database::ExperimentConfig exp_config;
+    exp_config.descriptor_type = "SIFT";
+    exp_config.dataset_path = "/test/data";
+    const int exp_id = db.recordConfiguration(exp_config);
+    ASSERT_GT(exp_id, 0);
+
+    for (int i = 0; i < 20; ++i) {
+        thesis_project::database::ExperimentResults results;
+        results.experiment_id = exp_id;
+        results.mean_average_precision = 0.01 * i;
+        EXPECT_TRUE(db.recordExperiment(results));
+    }
+    EXPECT_EQ(db.getRecentResults(100).size(), 20u) << "Reads wait for queued writes";
+    EXPECT_TRUE(db.flush());
+}
+
+TEST_F(DatabaseAsyncWriteTest, QueuedKeypointsAndDescriptorsMatchInput) {
+    thesis_project::database::DatabaseManager db(config);
+    ASSERT_TRUE(db.isEnabled());
+
+    const auto keypoints = gridKeypoints(50);
+    for (int image = 1; image <= 6; ++image) {
+        EXPECT_TRUE(db.storeLockedKeypoints("v_async", std::to_string(image) + ".ppm", keypoints));
+    }
+
+    cv::Mat descriptors(50, 8, CV_32F);
+    for (int r = 0; r < 50; ++r) {
+        for (int c = 0; c < 8; ++c) descriptors.at<float>(r, c) = static_cast<float>(r * 8 + c);
+    }
+    EXPECT_TRUE(db.storeDescriptors(7, "v_async", "1.ppm", keypoints, descriptors, "SIFT"));
+    // The queued write owns a copy, so the caller may reuse its buffer right away
+    for (int r = 0; r < 50; ++r) {
+        for (int c = 0; c < 8; ++c) descriptors.at<float>(r, c) = -1.0f;
+    }
+    ASSERT_TRUE(db.flush());
+
+    for (int image = 1; image <= 6; ++image) {
+        EXPECT_EQ(db.getLockedKeypoints("v_async", std::to_string(image) + ".ppm").size(), keypoints.size());
+    }
+    const cv::Mat stored = db.getDescriptors(7, "v_async", "1.ppm");
+    ASSERT_EQ(stored.rows, 50);
+    ASSERT_EQ(stored.cols, 8);
+    float sum = 0.0f;
+    for (int r = 0; r < 50; ++r) {
+        for (int c = 0; c < 8; ++c) sum += stored.at<float>(r, c);
+    }
+    EXPECT_FLOAT_EQ(sum, 400.0f * 399.0f / 2.0f);
+}
+
+TEST_F(DatabaseAsyncWriteTest, ConcurrentProducersAndShutdownDrainQueue) {
+    {
+        thesis_project::database::DatabaseManager db(config);
+        ASSERT_TRUE(db.isEnabled());
+        std::vector<std::thread> producers;
+        for (int t = 0; t < 4; ++t) {
+            producers.emplace_back([&db, t] {
+                for (int i = 0; i < 25; ++i) {
+                    thesis_project::database::ExperimentResults results;
+                    results.experiment_id = t;
+                    results.total_matches = i;
+                    db.recordExperiment(results);
+                }
+            });
+        }
+        for (auto& producer : producers) producer.join();
+        // No flush: the destructor commits whatever is still queued
+    }
+
+    thesis_project::database::DatabaseManager reopened(test_db_name, true);
+    ASSERT_TRUE(reopened.isEnabled());
+    EXPECT_DOUBLE_EQ(reopened.getStatistics()["total_experiments"], 100.0);
+}
+
+// Concurrent reads: WAL mode with one read-only connection per calling thread
+class DatabaseConcurrentReadTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_db_name = "test_gtest_concurrent_reads.db";
+        removeFiles();
+        config = thesis_project::database::DatabaseConfig::sqlite(test_db_name);
+        config.concurrent_reads = true;
+    }
+
+    void TearDown() override { removeFiles(); }
+
+    void removeFiles() const {
+        for (const char* suffix : {"", "-wal", "-shm"}) {
+            if (std::filesystem::exists(test_db_name + suffix)) {
+                std::filesystem::remove(test_db_name + suffix);
+            }
+        }
+    }
+
+    std::string test_db_name;
+    thesis_project::database::DatabaseConfig config;
+};
+
+TEST_F(DatabaseConcurrentReadTest, ParallelWorkersReadLockedKeypoints) {
+    thesis_project::database::DatabaseManager db(config);
+    ASSERT_TRUE(db.isEnabled());
+
+    // Scene s, image i holds 10 * (s + i) keypoints
+    for (int s = 0; s < 3; ++s) {
+        for (int i = 1; i <= 6; ++i) {
+            ASSERT_TRUE(db.storeLockedKeypoints("scene_" + std::to_string(s), std::to_string(i) + ".ppm",
+                                                gridKeypoints(10 * (s + i))));
+        }
+    }
+
+    std::atomic<int> mismatches{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 6; ++t) {
+        workers.emplace_back([&db, &mismatches] {
+            for (int round = 0; round < 10; ++round) {
+                for (int s = 0; s < 3; ++s) {
+                    for (int i = 1; i <= 6; ++i) {
+                        const auto keypoints = db.getLockedKeypoints("scene_" + std::to_string(s),
+                                                                     std::to_string(i) + ".ppm");
+                        if (keypoints.size() != static_cast<size_t>(10 * (s + i))) mismatches++;
+                    }
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    EXPECT_EQ(mismatches.load(), 0);
+}
+
+TEST_F(DatabaseConcurrentReadTest, CachedQueriesSeeLaterCommits) {
+    thesis_project::database::DatabaseManager db(config);
+    ASSERT_TRUE(db.isEnabled());
+
+    ASSERT_TRUE(db.storeLockedKeypoints("v_reads", "1.ppm", gridKeypoints(20)));
+    EXPECT_EQ(db.getLockedKeypoints("v_reads", "1.ppm").size(), 20u);
+    EXPECT_EQ(db.getAvailableImages("v_reads").size(), 1u);
+
+    // Same cached statements, fresh snapshot on every call
+    ASSERT_TRUE(db.storeLockedKeypoints("v_reads", "2.ppm", gridKeypoints(30)));
+    EXPECT_EQ(db.getLockedKeypoints("v_reads", "2.ppm").size(), 30u);
+    EXPECT_EQ(db.getAvailableImages("v_reads").size(), 2u);
+
+    ASSERT_TRUE(db.clearSceneKeypoints("v_reads"));
+    EXPECT_TRUE(db.getLockedKeypoints("v_reads", "1.ppm").empty());
+    EXPECT_TRUE(db.getAvailableScenes().empty());
+}
+
+TEST_F(DatabaseConcurrentReadTest, InMemoryDatabaseFallsBackToPrimary) {
+    config.connection_string = ":memory:";
+    thesis_project::database::DatabaseManager db(config);
+    ASSERT_TRUE(db.isEnabled());
+
+    ASSERT_TRUE(db.storeLockedKeypoints("v_memory", "1.ppm", gridKeypoints(15)));
+    EXPECT_EQ(db.getLockedKeypoints("v_memory", "1.ppm").size(), 15u);
+}
+
+TEST_F(DatabaseConcurrentReadTest, KeypointSetPreloadGroupsWholeSet) {
+    thesis_project::database::DatabaseManager db(config);
+    ASSERT_TRUE(db.isEnabled());
+
+    const int set_a = db.createKeypointSet("preload_a", "SIFT", "homography_projection");
+    const int set_b = db.createKeypointSet("preload_b", "SIFT", "independent_detection");
+    ASSERT_GT(set_a, 0);
+    ASSERT_GT(set_b, 0);
+    EXPECT_EQ(db.getKeypointSetId("preload_a"), set_a);
+    EXPECT_EQ(db.getKeypointSetId("missing"), -1);
+
+    // Interleave the two sets' writes so the scan has to group rows itself
+    for (int i = 1; i <= 3; ++i) {
+        for (const char* scene : {"v_b", "i_a"}) {
+            const std::string image = std::to_string(i) + ".ppm";
+            ASSERT_TRUE(db.storeLockedKeypointsForSet(set_a, scene, image, gridKeypoints(5 * i)));
+            ASSERT_TRUE(db.storeLockedKeypointsForSet(set_b, scene, image, gridKeypoints(7)));
+        }
+    }
+
+    const auto index = db.loadKeypointSet(set_a);
+    EXPECT_EQ(index.images(), 6u);
+    EXPECT_EQ(index.size(), 2u * (5 + 10 + 15));
+    for (int i = 1; i <= 3; ++i) {
+        for (const char* scene : {"v_b", "i_a"}) {
+            const std::string image = std::to_string(i) + ".ppm";
+            const auto range = index.find(scene, image);
+            const auto expected = gridKeypoints(5 * i);  // insertion order
+            ASSERT_EQ(range.size, expected.size());
+            for (size_t k = 0; k < expected.size(); ++k) {
+                EXPECT_FLOAT_EQ(range.data[k].pt.x, expected[k].pt.x);
+                EXPECT_FLOAT_EQ(range.data[k].pt.y, expected[k].pt.y);
+                EXPECT_FLOAT_EQ(range.data[k].response, expected[k].response);
+            }
+        }
+    }
+    EXPECT_TRUE(index.find("v_b", "4.ppm").empty());
+    EXPECT_TRUE(index.find("nope", "1.ppm").empty());
+    EXPECT_TRUE(db.loadKeypointSet(12345).empty());
+}
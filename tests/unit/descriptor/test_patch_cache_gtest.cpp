@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+
+#include "src/core/descriptor/extractors/PatchCache.hpp"
+
+using thesis_project::extractors::PatchCache;
+
+namespace {
+cv::Mat randomImage(int rows, int cols, int seed) {
+    cv::Mat m(rows, cols, CV_8U);
+    cv::RNG(seed).fill(m, cv::RNG::UNIFORM, 0, 256);
+    return m;
+}
+
+std::vector<cv::KeyPoint> gridKeypoints(int n) {
+    std::vector<cv::KeyPoint> kps;
+    for (int i = 0; i < n; ++i) kps.emplace_back(cv::Point2f(10.0f + i, 20.0f + 2.0f * i), 8.0f, 15.0f * i);
+    return kps;
+}
+
+// [K, N*N] patches of the size the cache would hold
+cv::Mat fakePatches(int k, int n, int value) {
+    return cv::Mat(k, n * n, CV_8U, cv::Scalar(value));
+}
+
+class PatchCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        cache_.clear();
+        capacity_ = cache_.capacityBytes();
+    }
+    void TearDown() override {
+        cache_.clear();
+        cache_.setCapacityBytes(capacity_);
+    }
+
+    PatchCache& cache_ = PatchCache::instance();
+    size_t capacity_ = 0;
+};
+}
+
+TEST_F(PatchCacheTest, HitsOnlyForSameImageKeypointsAndGeometry) {
+    const cv::Mat image = randomImage(120, 90, 1);
+    const auto kps = gridKeypoints(5);
+    const auto key = PatchCache::makeKey(image, kps, 32, 1.0f, true);
+    const auto stored = cache_.put(key, fakePatches(5, 32, 7));
+
+    auto hit = cache_.get(PatchCache::makeKey(image.clone(), kps, 32, 1.0f, true));
+    ASSERT_TRUE(hit);
+    EXPECT_EQ(hit.get(), stored.get());
+
+    auto moved = kps;
+    moved[3].pt.x += 0.5f;
+    EXPECT_FALSE(cache_.get(PatchCache::makeKey(image, moved, 32, 1.0f, true)));
+    auto rotated = kps;
+    rotated[0].angle += 1.0f;
+    EXPECT_FALSE(cache_.get(PatchCache::makeKey(image, rotated, 32, 1.0f, true)));
+    EXPECT_FALSE(cache_.get(PatchCache::makeKey(image, gridKeypoints(4), 32, 1.0f, true)));
+
+    EXPECT_FALSE(cache_.get(PatchCache::makeKey(image, kps, 64, 1.0f, true)));
+    EXPECT_FALSE(cache_.get(PatchCache::makeKey(image, kps, 32, 1.5f, true)));
+    EXPECT_FALSE(cache_.get(PatchCache::makeKey(image, kps, 32, 1.0f, false)));
+
+    cv::Mat edited = image.clone();
+    edited.row(0).setTo(cv::Scalar(0));   // the first row is always sampled
+    EXPECT_FALSE(cache_.get(PatchCache::makeKey(edited, kps, 32, 1.0f, true)));
+    EXPECT_FALSE(cache_.get(PatchCache::makeKey(image.colRange(0, 80).clone(), kps, 32, 1.0f, true)));
+    cv::Mat wide;
+    image.convertTo(wide, CV_16U);
+    EXPECT_FALSE(cache_.get(PatchCache::makeKey(wide, kps, 32, 1.0f, true)));
+
+    const auto stats = cache_.stats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 9u);
+    EXPECT_EQ(stats.entries, 1u);
+    EXPECT_EQ(stats.bytes, 5u * 32 * 32);
+}
+
+TEST_F(PatchCacheTest, BudgetRejectsEntriesOnceFull) {
+    const size_t entryBytes = 4 * 16 * 16;
+    cache_.setCapacityBytes(2 * entryBytes + entryBytes / 2);
+
+    const auto kps = gridKeypoints(4);
+    std::vector<PatchCache::Key> keys;
+    for (int i = 0; i < 3; ++i) {
+        keys.push_back(PatchCache::makeKey(randomImage(64, 64, 10 + i), kps, 16, 1.0f, true));
+        const auto stored = cache_.put(keys.back(), fakePatches(4, 16, i));
+        ASSERT_TRUE(stored);
+        EXPECT_EQ(stored->at<uchar>(0, 0), i);   // the caller gets its patches even when rejected
+    }
+
+    EXPECT_TRUE(cache_.get(keys[0]));
+    EXPECT_TRUE(cache_.get(keys[1]));
+    EXPECT_FALSE(cache_.get(keys[2]));
+    const auto stats = cache_.stats();
+    EXPECT_EQ(stats.entries, 2u);
+    EXPECT_EQ(stats.rejected, 1u);
+    EXPECT_EQ(stats.bytes, 2 * entryBytes);
+
+    // A second put of a cached key returns the first entry, without charging the budget again
+    const auto again = cache_.put(keys[0], fakePatches(4, 16, 99));
+    EXPECT_EQ(again->at<uchar>(0, 0), 0);
+    EXPECT_EQ(cache_.stats().bytes, 2 * entryBytes);
+}
+
+TEST_F(PatchCacheTest, ReleaseGeometryDropsOnlyThatGeometry) {
+    const cv::Mat image = randomImage(64, 64, 20);
+    const auto kps = gridKeypoints(3);
+    const auto small = PatchCache::makeKey(image, kps, 16, 1.0f, true);
+    const auto large = PatchCache::makeKey(image, kps, 32, 1.0f, true);
+    cache_.put(small, fakePatches(3, 16, 1));
+    cache_.put(large, fakePatches(3, 32, 2));
+
+    cache_.releaseGeometry(16, 1.0f, true);
+    EXPECT_FALSE(cache_.get(small));
+    EXPECT_TRUE(cache_.get(large));
+    EXPECT_EQ(cache_.stats().entries, 1u);
+    EXPECT_EQ(cache_.stats().bytes, 3u * 32 * 32);
+
+    cache_.releaseGeometry(32, 1.0f, false);   // different rotation flag: untouched
+    EXPECT_TRUE(cache_.get(large));
+}
@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+#include <filesystem>
+#include <fstream>
+
+#include "src/core/descriptor/extractors/wrappers/PseudoDNNWrapper.hpp"
+
+using thesis_project::wrappers::PseudoDNNWrapper;
+
+namespace {
+constexpr int kPatch = 32;
+constexpr int kFeatureDim = 128;
+
+// Textured 8-bit patch with plateaus, so LBP sees ties as well as strict orderings
+cv::Mat syntheticPatch(int seed) {
+    cv::Mat patch(kPatch, kPatch, CV_8U);
+    cv::RNG rng(seed);
+    rng.fill(patch, cv::RNG::UNIFORM, 0, 256);
+    patch(cv::Rect(4, 4, 10, 6)).setTo(cv::Scalar(120));
+    cv::circle(patch, cv::Point(22, 20), 6, cv::Scalar(240), -1);
+    return patch;
+}
+
+// Per-pixel LBP and cv::meanStdDev per cell, as the wrapper computed them before
+// the ROI-compare / integral-image rewrite
+std::vector<float> referenceFeatures(const cv::Mat& patch) {
+    std::vector<cv::Mat> features;
+    for (int sigma = 1; sigma <= 3; sigma++) {
+        cv::Mat blurred, grad_x, grad_y, magnitude;
+        cv::GaussianBlur(patch, blurred, cv::Size(5, 5), sigma);
+        cv::Sobel(blurred, grad_x, CV_32F, 1, 0, 3);
+        cv::Sobel(blurred, grad_y, CV_32F, 0, 1, 3);
+        cv::magnitude(grad_x, grad_y, magnitude);
+        features.push_back(magnitude);
+    }
+
+    cv::Mat lbp = cv::Mat::zeros(patch.size(), CV_8U);
+    for (int i = 1; i < patch.rows - 1; i++) {
+        for (int j = 1; j < patch.cols - 1; j++) {
+            const uchar c = patch.at<uchar>(i, j);
+            uchar code = 0;
+            code |= (patch.at<uchar>(i - 1, j - 1) > c) << 7;
+            code |= (patch.at<uchar>(i - 1, j) > c) << 6;
+            code |= (patch.at<uchar>(i - 1, j + 1) > c) << 5;
+            code |= (patch.at<uchar>(i, j + 1) > c) << 4;
+            code |= (patch.at<uchar>(i + 1, j + 1) > c) << 3;
+            code |= (patch.at<uchar>(i + 1, j) > c) << 2;
+            code |= (patch.at<uchar>(i + 1, j - 1) > c) << 1;
+            code |= (patch.at<uchar>(i, j - 1) > c) << 0;
+            lbp.at<uchar>(i, j) = code;
+        }
+    }
+    lbp.convertTo(lbp, CV_32F);
+    features.push_back(lbp);
+
+    std::vector<float> out;
+    for (const auto& feat : features) {
+        const int cell_w = feat.cols / 4, cell_h = feat.rows / 4;
+        for (int gi = 0; gi < 4; gi++) {
+            for (int gj = 0; gj < 4; gj++) {
+                cv::Scalar mean, stddev;
+                cv::meanStdDev(feat(cv::Rect(gj * cell_w, gi * cell_h, cell_w, cell_h)), mean, stddev);
+                out.push_back(static_cast<float>(mean[0]));
+                out.push_back(static_cast<float>(stddev[0]));
+            }
+        }
+    }
+    return out;
+}
+
+cv::Mat randomRows(int rows, int cols, int seed) {
+    cv::Mat m(rows, cols, CV_32F);
+    cv::RNG(seed).fill(m, cv::RNG::UNIFORM, 0.0f, 50.0f);
+    return m;
+}
+
+std::vector<cv::KeyPoint> scatteredKeypoints() {
+    std::vector<cv::KeyPoint> kps;
+    for (int i = 0; i < 12; ++i) {
+        kps.emplace_back(cv::Point2f(20.0f + 7.0f * (i % 4), 20.0f + 9.0f * (i / 4)), 16.0f, 30.0f * i);
+    }
+    return kps;
+}
+
+// With angle 0 the wrapper's warp is the identity, so a kPatch x kPatch image is the patch
+std::vector<cv::KeyPoint> identityKeypoint() {
+    return {cv::KeyPoint(cv::Point2f(kPatch / 2.0f, kPatch / 2.0f), kPatch, 0.0f)};
+}
+}
+
+TEST(PseudoDNNWrapperTest, RawFeaturesMatchPerPixelReference) {
+    PseudoDNNWrapper wrapper(kPatch, 1.0f, true);
+    for (int seed : {1, 2, 3}) {
+        const cv::Mat patch = syntheticPatch(seed);
+        const cv::Mat raw = wrapper.computeRawFeatures(patch, identityKeypoint());
+        ASSERT_EQ(raw.rows, 1);
+        ASSERT_EQ(raw.cols, kFeatureDim);
+
+        const std::vector<float> expected = referenceFeatures(patch);
+        ASSERT_EQ(static_cast<int>(expected.size()), kFeatureDim);
+        for (int f = 0; f < kFeatureDim; ++f) {
+            // Integral-image variance loses a little precision against the two-pass std
+            EXPECT_NEAR(raw.at<float>(0, f), expected[f], 1e-3f * std::max(1.0f, std::abs(expected[f])))
+                << "seed " << seed << " feature " << f;
+        }
+    }
+}
+
+TEST(PseudoDNNWrapperTest, SavedProjectionReloadsAndMatchesPCAProject) {
+    const cv::Mat samples = randomRows(300, kFeatureDim, 4);
+    const cv::Mat image = syntheticPatch(5).clone();
+    cv::Mat large;
+    cv::repeat(image, 3, 3, large);
+    const auto kps = scatteredKeypoints();
+    const auto path = (std::filesystem::temp_directory_path() / "test_pseudo_dnn_pca.yml").string();
+
+    PseudoDNNWrapper fitted(kPatch, 1.0f, true);
+    fitted.fitPCA(samples);
+    ASSERT_TRUE(fitted.hasPCA());
+    ASSERT_TRUE(fitted.savePCA(path));
+
+    PseudoDNNWrapper loaded(kPatch, 1.0f, true, path);
+    ASSERT_TRUE(loaded.hasPCA());
+    const cv::Mat a = fitted.extract(large, kps);
+    const cv::Mat b = loaded.extract(large, kps);
+    ASSERT_EQ(a.size(), b.size());
+    EXPECT_EQ(cv::norm(a, b, cv::NORM_INF), 0.0);
+
+    // Folded-bias GEMM == cv::PCA::project followed by per-row L2 normalisation
+    cv::PCA pca(samples, cv::Mat(), cv::PCA::DATA_AS_ROW, kFeatureDim);
+    cv::Mat expected = pca.project(fitted.computeRawFeatures(large, kps));
+    for (int r = 0; r < expected.rows; ++r) cv::normalize(expected.row(r), expected.row(r));
+    ASSERT_EQ(expected.size(), a.size());
+    EXPECT_LT(cv::norm(a, expected, cv::NORM_INF), 1e-4);
+    std::filesystem::remove(path);
+}
+
+TEST(PseudoDNNWrapperTest, MalformedProjectionFileThrows) {
+    const auto path = (std::filesystem::temp_directory_path() / "test_pseudo_dnn_bad_pca.yml").string();
+    {
+        cv::FileStorage fs(path, cv::FileStorage::WRITE);
+        fs << "mean" << cv::Mat::zeros(1, 10, CV_32F);   // wrong feature width
+        fs << "eigenvectors" << cv::Mat::eye(10, 10, CV_32F);
+    }
+    EXPECT_THROW(PseudoDNNWrapper(kPatch, 1.0f, true, path), std::runtime_error);
+
+    { std::ofstream(path) << "not a FileStorage document"; }
+    EXPECT_ANY_THROW(PseudoDNNWrapper(kPatch, 1.0f, true, path));
+
+    EXPECT_THROW(PseudoDNNWrapper(kPatch, 1.0f, true, path + ".missing"), std::runtime_error);
+    std::filesystem::remove(path);
+}
@@ -41,9 +41,31 @@ TEST_F(MatchingFactoryTest, CreateFromConfigDefaultBruteForce) {
     EXPECT_EQ(matches.size(), static_cast<size_t>(desc1.rows));
 }
 
+TEST_F(MatchingFactoryTest, CreateFlannStrategy) {
+    auto strategy = MatchingFactory::createStrategy(FLANN);
+    ASSERT_NE(strategy, nullptr);
+    EXPECT_EQ(strategy->getName(), "FLANN");
+}
+
+TEST_F(MatchingFactoryTest, CreateFromEvaluationParams) {
+    thesis_project::EvaluationParams params;
+    EXPECT_EQ(MatchingFactory::createFromConfig(params)->getName(), "BruteForce");
+    params.matching_method = thesis_project::MatchingMethod::FLANN;
+    params.flann_trees = 2;
+    params.flann_checks = 16;
+    auto strategy = MatchingFactory::createFromConfig(params);
+    ASSERT_NE(strategy, nullptr);
+    EXPECT_EQ(strategy->getName(), "FLANN");
+}
+
+TEST_F(MatchingFactoryTest, CreateRatioTestStrategy) {
+    auto strategy = MatchingFactory::createStrategy(RATIO_TEST);
+    ASSERT_NE(strategy, nullptr);
+    EXPECT_EQ(strategy->getName(), "RatioTest");
+    EXPECT_TRUE(strategy->supportsRatioTest());
+}
+
 TEST_F(MatchingFactoryTest, CreateStrategyUnknownsThrow) {
-    EXPECT_THROW(MatchingFactory::createStrategy(FLANN), std::runtime_error);
-    EXPECT_THROW(MatchingFactory::createStrategy(RATIO_TEST), std::runtime_error);
     EXPECT_THROW(MatchingFactory::createStrategy(static_cast<MatchingStrategy>(99)), std::runtime_error);
 }
 
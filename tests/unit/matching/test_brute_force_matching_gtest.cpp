@@ -0,0 +1,216 @@
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+
+#include "src/core/matching/BruteForceMatching.hpp"
+#include "src/core/matching/DistanceKernels.hpp"
+
+using thesis_project::matching::BruteForceMatching;
+namespace kernels = thesis_project::matching::kernels;
+
+namespace {
+cv::Mat randomMat(int rows, int cols, int type, int seed) {
+    cv::Mat m(rows, cols, type);
+    cv::RNG rng(seed);
+    if (type == CV_8U) rng.fill(m, cv::RNG::UNIFORM, 0, 256);
+    else rng.fill(m, cv::RNG::UNIFORM, 0.0f, 1.0f);
+    return m;
+}
+
+// The blocked kernel must reproduce cv::BFMatcher exactly (same pairs, same distances)
+void expectSameAsOpenCV(const cv::Mat& d1, const cv::Mat& d2, int normType, bool crossCheck) {
+    auto ours = BruteForceMatching(normType, crossCheck).matchDescriptors(d1, d2);
+    std::vector<cv::DMatch> ref;
+    cv::BFMatcher(normType, crossCheck).match(d1, d2, ref);
+
+    ASSERT_EQ(ours.size(), ref.size());
+    for (size_t i = 0; i < ref.size(); ++i) {
+        EXPECT_EQ(ours[i].queryIdx, ref[i].queryIdx);
+        EXPECT_EQ(ours[i].trainIdx, ref[i].trainIdx);
+        EXPECT_NEAR(ours[i].distance, ref[i].distance, 1e-4f * std::max(1.0f, ref[i].distance));
+    }
+}
+}
+
+TEST(BruteForceMatchingTest, CrossCheckL2MatchesBFMatcher) {
+    // Sizes straddle the query (64) and train (512) block boundaries
+    cv::Mat d1 = randomMat(700, 128, CV_32F, 1);
+    cv::Mat d2 = randomMat(530, 128, CV_32F, 2);
+    d2.rowRange(0, 200) = d1.rowRange(0, 200) + cv::Scalar(0.001);  // plenty of mutual matches
+    expectSameAsOpenCV(d1, d2, cv::NORM_L2, true);
+}
+
+TEST(BruteForceMatchingTest, NoCrossCheckL2MatchesBFMatcher) {
+    expectSameAsOpenCV(randomMat(130, 64, CV_32F, 3), randomMat(90, 64, CV_32F, 4), cv::NORM_L2, false);
+}
+
+TEST(BruteForceMatchingTest, CrossCheckL1MatchesBFMatcher) {
+    // 37 columns exercises the scalar tail of the register tile
+    expectSameAsOpenCV(randomMat(150, 37, CV_32F, 5), randomMat(141, 37, CV_32F, 6), cv::NORM_L1, true);
+}
+
+TEST(BruteForceMatchingTest, CrossCheckHammingMatchesBFMatcher) {
+    cv::Mat d1 = randomMat(120, 32, CV_8U, 7);
+    cv::Mat d2 = d1.clone();
+    expectSameAsOpenCV(d1, d2, cv::NORM_HAMMING, true);
+}
+
+TEST(BruteForceMatchingTest, CrossCheckTiesIndependentOfWorkerCount) {
+    // Query rows repeat every 100 rows, so column ties span query blocks and,
+    // with several workers, stripes; the lowest query index must still win
+    cv::Mat base = randomMat(100, 32, CV_8U, 12);
+    cv::Mat d1;
+    cv::repeat(base, 7, 1, d1);
+    const cv::Mat d2 = randomMat(260, 32, CV_8U, 13);
+    const int threads = cv::getNumThreads();
+    for (int n : {1, 3, 8}) {
+        cv::setNumThreads(n);
+        expectSameAsOpenCV(d1, d2, cv::NORM_HAMMING, true);
+    }
+    cv::setNumThreads(threads);
+}
+
+TEST(BruteForceMatchingTest, EmptyInputGivesNoMatches) {
+    BruteForceMatching matcher;
+    EXPECT_TRUE(matcher.matchDescriptors(cv::Mat(), randomMat(5, 8, CV_32F, 8)).empty());
+}
+
+TEST(BruteForceMatchingTest, BFloat16RoundTripKeepsEightMantissaBits) {
+    const cv::Mat d = randomMat(40, 128, CV_32F, 9);
+    const cv::Mat bf = kernels::toBFloat16(d);
+    ASSERT_EQ(bf.type(), CV_16U);
+    const cv::Mat back = kernels::toFloat(bf);
+    ASSERT_EQ(back.type(), CV_32F);
+    for (int r = 0; r < d.rows; ++r) {
+        for (int c = 0; c < d.cols; ++c) {
+            const float v = d.at<float>(r, c);
+            EXPECT_NEAR(back.at<float>(r, c), v, std::abs(v) / 256.0f + 1e-30f);
+        }
+    }
+}
+
+TEST(BruteForceMatchingTest, HalfPrecisionDistancesTrackFloat) {
+    // Sizes straddle the tile boundaries so the widening path covers partial tiles
+    const cv::Mat d1 = randomMat(130, 128, CV_32F, 10);
+    const cv::Mat d2 = randomMat(530, 128, CV_32F, 11);
+    cv::Mat fp16_1, fp16_2;
+    d1.convertTo(fp16_1, CV_16F);
+    d2.convertTo(fp16_2, CV_16F);
+
+    for (int normType : {cv::NORM_L2, cv::NORM_L1}) {
+        const cv::Mat ref = kernels::distanceMatrix(d1, d2, normType);
+        const cv::Mat half = kernels::distanceMatrix(fp16_1, fp16_2, normType);
+        const cv::Mat bf = kernels::distanceMatrix(kernels::toBFloat16(d1), kernels::toBFloat16(d2), normType);
+        ASSERT_EQ(half.size(), ref.size());
+        ASSERT_EQ(bf.size(), ref.size());
+        double maxRef = 0.0;
+        cv::minMaxLoc(ref, nullptr, &maxRef);
+        EXPECT_LE(cv::norm(half, ref, cv::NORM_INF), 2e-3 * maxRef);
+        EXPECT_LE(cv::norm(bf, ref, cv::NORM_INF), 1e-2 * maxRef);
+    }
+}
+
+TEST(BruteForceMatchingTest, HalfPrecisionKeepsNearDuplicateMatches) {
+    const cv::Mat d1 = randomMat(200, 128, CV_32F, 12);
+    cv::Mat d2 = randomMat(300, 128, CV_32F, 13);
+    d2.rowRange(0, 200) = d1 + cv::Scalar(0.001);
+
+    const auto ref = BruteForceMatching(cv::NORM_L2, true).matchDescriptors(d1, d2);
+    cv::Mat h1, h2;
+    d1.convertTo(h1, CV_16F);
+    d2.convertTo(h2, CV_16F);
+    const auto fp16 = BruteForceMatching(cv::NORM_L2, true).matchDescriptors(h1, h2);
+    const auto bf16 = BruteForceMatching(cv::NORM_L2, true).matchDescriptors(
+        kernels::toBFloat16(d1), kernels::toBFloat16(d2));
+
+    ASSERT_EQ(fp16.size(), ref.size());
+    ASSERT_EQ(bf16.size(), ref.size());
+    for (size_t i = 0; i < ref.size(); ++i) {
+        EXPECT_EQ(fp16[i].trainIdx, ref[i].trainIdx);
+        EXPECT_EQ(bf16[i].trainIdx, ref[i].trainIdx);
+    }
+}
+
+TEST(BruteForceMatchingTest, TopKMatchesSortedDistanceRows) {
+    // Integer-valued floats keep GEMM and per-pair distances bit-identical, so ties are exact
+    cv::Mat f1 = randomMat(70, 32, CV_32F, 14), f2 = randomMat(600, 32, CV_32F, 15);
+    f1 = f1 * 8.0;
+    f2 = f2 * 8.0;
+    for (cv::Mat* m : {&f1, &f2}) {
+        for (int r = 0; r < m->rows; ++r) {
+            for (int c = 0; c < m->cols; ++c) m->at<float>(r, c) = std::floor(m->at<float>(r, c));
+        }
+    }
+    const cv::Mat u1 = randomMat(70, 32, CV_8U, 16), u2 = randomMat(600, 32, CV_8U, 17);
+
+    struct Case { cv::Mat q, t; int norm; };
+    for (const Case& tc : {Case{f1, f2, cv::NORM_L2SQR}, Case{f1, f2, cv::NORM_L1},
+                           Case{u1, u2, cv::NORM_L2SQR}, Case{u1, u2, cv::NORM_HAMMING}}) {
+        const int k = 10;
+        std::vector<int> targets(tc.q.rows);
+        for (int r = 0; r < tc.q.rows; ++r) targets[r] = r % 5 == 0 ? -1 : (r * 37) % tc.t.rows;
+
+        kernels::TopK top;
+        kernels::topKNeighbours(tc.q, tc.t, tc.norm, k, targets, top);
+        const cv::Mat full = kernels::distanceMatrix(tc.q, tc.t, tc.norm);
+
+        for (int r = 0; r < tc.q.rows; ++r) {
+            const float* row = full.ptr<float>(r);
+            std::vector<int> order(tc.t.rows);
+            for (int c = 0; c < tc.t.rows; ++c) order[c] = c;
+            std::stable_sort(order.begin(), order.end(), [row](int a, int b) { return row[a] < row[b]; });
+            for (int j = 0; j < k; ++j) {
+                EXPECT_EQ(top.idx[r * k + j], order[j]);
+                EXPECT_EQ(top.dist[r * k + j], row[order[j]]);
+            }
+            if (targets[r] < 0) continue;
+            int better = 0, ties = 0;
+            for (int c = 0; c < tc.t.rows; ++c) {
+                if (row[c] < row[targets[r]]) ++better;
+                else if (row[c] == row[targets[r]] && c != targets[r]) ++ties;
+            }
+            EXPECT_EQ(top.better[r], better);
+            EXPECT_EQ(top.ties[r], ties);
+        }
+    }
+}
+
+TEST(BruteForceMatchingTest, TopKNearestTargetRanksFirst) {
+    // Random (non-integer) floats: the 1x1 target tile and the 64x512 scan tiles sum in
+    // different orders, yet a target that is the exact NN must never outrank itself
+    cv::Mat q = randomMat(200, 128, CV_32F, 20) * 100.0;
+    cv::Mat t = randomMat(3000, 128, CV_32F, 21) * 100.0;
+    const cv::Mat noise = randomMat(200, 128, CV_32F, 22) * 1e-3;
+    std::vector<int> targets(q.rows);
+    for (int r = 0; r < q.rows; ++r) {
+        targets[r] = (r * 61 + 7) % t.rows;
+        cv::Mat row = r % 2 == 0 ? q.row(r).clone() : cv::Mat(q.row(r) + noise.row(r));  // duplicate or near-duplicate
+        row.copyTo(t.row(targets[r]));
+    }
+
+    for (int norm : {cv::NORM_L2, cv::NORM_L2SQR, cv::NORM_L1}) {
+        const int k = 5;
+        kernels::TopK top;
+        kernels::topKNeighbours(q, t, norm, k, targets, top);
+        for (int r = 0; r < q.rows; ++r) {
+            ASSERT_EQ(top.idx[r * k], targets[r]) << "target is the exact NN";
+            EXPECT_EQ(top.better[r], 0) << "norm " << norm << " row " << r;
+            EXPECT_EQ(top.ties[r], 0) << "norm " << norm << " row " << r;
+            EXPECT_EQ(top.targetDist[r], top.dist[r * k]);
+        }
+    }
+}
+
+TEST(BruteForceMatchingTest, TopKPadsShortTrainSets) {
+    const cv::Mat d1 = randomMat(4, 16, CV_32F, 18);
+    const cv::Mat d2 = randomMat(3, 16, CV_32F, 19);
+    kernels::TopK top;
+    kernels::topKNeighbours(d1, d2, cv::NORM_L2, 5, {}, top);
+    ASSERT_EQ(top.idx.size(), 20u);
+    for (int r = 0; r < 4; ++r) {
+        EXPECT_GE(top.idx[r * 5 + 2], 0);
+        EXPECT_EQ(top.idx[r * 5 + 3], -1);
+        EXPECT_EQ(top.idx[r * 5 + 4], -1);
+    }
+    EXPECT_THROW(kernels::topKNeighbours(d1, d2, cv::NORM_L2, 0, {}, top), std::invalid_argument);
+    EXPECT_THROW(kernels::topKNeighbours(d1, d2, cv::NORM_L2, 2, {0, 1}, top), std::invalid_argument);
+}
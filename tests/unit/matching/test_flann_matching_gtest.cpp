@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+
+#include "src/core/matching/FlannMatching.hpp"
+#include "src/core/matching/BruteForceMatching.hpp"
+
+using thesis_project::matching::FlannMatching;
+using thesis_project::matching::BruteForceMatching;
+
+namespace {
+cv::Mat randomFloat(int rows, int cols, int seed) {
+    cv::Mat m(rows, cols, CV_32F);
+    cv::RNG rng(seed);
+    rng.fill(m, cv::RNG::UNIFORM, 0.0f, 1.0f);
+    return m;
+}
+// Train = query with a small perturbation so the true nearest neighbour is the same row
+cv::Mat perturbed(const cv::Mat& src, int seed) {
+    cv::Mat noise(src.size(), src.type());
+    cv::RNG rng(seed);
+    rng.fill(noise, cv::RNG::NORMAL, 0.0f, 0.01f);
+    return src + noise;
+}
+}
+
+TEST(FlannMatchingTest, FloatMatchesAgreeWithBruteForce) {
+    cv::Mat d1 = randomFloat(300, 128, 1);
+    cv::Mat d2 = perturbed(d1, 2);
+
+    FlannMatching flann(cv::NORM_L2, true, 4, 64);
+    BruteForceMatching bf(cv::NORM_L2, true);
+    auto approx = flann.matchDescriptors(d1, d2);
+    auto exact = bf.matchDescriptors(d1, d2);
+    ASSERT_FALSE(exact.empty());
+
+    std::vector<int> nn(d1.rows, -1);
+    for (const auto& m : approx) nn[m.queryIdx] = m.trainIdx;
+    int hits = 0;
+    for (const auto& m : exact) if (nn[m.queryIdx] == m.trainIdx) ++hits;
+    EXPECT_GE(static_cast<double>(hits) / exact.size(), 0.95);
+
+    // Distances are reported in the brute-force metric (not squared L2)
+    for (const auto& m : approx) {
+        const double expected = cv::norm(d1.row(m.queryIdx), d2.row(m.trainIdx), cv::NORM_L2);
+        EXPECT_NEAR(m.distance, expected, 1e-3);
+    }
+}
+
+TEST(FlannMatchingTest, BinaryDescriptorsUseHamming) {
+    cv::Mat d1(200, 32, CV_8U);
+    cv::RNG rng(3);
+    rng.fill(d1, cv::RNG::UNIFORM, 0, 256);
+    cv::Mat d2 = d1.clone();
+    d2.at<uchar>(0, 0) ^= 0x01;
+
+    FlannMatching flann(cv::NORM_HAMMING, true);
+    auto matches = flann.matchDescriptors(d1, d2);
+    ASSERT_FALSE(matches.empty());
+    int identity = 0;
+    for (const auto& m : matches) if (m.queryIdx == m.trainIdx) ++identity;
+    EXPECT_GE(identity, static_cast<int>(0.9 * matches.size()));
+}
+
+TEST(FlannMatchingTest, ReusesIndexAcrossPairs) {
+    cv::Mat ref = randomFloat(150, 64, 4);
+    FlannMatching flann(cv::NORM_L2, true, 2, 32);
+    auto first = flann.matchDescriptors(ref, perturbed(ref, 5));
+    auto second = flann.matchDescriptors(ref, perturbed(ref, 6));
+    EXPECT_FALSE(first.empty());
+    EXPECT_FALSE(second.empty());
+    EXPECT_EQ(flann.getName(), "FLANN");
+    EXPECT_TRUE(flann.matchDescriptors(cv::Mat(), ref).empty());
+}
+
+TEST(FlannMatchingTest, ConvertedTrainIsNotConfusedWithRecycledBuffer) {
+    // uint8 train rows are indexed as a float copy; each iteration frees its train
+    // buffer, so a same-shaped successor may land at the same address
+    FlannMatching flann(cv::NORM_L2, false, 4, 64);
+    for (int seed = 10; seed < 14; ++seed) {
+        cv::Mat train;
+        randomFloat(200, 32, seed).convertTo(train, CV_8U, 255.0);
+        cv::Mat query;
+        train.convertTo(query, CV_32F);
+
+        const auto matches = flann.matchDescriptors(query, train);
+        int identity = 0;
+        for (const auto& m : matches) if (m.queryIdx == m.trainIdx && m.distance < 1e-3f) ++identity;
+        EXPECT_GE(identity, 190) << "seed " << seed;
+    }
+}
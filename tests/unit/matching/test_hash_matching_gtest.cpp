@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+
+#include "src/core/matching/HashMatching.hpp"
+#include "src/core/matching/BruteForceMatching.hpp"
+
+using thesis_project::BinaryProjection;
+using thesis_project::matching::HashMatching;
+using thesis_project::matching::BruteForceMatching;
+using thesis_project::quantization::BinaryHashParams;
+
+namespace {
+cv::Mat randomFloat(int rows, int cols, int seed) {
+    cv::Mat m(rows, cols, CV_32F);
+    cv::RNG rng(seed);
+    rng.fill(m, cv::RNG::UNIFORM, 0.0f, 1.0f);
+    return m;
+}
+
+BinaryHashParams params(int bits) {
+    BinaryHashParams p;
+    p.bits = bits;
+    p.projection = BinaryProjection::ITQ;
+    return p;
+}
+}
+
+TEST(HashMatchingTest, HammingOnlyEqualsBruteForceOnCodes) {
+    cv::Mat train = randomFloat(300, 64, 1);
+    cv::Mat query = randomFloat(120, 64, 2);
+    HashMatching hash(cv::NORM_L2, true, params(64), 0);
+    auto matches = hash.matchDescriptors(query, train);
+
+    BruteForceMatching bf(cv::NORM_HAMMING, true);
+    auto expected = bf.matchDescriptors(hash.hasher().encode(query), hash.hasher().encode(train));
+    ASSERT_EQ(matches.size(), expected.size());
+    for (size_t i = 0; i < matches.size(); ++i) {
+        EXPECT_EQ(matches[i].queryIdx, expected[i].queryIdx);
+        EXPECT_EQ(matches[i].trainIdx, expected[i].trainIdx);
+        EXPECT_FLOAT_EQ(matches[i].distance, expected[i].distance);
+    }
+}
+
+TEST(HashMatchingTest, FullRerankIsExact) {
+    cv::Mat train = randomFloat(150, 32, 3);
+    cv::Mat query = randomFloat(80, 32, 4);
+    HashMatching hash(cv::NORM_L2, true, params(32), train.rows);
+    BruteForceMatching bf(cv::NORM_L2, true);
+
+    auto approx = hash.matchDescriptors(query, train);
+    auto exact = bf.matchDescriptors(query, train);
+    ASSERT_EQ(approx.size(), exact.size());
+    for (size_t i = 0; i < exact.size(); ++i) {
+        EXPECT_EQ(approx[i].queryIdx, exact[i].queryIdx);
+        EXPECT_EQ(approx[i].trainIdx, exact[i].trainIdx);
+        EXPECT_NEAR(approx[i].distance, exact[i].distance, 1e-4);
+    }
+}
+
+TEST(HashMatchingTest, SmallRerankRecoversNearDuplicates) {
+    cv::Mat train = randomFloat(1000, 64, 5);
+    cv::Mat noise(200, 64, CV_32F);
+    cv::RNG(6).fill(noise, cv::RNG::NORMAL, 0.0f, 0.01f);
+    cv::Mat query = train.rowRange(0, 200) + noise;
+
+    HashMatching hash(cv::NORM_L2, false, params(64), 8);
+    auto matches = hash.matchDescriptors(query, train);
+    ASSERT_EQ(matches.size(), 200u);
+    int correct = 0;
+    for (const auto& m : matches) if (m.trainIdx == m.queryIdx) ++correct;
+    EXPECT_GE(correct, 190);
+    EXPECT_TRUE(hash.isApproximate());
+}
+
+TEST(HashMatchingTest, CrossCheckedRerankKeepsMutualMatches) {
+    // Queries cover only part of the train set, so the backward search runs
+    // for a subset of train rows
+    cv::Mat train = randomFloat(1000, 64, 7);
+    cv::Mat noise(200, 64, CV_32F);
+    cv::RNG(8).fill(noise, cv::RNG::NORMAL, 0.0f, 0.01f);
+    cv::Mat query = train.rowRange(300, 500) + noise;
+
+    HashMatching hash(cv::NORM_L2, true, params(64), 8);
+    auto matches = hash.matchDescriptors(query, train);
+    std::vector<int> seen(train.rows, 0);
+    int correct = 0;
+    for (const auto& m : matches) {
+        EXPECT_EQ(++seen[m.trainIdx], 1);  // mutual matches are one-to-one
+        if (m.trainIdx == m.queryIdx + 300) ++correct;
+    }
+    EXPECT_GE(correct, 190);
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+#include <filesystem>
+#include <fstream>
+
+#include "src/core/matching/HnswIndex.hpp"
+#include "src/core/matching/HnswMatching.hpp"
+#include "src/core/matching/BruteForceMatching.hpp"
+
+using thesis_project::matching::HnswIndex;
+using thesis_project::matching::HnswMatching;
+using thesis_project::matching::HnswParams;
+using thesis_project::matching::BruteForceMatching;
+
+namespace {
+cv::Mat randomFloat(int rows, int cols, int seed) {
+    cv::Mat m(rows, cols, CV_32F);
+    cv::RNG rng(seed);
+    rng.fill(m, cv::RNG::UNIFORM, 0.0f, 1.0f);
+    return m;
+}
+
+double recallAgainstBruteForce(const cv::Mat& query, const cv::Mat& train, int normType) {
+    HnswIndex index(normType);
+    index.build(train);
+    std::vector<int> idx;
+    std::vector<float> dist;
+    index.search(query, idx, dist);
+
+    std::vector<cv::DMatch> exact;
+    cv::BFMatcher(normType, false).match(query, train, exact);
+    int hits = 0;
+    for (const auto& m : exact) if (idx[m.queryIdx] == m.trainIdx) ++hits;
+    return static_cast<double>(hits) / exact.size();
+}
+}
+
+TEST(HnswIndexTest, HighRecallL2) {
+    EXPECT_GE(recallAgainstBruteForce(randomFloat(300, 64, 1), randomFloat(3000, 64, 2), cv::NORM_L2), 0.95);
+}
+
+TEST(HnswIndexTest, HighRecallL1) {
+    EXPECT_GE(recallAgainstBruteForce(randomFloat(200, 32, 3), randomFloat(1500, 32, 4), cv::NORM_L1), 0.95);
+}
+
+TEST(HnswIndexTest, DistancesInBruteForceMetric) {
+    cv::Mat train = randomFloat(500, 16, 5);
+    cv::Mat query = randomFloat(20, 16, 6);
+    HnswIndex index(cv::NORM_L2);
+    index.build(train);
+    std::vector<int> idx;
+    std::vector<float> dist;
+    index.search(query, idx, dist);
+    for (int r = 0; r < query.rows; ++r) {
+        ASSERT_GE(idx[r], 0);
+        EXPECT_NEAR(dist[r], cv::norm(query.row(r), train.row(idx[r]), cv::NORM_L2), 1e-4);
+    }
+}
+
+TEST(HnswIndexTest, SaveLoadRoundTrip) {
+    cv::Mat train = randomFloat(800, 32, 7);
+    cv::Mat query = randomFloat(50, 32, 8);
+    const auto path = (std::filesystem::temp_directory_path() / "test_hnsw_index.bin").string();
+
+    HnswIndex built(cv::NORM_L2);
+    built.build(train);
+    ASSERT_TRUE(built.save(path));
+
+    HnswIndex loaded(cv::NORM_L2);
+    ASSERT_TRUE(loaded.load(path, train));
+    EXPECT_FALSE(HnswIndex(cv::NORM_L2).load(path, randomFloat(10, 32, 9)));  // wrong matrix
+
+    std::vector<int> a, b;
+    std::vector<float> da, db;
+    built.search(query, a, da);
+    loaded.search(query, b, db);
+    EXPECT_EQ(a, b);
+    std::filesystem::remove(path);
+}
+
+TEST(HnswIndexTest, LoadRejectsCorruptGraph) {
+    cv::Mat train = randomFloat(300, 16, 12);
+    const auto path = (std::filesystem::temp_directory_path() / "test_hnsw_corrupt.bin").string();
+    HnswIndex built(cv::NORM_L2);
+    built.build(train);
+
+    // Overwrite one int32 at byteOffset (negative: from the end) and reload
+    auto loadPatched = [&](std::streamoff byteOffset, int32_t value) {
+        EXPECT_TRUE(built.save(path));
+        {
+            std::fstream f(path, std::ios::binary | std::ios::in | std::ios::out);
+            f.seekp(byteOffset, byteOffset < 0 ? std::ios::end : std::ios::beg);
+            f.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+        return HnswIndex(cv::NORM_L2).load(path, train);
+    };
+    EXPECT_FALSE(loadPatched(24, train.rows));          // entry point past the last row
+    EXPECT_FALSE(loadPatched(24, -5));                  // negative entry point
+    EXPECT_FALSE(loadPatched(28, 1 << 20));             // absurd max level
+    EXPECT_FALSE(loadPatched(-4, train.rows + 1000));   // last neighbour id (or count) out of range
+
+    ASSERT_TRUE(built.save(path));
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 4);
+    EXPECT_FALSE(HnswIndex(cv::NORM_L2).load(path, train));  // truncated
+
+    ASSERT_TRUE(built.save(path));
+    { std::ofstream(path, std::ios::binary | std::ios::app).put('\0'); }
+    EXPECT_FALSE(HnswIndex(cv::NORM_L2).load(path, train));  // trailing bytes
+
+    ASSERT_TRUE(built.save(path));
+    EXPECT_TRUE(HnswIndex(cv::NORM_L2).load(path, train));
+    std::filesystem::remove(path);
+}
+
+TEST(HnswMatchingTest, CrossCheckedMatchesAgreeWithBruteForce) {
+    cv::Mat d1 = randomFloat(400, 64, 10);
+    cv::Mat noise(d1.size(), CV_32F);
+    cv::RNG(11).fill(noise, cv::RNG::NORMAL, 0.0f, 0.01f);
+    cv::Mat d2 = d1 + noise;
+
+    HnswMatching hnsw(cv::NORM_L2, true);
+    EXPECT_TRUE(hnsw.isApproximate());
+    auto approx = hnsw.matchDescriptors(d1, d2);
+    auto exact = BruteForceMatching(cv::NORM_L2, true).matchDescriptors(d1, d2);
+
+    std::vector<int> nn(d1.rows, -1);
+    for (const auto& m : approx) nn[m.queryIdx] = m.trainIdx;
+    int hits = 0;
+    for (const auto& m : exact) if (nn[m.queryIdx] == m.trainIdx) ++hits;
+    EXPECT_GE(static_cast<double>(hits) / exact.size(), 0.95);
+}
+
+TEST(HnswMatchingTest, PersistsIndexInDirectory) {
+    const auto dir = std::filesystem::temp_directory_path() / "test_hnsw_index_dir";
+    std::filesystem::remove_all(dir);
+    cv::Mat d1 = randomFloat(100, 16, 12);
+    cv::Mat d2 = randomFloat(120, 16, 13);
+
+    HnswMatching hnsw(cv::NORM_L2, false, HnswParams(), dir.string());
+    hnsw.matchDescriptors(d1, d2);
+    EXPECT_TRUE(std::filesystem::exists(hnsw.indexPathFor(d2)));
+    std::filesystem::remove_all(dir);
+}
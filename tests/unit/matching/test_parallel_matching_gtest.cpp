@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+#include <atomic>
+
+#include "src/core/matching/ParallelMatching.hpp"
+#include "src/core/matching/BruteForceMatching.hpp"
+#include "src/core/matching/MatchingFactory.hpp"
+
+using thesis_project::matching::ParallelMatching;
+using thesis_project::matching::BruteForceMatching;
+using thesis_project::matching::MatchingFactory;
+
+namespace {
+cv::Mat randomFloat(int rows, int cols, int seed) {
+    cv::Mat m(rows, cols, CV_32F);
+    cv::RNG rng(seed);
+    rng.fill(m, cv::RNG::UNIFORM, 0.0f, 1.0f);
+    return m;
+}
+
+ParallelMatching::WorkerFactory bruteForceWorkers() {
+    return [](bool crossCheck) { return std::make_unique<BruteForceMatching>(cv::NORM_L2, crossCheck); };
+}
+
+// Exact L2 matcher exposing only the shared-search path, counting index preparations
+class SharedSearchMatcher : public BruteForceMatching {
+public:
+    explicit SharedSearchMatcher(std::atomic<int>& prepared) : BruteForceMatching(cv::NORM_L2, false), prepared_(prepared) {}
+
+    bool parallelizesQueries() const override { return false; }
+
+    bool prepareShared(const cv::Mat&) override {
+        ++prepared_;
+        return true;
+    }
+
+    void nearestShared(const cv::Mat& query, const cv::Mat& train,
+                       std::vector<int>& idx, std::vector<float>& dist) const override {
+        std::vector<cv::DMatch> matches;
+        cv::BFMatcher(cv::NORM_L2).match(query, train, matches);
+        idx.assign(query.rows, -1);
+        dist.assign(query.rows, 0.0f);
+        for (const auto& m : matches) {
+            idx[m.queryIdx] = m.trainIdx;
+            dist[m.queryIdx] = m.distance;
+        }
+    }
+
+private:
+    std::atomic<int>& prepared_;
+};
+
+// Exact L2 matcher with neither query parallelism nor shared search
+class PlainMatcher : public BruteForceMatching {
+public:
+    explicit PlainMatcher(bool crossCheck) : BruteForceMatching(cv::NORM_L2, crossCheck) {}
+    bool parallelizesQueries() const override { return false; }
+};
+
+void expectSameMatches(const std::vector<cv::DMatch>& got, const std::vector<cv::DMatch>& ref) {
+    ASSERT_EQ(got.size(), ref.size());
+    for (size_t i = 0; i < ref.size(); ++i) {
+        EXPECT_EQ(got[i].queryIdx, ref[i].queryIdx);
+        EXPECT_EQ(got[i].trainIdx, ref[i].trainIdx);
+        EXPECT_NEAR(got[i].distance, ref[i].distance, 1e-5f * std::max(1.0f, ref[i].distance));
+    }
+}
+}
+
+TEST(ParallelMatchingTest, CrossCheckMatchesSingleThreaded) {
+    cv::Mat d1 = randomFloat(301, 32, 1);
+    cv::Mat d2 = randomFloat(257, 32, 2);
+    d2.rowRange(0, 100) = d1.rowRange(0, 100) + cv::Scalar(0.001);
+
+    ParallelMatching parallel(bruteForceWorkers(), true, 4);
+    expectSameMatches(parallel.matchDescriptors(d1, d2),
+                      BruteForceMatching(cv::NORM_L2, true).matchDescriptors(d1, d2));
+}
+
+TEST(ParallelMatchingTest, NoCrossCheckMatchesSingleThreaded) {
+    cv::Mat d1 = randomFloat(97, 16, 3);
+    cv::Mat d2 = randomFloat(120, 16, 4);
+
+    ParallelMatching parallel(bruteForceWorkers(), false, 3);
+    expectSameMatches(parallel.matchDescriptors(d1, d2),
+                      BruteForceMatching(cv::NORM_L2, false).matchDescriptors(d1, d2));
+}
+
+TEST(ParallelMatchingTest, MoreWorkersThanQueries) {
+    cv::Mat d1 = randomFloat(3, 8, 5);
+    cv::Mat d2 = randomFloat(20, 8, 6);
+
+    ParallelMatching parallel(bruteForceWorkers(), true, 8);
+    EXPECT_EQ(parallel.threads(), 8);
+    expectSameMatches(parallel.matchDescriptors(d1, d2),
+                      BruteForceMatching(cv::NORM_L2, true).matchDescriptors(d1, d2));
+}
+
+TEST(ParallelMatchingTest, QueryParallelMatcherRunsOnceWithItsOwnCrossCheck) {
+    std::atomic<int> created{0};
+    std::vector<bool> crossChecks;
+    ParallelMatching parallel([&](bool crossCheck) {
+        ++created;
+        crossChecks.push_back(crossCheck);
+        return std::make_unique<BruteForceMatching>(cv::NORM_L2, crossCheck);
+    }, true, 5);
+    parallel.matchDescriptors(randomFloat(50, 8, 7), randomFloat(50, 8, 8));
+    EXPECT_EQ(created.load(), 1);
+    EXPECT_EQ(crossChecks, std::vector<bool>{true});
+    EXPECT_EQ(parallel.getName(), "BruteForce+Parallel");
+}
+
+TEST(ParallelMatchingTest, SharedSearchPreparesEachSideOnce) {
+    cv::Mat d1 = randomFloat(301, 32, 9);
+    cv::Mat d2 = randomFloat(257, 32, 10);
+    d2.rowRange(0, 100) = d1.rowRange(0, 100) + cv::Scalar(0.001);
+
+    std::atomic<int> created{0}, prepared{0};
+    ParallelMatching parallel([&](bool) {
+        ++created;
+        return std::make_unique<SharedSearchMatcher>(prepared);
+    }, true, 4);
+    expectSameMatches(parallel.matchDescriptors(d1, d2),
+                      BruteForceMatching(cv::NORM_L2, true).matchDescriptors(d1, d2));
+    EXPECT_EQ(created.load(), 1);   // no per-chunk copies
+    EXPECT_EQ(prepared.load(), 2);  // train index + descriptors1 index for the backward search
+}
+
+TEST(ParallelMatchingTest, FallbackWorkersResolveCrossCheck) {
+    cv::Mat d1 = randomFloat(301, 32, 11);
+    cv::Mat d2 = randomFloat(257, 32, 12);
+    d2.rowRange(0, 100) = d1.rowRange(0, 100) + cv::Scalar(0.001);
+
+    std::atomic<int> created{0};
+    ParallelMatching parallel([&](bool crossCheck) {
+        ++created;
+        return std::make_unique<PlainMatcher>(crossCheck);
+    }, true, 4);
+    expectSameMatches(parallel.matchDescriptors(d1, d2),
+                      BruteForceMatching(cv::NORM_L2, true).matchDescriptors(d1, d2));
+    EXPECT_EQ(created.load(), 5);   // primary + one worker per chunk, kept across calls
+    parallel.matchDescriptors(d1, d2);
+    EXPECT_EQ(created.load(), 5);
+}
+
+TEST(ParallelMatchingTest, ScoringDelegatesBeforeAnyMatch) {
+    // No chunk worker exists yet; scoring must go to the primary matcher
+    ParallelMatching parallel(bruteForceWorkers(), true, 4);
+    BruteForceMatching reference(cv::NORM_L2, true);
+
+    const std::vector<cv::KeyPoint> keypoints2 = {cv::KeyPoint(10.f, 10.f, 1.f), cv::KeyPoint(50.f, 50.f, 1.f)};
+    const std::vector<cv::Point2f> projected = {cv::Point2f(10.5f, 10.f), cv::Point2f(20.f, 20.f)};
+    const std::vector<cv::DMatch> matches = {cv::DMatch(0, 0, 0.1f), cv::DMatch(1, 1, 0.2f)};
+    EXPECT_DOUBLE_EQ(parallel.calculatePrecision(matches, keypoints2, projected, 3.0),
+                     reference.calculatePrecision(matches, keypoints2, projected, 3.0));
+    EXPECT_DOUBLE_EQ(parallel.adjustMatchThreshold(3.0, 2.0), reference.adjustMatchThreshold(3.0, 2.0));
+}
+
+TEST(ParallelMatchingTest, FactoryWrapsWhenThreadsConfigured) {
+    thesis_project::EvaluationParams params;
+    params.matching_method = thesis_project::MatchingMethod::BRUTE_FORCE;
+    EXPECT_EQ(MatchingFactory::createFromConfig(params)->getName(), "BruteForce");
+
+    params.match_threads = 2;
+    EXPECT_EQ(MatchingFactory::createFromConfig(params)->getName(), "BruteForce+Parallel");
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+#include <filesystem>
+
+#include "src/core/matching/PQMatching.hpp"
+#include "src/core/matching/BruteForceMatching.hpp"
+
+using thesis_project::matching::PQMatching;
+using thesis_project::matching::BruteForceMatching;
+using thesis_project::quantization::PQParams;
+
+namespace {
+cv::Mat randomFloat(int rows, int cols, int seed) {
+    cv::Mat m(rows, cols, CV_32F);
+    cv::RNG rng(seed);
+    rng.fill(m, cv::RNG::UNIFORM, 0.0f, 1.0f);
+    return m;
+}
+}
+
+TEST(PQMatchingTest, FullCodebookReproducesBruteForce) {
+    // 2^bits >= train rows: every sub-vector gets its own centroid, so the
+    // asymmetric distances are exact and PQ must agree with brute force
+    cv::Mat train = randomFloat(200, 64, 1);
+    cv::Mat query = randomFloat(100, 64, 2);
+
+    PQParams params;
+    params.m = 16;
+    params.bits = 8;
+    PQMatching pq(false, params);
+    BruteForceMatching bf(cv::NORM_L2, false);
+
+    auto approx = pq.matchDescriptors(query, train);
+    auto exact = bf.matchDescriptors(query, train);
+    ASSERT_EQ(approx.size(), exact.size());
+    int same = 0;
+    for (size_t i = 0; i < exact.size(); ++i) {
+        if (approx[i].trainIdx == exact[i].trainIdx) {
+            ++same;
+            EXPECT_NEAR(approx[i].distance, exact[i].distance, 1e-3);
+        }
+    }
+    EXPECT_GE(static_cast<double>(same) / exact.size(), 0.95);
+    EXPECT_TRUE(pq.isApproximate());
+    EXPECT_EQ(pq.getName(), "PQ");
+}
+
+TEST(PQMatchingTest, CrossCheckKeepsOnlyMutualMatches) {
+    cv::Mat a = randomFloat(300, 32, 3);
+    cv::Mat b = randomFloat(300, 32, 4);
+    PQParams params;
+    params.m = 8;
+    PQMatching pq(true, params);
+    auto matches = pq.matchDescriptors(a, b);
+    auto forward = PQMatching(false, params).matchDescriptors(a, b);
+    EXPECT_EQ(forward.size(), static_cast<size_t>(a.rows));
+    EXPECT_LT(matches.size(), forward.size());
+    std::vector<int> seen(b.rows, 0);
+    for (const auto& m : matches) EXPECT_EQ(seen[m.trainIdx]++, 0);
+}
+
+TEST(PQMatchingTest, CodebookIsPersistedAndReused) {
+    cv::Mat train = randomFloat(400, 32, 5);
+    const auto path = (std::filesystem::temp_directory_path() / "pq_matching_codebook_test.yml").string();
+    std::filesystem::remove(path);
+
+    PQParams params;
+    params.m = 8;
+    PQMatching first(false, params, path);
+    auto m1 = first.matchDescriptors(train.rowRange(0, 50), train);
+    ASSERT_TRUE(std::filesystem::exists(path));
+
+    PQMatching second(false, params, path);
+    auto m2 = second.matchDescriptors(train.rowRange(0, 50), train);
+    ASSERT_EQ(m1.size(), m2.size());
+    for (size_t i = 0; i < m1.size(); ++i) EXPECT_EQ(m1[i].trainIdx, m2[i].trainIdx);
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+
+#include "src/core/matching/RatioTestMatching.hpp"
+#include "src/core/matching/DistanceKernels.hpp"
+
+using thesis_project::matching::RatioTestMatching;
+namespace kernels = thesis_project::matching::kernels;
+
+namespace {
+cv::Mat randomMat(int rows, int cols, int type, int seed) {
+    cv::Mat m(rows, cols, type);
+    cv::RNG rng(seed);
+    if (type == CV_8U) rng.fill(m, cv::RNG::UNIFORM, 0, 256);
+    else rng.fill(m, cv::RNG::UNIFORM, 0.0f, 1.0f);
+    return m;
+}
+
+// Reference top-2 via knnMatch, compared against the blocked kernel
+void expectSameTopTwo(const cv::Mat& q, const cv::Mat& t, int normType) {
+    kernels::TopTwo nn;
+    kernels::topTwoNeighbours(q, t, normType, nn);
+
+    std::vector<std::vector<cv::DMatch>> knn;
+    cv::BFMatcher(normType, false).knnMatch(q, t, knn, 2);
+    ASSERT_EQ(knn.size(), static_cast<size_t>(q.rows));
+    for (int r = 0; r < q.rows; ++r) {
+        ASSERT_EQ(knn[r].size(), 2u);
+        EXPECT_NEAR(nn.dist1[r], knn[r][0].distance, 1e-3f * std::max(1.0f, knn[r][0].distance));
+        EXPECT_NEAR(nn.dist2[r], knn[r][1].distance, 1e-3f * std::max(1.0f, knn[r][1].distance));
+        if (knn[r][0].distance < knn[r][1].distance) {
+            EXPECT_EQ(nn.idx1[r], knn[r][0].trainIdx);
+        }
+    }
+}
+}
+
+TEST(DistanceKernelsTest, TopTwoMatchesKnnL2) {
+    // Sizes straddle the query/train block boundaries
+    expectSameTopTwo(randomMat(130, 128, CV_32F, 1), randomMat(700, 128, CV_32F, 2), cv::NORM_L2);
+}
+
+TEST(DistanceKernelsTest, TopTwoMatchesKnnL1) {
+    expectSameTopTwo(randomMat(70, 36, CV_32F, 3), randomMat(90, 36, CV_32F, 4), cv::NORM_L1);
+}
+
+TEST(DistanceKernelsTest, TopTwoMatchesKnnHamming) {
+    expectSameTopTwo(randomMat(65, 32, CV_8U, 5), randomMat(80, 32, CV_8U, 6), cv::NORM_HAMMING);
+}
+
+TEST(DistanceKernelsTest, MismatchedWidthThrows) {
+    kernels::TopTwo nn;
+    EXPECT_THROW(kernels::topTwoNeighbours(randomMat(4, 8, CV_32F, 7), randomMat(4, 16, CV_32F, 8), cv::NORM_L2, nn),
+                 std::invalid_argument);
+}
+
+TEST(RatioTestMatchingTest, KeepsOnlyDistinctiveMatches) {
+    cv::Mat train = randomMat(200, 64, CV_32F, 9);
+    cv::Mat query = train.rowRange(0, 50).clone();
+    // Query 0 is ambiguous: exactly halfway between two train rows
+    query.row(0) = (train.row(10) + train.row(11)) * 0.5;
+
+    RatioTestMatching matcher(cv::NORM_L2, 0.8f);
+    auto matches = matcher.matchDescriptors(query, train);
+
+    bool ambiguousKept = false;
+    int identity = 0;
+    for (const auto& m : matches) {
+        if (m.queryIdx == 0) ambiguousKept = true;
+        if (m.queryIdx == m.trainIdx) ++identity;
+    }
+    EXPECT_FALSE(ambiguousKept);
+    EXPECT_EQ(identity, 49);
+}
+
+TEST(RatioTestMatchingTest, RatioOneKeepsEveryNearestNeighbour) {
+    cv::Mat query = randomMat(40, 32, CV_32F, 10);
+    cv::Mat train = randomMat(60, 32, CV_32F, 11);
+    RatioTestMatching matcher(cv::NORM_L2, 1.0f);
+    EXPECT_EQ(matcher.matchDescriptors(query, train).size(), 40u);
+    EXPECT_TRUE(matcher.matchDescriptors(cv::Mat(), train).empty());
+}
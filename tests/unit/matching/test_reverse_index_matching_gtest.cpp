@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+#include <set>
+
+#include "src/core/matching/ReverseIndexMatching.hpp"
+#include "src/core/matching/BruteForceMatching.hpp"
+#include "src/core/matching/MatchingFactory.hpp"
+
+using thesis_project::matching::ReverseIndexMatching;
+using thesis_project::matching::BruteForceMatching;
+using thesis_project::matching::MatchingFactory;
+
+namespace {
+cv::Mat randomFloat(int rows, int cols, int seed) {
+    cv::Mat m(rows, cols, CV_32F);
+    cv::RNG rng(seed);
+    rng.fill(m, cv::RNG::UNIFORM, 0.0f, 1.0f);
+    return m;
+}
+
+// Exact matcher that records which buffers were used as the train side
+class RecordingMatcher : public BruteForceMatching {
+public:
+    RecordingMatcher() : BruteForceMatching(cv::NORM_L2, false) {}
+    std::vector<cv::DMatch> matchDescriptors(const cv::Mat& d1, const cv::Mat& d2) override {
+        trainBuffers.insert(d2.data);
+        return BruteForceMatching::matchDescriptors(d1, d2);
+    }
+    std::set<const uchar*> trainBuffers;
+};
+}
+
+TEST(ReverseIndexMatchingTest, KeepsEveryMutualMatchAndOnePerQuery) {
+    cv::Mat d1 = randomFloat(150, 32, 1);
+    cv::Mat d2 = randomFloat(200, 32, 2);
+    ReverseIndexMatching reverse(std::make_unique<BruteForceMatching>(cv::NORM_L2, false));
+    auto matches = reverse.matchDescriptors(d1, d2);
+
+    std::set<int> queries;
+    for (const auto& m : matches) {
+        EXPECT_TRUE(queries.insert(m.queryIdx).second);
+        EXPECT_NEAR(m.distance, cv::norm(d1.row(m.queryIdx), d2.row(m.trainIdx), cv::NORM_L2), 1e-4);
+    }
+
+    BruteForceMatching mutual(cv::NORM_L2, true);
+    std::set<std::pair<int, int>> got;
+    for (const auto& m : matches) got.insert({m.queryIdx, m.trainIdx});
+    for (const auto& m : mutual.matchDescriptors(d1, d2)) {
+        EXPECT_TRUE(got.count({m.queryIdx, m.trainIdx})) << "missing mutual pair " << m.queryIdx;
+    }
+}
+
+TEST(ReverseIndexMatchingTest, TrainSideIsAlwaysDescriptors1) {
+    cv::Mat d1 = randomFloat(100, 16, 3);
+    auto recorder = std::make_unique<RecordingMatcher>();
+    RecordingMatcher* raw = recorder.get();
+    ReverseIndexMatching reverse(std::move(recorder));
+    for (int i = 0; i < 5; ++i) reverse.matchDescriptors(d1, randomFloat(120, 16, 10 + i));
+    ASSERT_EQ(raw->trainBuffers.size(), 1u);
+    EXPECT_EQ(*raw->trainBuffers.begin(), d1.data);
+}
+
+TEST(ReverseIndexMatchingTest, FactoryWrapsIndexBasedMethods) {
+    thesis_project::EvaluationParams params;
+    params.reuse_query_index = true;
+    params.matching_method = thesis_project::MatchingMethod::FLANN;
+    auto flann = MatchingFactory::createFromConfig(params);
+    EXPECT_EQ(flann->getName(), "FLANN+ReverseIndex");
+    EXPECT_TRUE(flann->isApproximate());
+
+    params.matching_method = thesis_project::MatchingMethod::BRUTE_FORCE;
+    EXPECT_EQ(MatchingFactory::createFromConfig(params)->getName(), "BruteForce");
+}
@@ -85,12 +85,11 @@ TEST_F(ExperimentMetricsTest, AddQueryAPWithMatch) {
     
     EXPECT_EQ(metrics.total_queries_processed, 1);
     EXPECT_EQ(metrics.total_queries_excluded, 0);
-    ASSERT_EQ(metrics.ap_per_query.size(), 1);
-    EXPECT_DOUBLE_EQ(metrics.ap_per_query[0], 0.8);
-    ASSERT_EQ(metrics.per_scene_ap["test_scene"].size(), 1);
-    EXPECT_DOUBLE_EQ(metrics.per_scene_ap["test_scene"][0], 0.8);
-    ASSERT_EQ(metrics.ranks_per_query.size(), 1);
-    EXPECT_EQ(metrics.ranks_per_query[0], 2);
+    EXPECT_DOUBLE_EQ(metrics.ap_sum, 0.8);
+    ASSERT_EQ(metrics.per_scene_ap["test_scene"].queries, 1);
+    EXPECT_DOUBLE_EQ(metrics.per_scene_ap["test_scene"].ap_sum, 0.8);
+    EXPECT_EQ(metrics.rank_histogram.ranked(), 1);
+    EXPECT_EQ(metrics.rank_histogram.counts[2], 1);
 }
 
 TEST_F(ExperimentMetricsTest, AddQueryAPWithoutMatch) {
@@ -104,11 +103,11 @@ TEST_F(ExperimentMetricsTest, AddQueryAPWithoutMatch) {
     
     EXPECT_EQ(metrics.total_queries_processed, 0);
     EXPECT_EQ(metrics.total_queries_excluded, 1);
-    EXPECT_TRUE(metrics.ap_per_query.empty());
-    EXPECT_TRUE(metrics.per_scene_ap["test_scene"].empty());
+    EXPECT_DOUBLE_EQ(metrics.ap_sum, 0.0);
+    EXPECT_EQ(metrics.per_scene_ap.count("test_scene"), 0);
     EXPECT_EQ(metrics.per_scene_excluded["test_scene"], 1);
-    ASSERT_EQ(metrics.ranks_per_query.size(), 1);
-    EXPECT_EQ(metrics.ranks_per_query[0], -1);
+    EXPECT_EQ(metrics.rank_histogram.ranked(), 0);
+    EXPECT_EQ(metrics.rank_histogram.missing, 1);
 }
 
 TEST_F(ExperimentMetricsTest, CalculateMeanPrecisionBasic) {
@@ -151,7 +150,9 @@ TEST_F(ExperimentMetricsTest, CalculateMeanPrecisionWithTrueMAPData) {
 
 TEST_F(ExperimentMetricsTest, CalculatePrecisionAtK) {
     // Add rank data for P@K/R@K calculation
-    metrics.ranks_per_query = {1, 3, 1, 5, -1, 2, 10, 1};  // 7 valid ranks, 1 R=0
+    for (int rank : {1, 3, 1, 5, -1, 2, 10, 1}) {  // 7 valid ranks, 1 R=0
+        metrics.rank_histogram.add(rank);
+    }
     
     metrics.calculateMeanPrecision();
     
@@ -319,4 +320,93 @@ TEST_F(ExperimentMetricsTest, TrueMAPIncludingZeros) {
     
     // Including zeros mAP: (0.8 + 0.0 + 0.8) / 3 = 0.533 (includes R=0 as AP=0)
     EXPECT_NEAR(metrics.true_map_micro_including_zeros, 0.533333, 1e-6);
-}
\ No newline at end of file
+}
+TEST_F(ExperimentMetricsTest, RankHistogramOverflowCountsAsRanked) {
+    for (int rank : {1, 150, 100, 101, 4}) metrics.rank_histogram.add(rank);
+    EXPECT_EQ(metrics.rank_histogram.ranked(), 5);
+    EXPECT_EQ(metrics.rank_histogram.overflow, 2);
+    EXPECT_EQ(metrics.rank_histogram.atMost(5), 2);
+
+    metrics.calculateMeanPrecision();
+    EXPECT_NEAR(metrics.precision_at_1, 1.0 / 5.0, 1e-12);
+    EXPECT_NEAR(metrics.precision_at_10, 2.0 / 5.0, 1e-12);
+}
+
+TEST_F(ExperimentMetricsTest, MergeStreamingAPState) {
+    TrueAveragePrecision::QueryAPResult hit;
+    hit.ap = 1.0; hit.has_potential_match = true; hit.rank_of_true_match = 1;
+    TrueAveragePrecision::QueryAPResult miss;
+    miss.ap = 0.25; miss.has_potential_match = true; miss.rank_of_true_match = 4;
+    TrueAveragePrecision::QueryAPResult none;
+
+    metrics.addQueryAP("scene1", hit);
+    metrics.addQueryAP("scene1", none);
+    ExperimentMetrics other;
+    other.addQueryAP("scene1", miss);
+    other.addQueryAP("scene2", hit);
+    metrics.merge(other);
+    metrics.calculateMeanPrecision();
+
+    EXPECT_EQ(metrics.per_scene_ap["scene1"].queries, 2);
+    EXPECT_DOUBLE_EQ(metrics.per_scene_ap["scene1"].ap_sum, 1.25);
+    EXPECT_NEAR(metrics.true_map_micro, 2.25 / 3.0, 1e-12);
+    EXPECT_NEAR(metrics.true_map_macro_by_scene, (0.625 + 1.0) / 2.0, 1e-12);
+    EXPECT_NEAR(metrics.true_map_micro_including_zeros, 2.25 / 4.0, 1e-12);
+    EXPECT_NEAR(metrics.precision_at_1, 2.0 / 3.0, 1e-12);
+    EXPECT_EQ(metrics.rank_histogram.missing, 1);
+}
+
+TEST_F(ExperimentMetricsTest, BootstrapCIBracketsPointEstimates) {
+    // Six scenes with different difficulty so resamples actually vary
+    const std::vector<double> scene_aps = {0.2, 0.35, 0.5, 0.6, 0.8, 0.95};
+    for (size_t s = 0; s < scene_aps.size(); ++s) {
+        for (int q = 0; q < 20; ++q) {
+            TrueAveragePrecision::QueryAPResult r;
+            r.has_potential_match = true;
+            r.ap = scene_aps[s];
+            r.rank_of_true_match = (q % 10) < static_cast<int>(scene_aps[s] * 10) ? 1 : 3;
+            metrics.addQueryAP("scene" + std::to_string(s), r);
+        }
+    }
+    metrics.calculateMeanPrecision();
+    metrics.computeBootstrapCI(500, 0.9, 7);
+
+    EXPECT_EQ(metrics.bootstrap_resamples, 500);
+    EXPECT_LE(metrics.true_map_micro_ci.lower, metrics.true_map_micro);
+    EXPECT_GE(metrics.true_map_micro_ci.upper, metrics.true_map_micro);
+    EXPECT_LT(metrics.true_map_micro_ci.lower, metrics.true_map_micro_ci.upper);
+    EXPECT_LE(metrics.true_map_macro_ci.lower, metrics.true_map_macro_by_scene);
+    EXPECT_GE(metrics.true_map_macro_ci.upper, metrics.true_map_macro_by_scene);
+    EXPECT_LE(metrics.precision_at_1_ci.lower, metrics.precision_at_1);
+    EXPECT_GE(metrics.precision_at_1_ci.upper, metrics.precision_at_1);
+    EXPECT_GE(metrics.true_map_micro_ci.lower, 0.2);
+    EXPECT_LE(metrics.true_map_micro_ci.upper, 0.95);
+
+    // Same seed gives the same interval
+    ExperimentMetrics again = metrics;
+    again.computeBootstrapCI(500, 0.9, 7);
+    EXPECT_DOUBLE_EQ(again.true_map_micro_ci.lower, metrics.true_map_micro_ci.lower);
+    EXPECT_DOUBLE_EQ(again.precision_at_1_ci.upper, metrics.precision_at_1_ci.upper);
+}
+
+TEST_F(ExperimentMetricsTest, BootstrapCISkippedWithoutScenes) {
+    metrics.computeBootstrapCI(100);
+    EXPECT_EQ(metrics.bootstrap_resamples, 0);
+    EXPECT_EQ(metrics.true_map_micro_ci.lower, 0.0);
+    EXPECT_EQ(metrics.true_map_micro_ci.upper, 0.0);
+}
+
+TEST_F(ExperimentMetricsTest, TopKMissesDoNotCountBeyondK) {
+    // ground_truth.top_k = 5 with multi relevance: one hit at rank 2, three misses
+    const std::vector<int> ranked = {7, 3, 8, 9, 6};
+    metrics.addQueryAP("scene1", TrueAveragePrecision::computeQueryAPFromTopK(ranked.data(), 5, {3}));
+    for (int q = 0; q < 3; ++q) {
+        metrics.addQueryAP("scene1", TrueAveragePrecision::computeQueryAPFromTopK(ranked.data(), 5, {40 + q}));
+    }
+    metrics.calculateMeanPrecision();
+
+    EXPECT_NEAR(metrics.precision_at_1, 0.0, 1e-12);
+    EXPECT_NEAR(metrics.precision_at_5, 1.0 / 4.0, 1e-12);
+    EXPECT_NEAR(metrics.precision_at_10, 1.0 / 4.0, 1e-12);  // misses stay misses above K
+    EXPECT_NEAR(metrics.recall_at_10, 1.0 / 4.0, 1e-12);
+}
@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+#include "src/core/metrics/HPatchesTasks.hpp"
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Reference metrics over a fully sorted (score, label) list; scores must be distinct
+struct SortedMetrics { double ap; double auc; double fpr95; };
+
+SortedMetrics sortedMetrics(std::vector<std::pair<double, bool>> scored) {
+    std::sort(scored.begin(), scored.end());
+    long positives = 0, negatives = 0;
+    for (const auto& s : scored) (s.second ? positives : negatives)++;
+
+    SortedMetrics m{0.0, 0.0, 0.0};
+    long tp = 0, fp = 0;
+    bool fpr_set = false;
+    for (const auto& s : scored) {
+        if (s.second) {
+            ++tp;
+            m.ap += static_cast<double>(tp) / static_cast<double>(tp + fp);
+            m.auc += static_cast<double>(negatives - fp);
+        } else {
+            ++fp;
+        }
+        if (!fpr_set && tp >= 0.95 * positives) {
+            m.fpr95 = static_cast<double>(fp) / static_cast<double>(negatives);
+            fpr_set = true;
+        }
+    }
+    m.ap /= static_cast<double>(positives);
+    m.auc /= static_cast<double>(positives) * static_cast<double>(negatives);
+    return m;
+}
+
+// Scene clusters: each track's reference and positives sit near one random centre
+void addClusteredTracks(HPatchesTasks::Evaluator& tasks, int scenes, int tracks_per_scene, float noise, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> centre(0.0f, 10.0f), jitter(0.0f, noise);
+    for (int s = 0; s < scenes; ++s) {
+        for (int t = 0; t < tracks_per_scene; ++t) {
+            cv::Mat c(1, 16, CV_32F);
+            for (int d = 0; d < 16; ++d) c.at<float>(0, d) = centre(rng);
+            std::vector<cv::Mat> positives;
+            for (int j = 0; j < 5; ++j) {
+                cv::Mat p = c.clone();
+                for (int d = 0; d < 16; ++d) p.at<float>(0, d) += jitter(rng);
+                positives.push_back(p);
+            }
+            tasks.addTrack("scene_" + std::to_string(s), c, positives);
+        }
+    }
+}
+
+} // namespace
+
+TEST(HPatchesTasksTest, HistogramMetricsMatchSortedReference) {
+    // One distinct integer score per bin, so the histogram is exact
+    const int n = 500;
+    std::vector<int> scores(n);
+    for (int i = 0; i < n; ++i) scores[i] = i;
+    std::mt19937 rng(3);
+    std::shuffle(scores.begin(), scores.end(), rng);
+
+    HPatchesTasks::ScoreHistogram hist(n, n);
+    std::vector<std::pair<double, bool>> scored;
+    std::bernoulli_distribution label(0.3);
+    for (int s : scores) {
+        // Positives lean towards low distances
+        const bool positive = s < n / 4 ? !label(rng) : label(rng);
+        hist.add(s, positive);
+        scored.emplace_back(s, positive);
+    }
+
+    const SortedMetrics ref = sortedMetrics(scored);
+    EXPECT_NEAR(hist.averagePrecision(), ref.ap, 1e-12);
+    EXPECT_NEAR(hist.rocAuc(), ref.auc, 1e-12);
+    EXPECT_NEAR(hist.fprAtRecall(0.95), ref.fpr95, 1e-12);
+}
+
+TEST(HPatchesTasksTest, HistogramMergeEqualsSingleHistogram) {
+    HPatchesTasks::ScoreHistogram a(10.0, 64), b(10.0, 64), all(10.0, 64);
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> score(0.0, 12.0);  // some scores past max_score
+    for (int i = 0; i < 200; ++i) {
+        const double s = score(rng);
+        const bool positive = (i % 3) == 0;
+        (i % 2 ? a : b).add(s, positive);
+        all.add(s, positive);
+    }
+    a.merge(b);
+    EXPECT_EQ(a.positives(), all.positives());
+    EXPECT_EQ(a.negatives(), all.negatives());
+    EXPECT_DOUBLE_EQ(a.averagePrecision(), all.averagePrecision());
+    EXPECT_DOUBLE_EQ(a.rocAuc(), all.rocAuc());
+
+    HPatchesTasks::ScoreHistogram other(5.0, 64);
+    EXPECT_THROW(a.merge(other), std::invalid_argument);
+}
+
+TEST(HPatchesTasksTest, SeparableTracksVerifyPerfectly) {
+    HPatchesTasks::Evaluator tasks;
+    addClusteredTracks(tasks, 3, 20, 0.01f, 7);
+    ASSERT_EQ(tasks.tracks(), 60u);
+    ASSERT_EQ(tasks.scenes(), 3u);
+
+    const auto v = tasks.evaluateVerification(42);
+    EXPECT_EQ(v.positive_pairs, 60 * 5);
+    EXPECT_EQ(v.negative_pairs, 2 * 60 * 5);  // one intra and one inter negative per positive
+    EXPECT_NEAR(v.ap_intra, 1.0, 1e-9);
+    EXPECT_NEAR(v.ap_inter, 1.0, 1e-9);
+    EXPECT_NEAR(v.roc_auc, 1.0, 1e-9);
+    EXPECT_NEAR(v.fpr95, 0.0, 1e-9);
+
+    // Same seed, same pairs
+    const auto again = tasks.evaluateVerification(42);
+    EXPECT_DOUBLE_EQ(again.roc_auc, v.roc_auc);
+    EXPECT_DOUBLE_EQ(again.fpr95, v.fpr95);
+}
+
+TEST(HPatchesTasksTest, NoisyTracksDegradeVerification) {
+    HPatchesTasks::Evaluator clean, noisy;
+    addClusteredTracks(clean, 2, 30, 0.5f, 9);
+    addClusteredTracks(noisy, 2, 30, 25.0f, 9);
+    EXPECT_GT(clean.evaluateVerification().roc_auc, noisy.evaluateVerification().roc_auc);
+    EXPECT_LT(clean.evaluateVerification().fpr95, noisy.evaluateVerification().fpr95);
+}
+
+TEST(HPatchesTasksTest, RetrievalExactAndHnswAgreeOnSeparableTracks) {
+    HPatchesTasks::Evaluator tasks;
+    addClusteredTracks(tasks, 4, 25, 0.01f, 13);
+
+    const auto exact = tasks.evaluateRetrieval(5);
+    EXPECT_EQ(exact.queries, 100);
+    EXPECT_EQ(exact.pool_size, 500);
+    EXPECT_EQ(exact.top_k, 5);
+    EXPECT_FALSE(exact.approximate);
+    EXPECT_NEAR(exact.map, 1.0, 1e-9);  // the five nearest pool rows are the track's own
+
+    thesis_project::matching::HnswParams ann;
+    ann.ef_search = 64;
+    const auto approx = tasks.evaluateRetrieval(5, &ann);
+    EXPECT_TRUE(approx.approximate);
+    EXPECT_NEAR(approx.map, exact.map, 0.02);
+
+    // top_k larger than the pool is clamped
+    EXPECT_EQ(tasks.evaluateRetrieval(100000).top_k, 500);
+    EXPECT_THROW(tasks.evaluateRetrieval(0), std::invalid_argument);
+}
+
+TEST(HPatchesTasksTest, BinaryTracksUseHamming) {
+    HPatchesTasks::Evaluator tasks(cv::NORM_HAMMING);
+    std::mt19937 rng(17);
+    std::uniform_int_distribution<int> byte(0, 255);
+    for (int t = 0; t < 20; ++t) {
+        cv::Mat ref(1, 32, CV_8U);
+        for (int d = 0; d < 32; ++d) ref.at<uchar>(0, d) = static_cast<uchar>(byte(rng));
+        tasks.addTrack(t < 10 ? "a" : "b", ref, {ref.clone(), ref.clone()});
+    }
+    EXPECT_NEAR(tasks.evaluateRetrieval(2).map, 1.0, 1e-9);
+    EXPECT_NEAR(tasks.evaluateVerification().roc_auc, 1.0, 1e-9);
+}
+
+TEST(HPatchesTasksTest, RejectsMismatchedTracks) {
+    HPatchesTasks::Evaluator tasks;
+    tasks.addTrack("s", cv::Mat::zeros(1, 8, CV_32F), {cv::Mat::ones(1, 8, CV_32F)});
+    EXPECT_THROW(tasks.addTrack("s", cv::Mat::zeros(1, 4, CV_32F), {cv::Mat::ones(1, 4, CV_32F)}),
+                 std::invalid_argument);
+    EXPECT_THROW(tasks.addTrack("s", cv::Mat::zeros(1, 8, CV_8U), {cv::Mat::ones(1, 8, CV_8U)}),
+                 std::invalid_argument);
+    EXPECT_THROW(tasks.addTrack("s", cv::Mat::zeros(2, 8, CV_32F), {cv::Mat::ones(1, 8, CV_32F)}),
+                 std::invalid_argument);
+    EXPECT_THROW({ HPatchesTasks::Evaluator bad(cv::NORM_INF); }, std::invalid_argument);
+    EXPECT_EQ(tasks.tracks(), 1u);
+}
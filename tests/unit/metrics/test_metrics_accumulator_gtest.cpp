@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include "src/core/metrics/MetricsAccumulator.hpp"
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Sample {
+    std::string scene;
+    TrueAveragePrecision::QueryAPResult ap;
+};
+
+std::vector<Sample> makeSamples(int count, unsigned seed) {
+    const std::vector<std::string> scenes = {"v_wall", "i_dome", "v_boat", "i_ajuntament"};
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::uniform_int_distribution<int> rank(1, 30);
+    std::vector<Sample> samples;
+    for (int i = 0; i < count; ++i) {
+        Sample s;
+        s.scene = scenes[rng() % scenes.size()];
+        if (unit(rng) < 0.2) {
+            s.ap.has_potential_match = false;
+        } else {
+            s.ap.has_potential_match = true;
+            s.ap.rank_of_true_match = rank(rng);
+            s.ap.ap = 1.0 / s.ap.rank_of_true_match;
+        }
+        samples.push_back(s);
+    }
+    return samples;
+}
+
+void expectSameSummary(const ExperimentMetrics& got, const ExperimentMetrics& ref) {
+    EXPECT_NEAR(got.true_map_micro, ref.true_map_micro, 1e-12);
+    EXPECT_NEAR(got.true_map_macro_by_scene, ref.true_map_macro_by_scene, 1e-12);
+    EXPECT_NEAR(got.true_map_micro_including_zeros, ref.true_map_micro_including_zeros, 1e-12);
+    EXPECT_NEAR(got.true_map_macro_by_scene_including_zeros, ref.true_map_macro_by_scene_including_zeros, 1e-12);
+    EXPECT_DOUBLE_EQ(got.precision_at_1, ref.precision_at_1);
+    EXPECT_DOUBLE_EQ(got.precision_at_5, ref.precision_at_5);
+    EXPECT_DOUBLE_EQ(got.precision_at_10, ref.precision_at_10);
+    EXPECT_DOUBLE_EQ(got.recall_at_10, ref.recall_at_10);
+    EXPECT_NEAR(got.mean_precision, ref.mean_precision, 1e-12);
+    EXPECT_NEAR(got.legacy_macro_precision_by_scene, ref.legacy_macro_precision_by_scene, 1e-12);
+    EXPECT_EQ(got.total_queries_processed, ref.total_queries_processed);
+    EXPECT_EQ(got.total_queries_excluded, ref.total_queries_excluded);
+    EXPECT_EQ(got.total_matches, ref.total_matches);
+    EXPECT_EQ(got.total_keypoints, ref.total_keypoints);
+    EXPECT_EQ(got.total_images_processed, ref.total_images_processed);
+    EXPECT_EQ(got.per_scene_excluded, ref.per_scene_excluded);
+    EXPECT_EQ(got.per_scene_matches, ref.per_scene_matches);
+    EXPECT_EQ(got.per_scene_image_count, ref.per_scene_image_count);
+}
+
+} // namespace
+
+TEST(MetricsAccumulatorTest, SingleAccumulatorMatchesExperimentMetrics) {
+    const auto samples = makeSamples(2000, 1);
+    ExperimentMetrics ref;
+    MetricsAccumulator acc;
+    for (const auto& s : samples) {
+        ref.addQueryAP(s.scene, s.ap);
+        acc.addQueryAP(acc.sceneId(s.scene), s.ap);
+    }
+    ref.addImageResult("v_wall", 0.5, 10, 20);
+    ref.addImageResult("i_dome", 0.25, 5, 40);
+    ref.addImageResult("v_wall", 0.75, 15, 20);
+    acc.addImageResult(acc.sceneId("v_wall"), 0.5, 10, 20);
+    acc.addImageResult(acc.sceneId("i_dome"), 0.25, 5, 40);
+    acc.addImageResult(acc.sceneId("v_wall"), 0.75, 15, 20);
+    ref.calculateMeanPrecision();
+
+    expectSameSummary(acc.toExperimentMetrics(), ref);
+}
+
+TEST(MetricsAccumulatorTest, PerThreadMergeMatchesSerial) {
+    const auto samples = makeSamples(5000, 2);
+    ExperimentMetrics ref;
+    for (const auto& s : samples) ref.addQueryAP(s.scene, s.ap);
+    ref.calculateMeanPrecision();
+
+    // Interleaved partition: every worker sees every scene, in a different first-seen order
+    std::vector<MetricsAccumulator> workers(4);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        auto& w = workers[(i * 7) % workers.size()];
+        w.addQueryAP(w.sceneId(samples[i].scene), samples[i].ap);
+    }
+    MetricsAccumulator merged;
+    for (const auto& w : workers) merged.merge(w);
+
+    EXPECT_EQ(merged.sceneNames().size(), 4u);
+    expectSameSummary(merged.toExperimentMetrics(), ref);
+}
+
+TEST(MetricsAccumulatorTest, InternsSceneNames) {
+    MetricsAccumulator acc;
+    const int a = acc.sceneId("a");
+    const int b = acc.sceneId("b");
+    EXPECT_NE(a, b);
+    EXPECT_EQ(acc.sceneId("a"), a);
+    EXPECT_EQ(acc.sceneNames().size(), 2u);
+}
+
+TEST(MetricsAccumulatorTest, EmptyAccumulatorGivesZeros) {
+    MetricsAccumulator acc;
+    EXPECT_TRUE(acc.empty());
+    const auto m = acc.toExperimentMetrics();
+    EXPECT_TRUE(m.success);
+    EXPECT_EQ(m.true_map_micro, 0.0);
+    EXPECT_EQ(m.precision_at_1, 0.0);
+    EXPECT_EQ(m.total_queries_processed, 0);
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include "src/core/metrics/StratifiedEstimator.hpp"
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+TEST(StratifiedEstimatorTest, FullSampleGivesPopulationMeanWithZeroError) {
+    StratifiedEstimator est;
+    const std::vector<double> a = {0.2, 0.4, 0.6};
+    const std::vector<double> b = {1.0};
+    est.addPopulation("v_a", 3);
+    est.addPopulation("i_b", 1);
+    for (double v : a) est.addSample("v_a", v);
+    for (double v : b) est.addSample("i_b", v);
+
+    const auto e = est.estimate();
+    EXPECT_NEAR(e.mean, (0.2 + 0.4 + 0.6 + 1.0) / 4.0, 1e-12);
+    EXPECT_NEAR(e.standard_error, 0.0, 1e-12);  // finite-population correction
+    EXPECT_EQ(e.sampled, 4);
+    EXPECT_EQ(e.population, 4);
+
+    EXPECT_NEAR(est.estimate("v_").mean, 0.4, 1e-12);
+    EXPECT_NEAR(est.estimate("i_").mean, 1.0, 1e-12);
+    EXPECT_EQ(est.estimate("x_").population, 0);
+}
+
+TEST(StratifiedEstimatorTest, WeightsStrataByPopulation) {
+    StratifiedEstimator est;
+    est.addPopulation("v_small", 10);
+    est.addPopulation("v_large", 90);
+    for (int i = 0; i < 5; ++i) est.addSample("v_small", 1.0);
+    for (int i = 0; i < 5; ++i) est.addSample("v_large", 0.0);
+    // Equal samples per stratum, but the large stratum carries 90% of the weight
+    EXPECT_NEAR(est.estimate().mean, 0.1, 1e-12);
+}
+
+TEST(StratifiedEstimatorTest, StandardErrorCoversSamplingSpread) {
+    // Synthetic population: four scenes with different AP levels
+    std::mt19937 rng(5);
+    std::vector<std::string> scenes = {"v_a", "v_b", "i_c", "i_d"};
+    std::vector<std::vector<double>> population(scenes.size());
+    double total = 0.0;
+    long count = 0;
+    for (size_t s = 0; s < scenes.size(); ++s) {
+        std::uniform_real_distribution<double> ap(0.1 * s, 0.1 * s + 0.5);
+        population[s].resize(1000 + 300 * s);
+        for (double& v : population[s]) { v = ap(rng); total += v; ++count; }
+    }
+    const double truth = total / count;
+
+    int covered = 0;
+    const int trials = 200;
+    for (int t = 0; t < trials; ++t) {
+        StratifiedEstimator est;
+        for (size_t s = 0; s < scenes.size(); ++s) {
+            const auto idx = StratifiedEstimator::sampleIndices(static_cast<int>(population[s].size()), 0.05, 0,
+                                                                StratifiedEstimator::pairSeed(t, scenes[s], 1));
+            est.addPopulation(scenes[s], static_cast<long>(population[s].size()));
+            for (int i : idx) est.addSample(scenes[s], population[s][i]);
+        }
+        const auto e = est.estimate();
+        EXPECT_GT(e.standard_error, 0.0);
+        if (std::abs(e.mean - truth) <= 1.96 * e.standard_error) ++covered;
+    }
+    // Nominal 95% coverage; allow for Monte Carlo noise
+    EXPECT_GE(covered, static_cast<int>(0.88 * trials));
+}
+
+TEST(StratifiedEstimatorTest, SampleIndicesAreSortedUniqueAndSeeded) {
+    const auto a = StratifiedEstimator::sampleIndices(1000, 0.1, 0, 7);
+    const auto b = StratifiedEstimator::sampleIndices(1000, 0.1, 0, 7);
+    const auto c = StratifiedEstimator::sampleIndices(1000, 0.1, 0, 8);
+    ASSERT_EQ(a.size(), 100u);
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+    for (size_t i = 1; i < a.size(); ++i) EXPECT_LT(a[i - 1], a[i]);
+
+    EXPECT_EQ(StratifiedEstimator::sampleIndices(1000, 0.5, 25, 7).size(), 25u);  // cap wins
+    EXPECT_EQ(StratifiedEstimator::sampleIndices(10, 0.01, 0, 7).size(), 1u);     // at least one
+    EXPECT_EQ(StratifiedEstimator::sampleIndices(10, 1.0, 0, 7).size(), 10u);
+    EXPECT_TRUE(StratifiedEstimator::sampleIndices(0, 0.5, 0, 7).empty());
+    EXPECT_NE(StratifiedEstimator::pairSeed(1, "v_a", 1), StratifiedEstimator::pairSeed(1, "v_a", 2));
+}
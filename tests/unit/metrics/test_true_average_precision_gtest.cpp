@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 #include "src/core/metrics/TrueAveragePrecision.hpp"
+#include "src/core/metrics/PrecisionRecallCurve.hpp"
+#include <random>
 #include <vector>
 #include <array>
 #include <cmath>
@@ -244,6 +246,144 @@ TEST_F(TrueAveragePrecisionTest, EuclideanDistanceCalculation) {
     EXPECT_DOUBLE_EQ(TrueAveragePrecision::euclideanDistance(p1, p1), 0.0);        // Same point
 }
 
+TEST_F(TrueAveragePrecisionTest, KeypointGridMatchesLinearScan) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> coord(0.0, 800.0);
+    std::vector<TrueAveragePrecision::Point2D> points(2000);
+    for (auto& p : points) p = {coord(rng), coord(rng)};
+    points[5] = {std::nan(""), 10.0};  // non-finite points are never relevant
+
+    const TrueAveragePrecision::KeypointGrid grid(points, 3.0);
+    std::vector<int> found;
+    for (int i = 0; i < 300; ++i) {
+        const TrueAveragePrecision::Point2D query(coord(rng), coord(rng));
+        EXPECT_EQ(TrueAveragePrecision::findSingleRelevantIndex(query, identity_H, grid, 3.0),
+                  TrueAveragePrecision::findSingleRelevantIndex(query, identity_H, points, 3.0));
+
+        std::vector<int> expected;
+        for (int k = 0; k < static_cast<int>(points.size()); ++k) {
+            if (TrueAveragePrecision::euclideanDistance(query, points[k]) <= 8.0) expected.push_back(k);
+        }
+        grid.withinRadius(query, 8.0, found);  // radius wider than a cell
+        EXPECT_EQ(found, expected);
+    }
+}
+
+TEST_F(TrueAveragePrecisionTest, MultiRelevantAPRanksEveryKeypointWithinTau) {
+    // Three keypoints within 3px of (110, 205); ranked 1st, 3rd and 4th by distance
+    const std::vector<TrueAveragePrecision::Point2D> points = {
+        {110.0, 205.0}, {300.0, 300.0}, {111.0, 206.0}, {108.0, 204.0}, {500.0, 500.0}};
+    const std::vector<double> distances = {0.1, 0.2, 0.4, 0.3, 0.9};
+    const TrueAveragePrecision::KeypointGrid grid(points, 3.0);
+
+    auto result = TrueAveragePrecision::computeQueryAPMultiRelevant(keypoints_A[0], translation_H, grid, distances, 3.0);
+    EXPECT_TRUE(result.has_potential_match);
+    EXPECT_EQ(result.total_relevant, 3);
+    EXPECT_EQ(result.rank_of_true_match, 1);
+    EXPECT_NEAR(result.ap, (1.0 + 2.0 / 3.0 + 3.0 / 4.0) / 3.0, 1e-12);
+    EXPECT_NEAR(result.ap, TrueAveragePrecision::computeAveragePrecision({1, 0, 1, 1, 0}), 1e-12);
+
+    // Single policy only keeps the nearest keypoint (index 0, ranked first)
+    auto single = TrueAveragePrecision::computeQueryAP(keypoints_A[0], translation_H, grid, distances, 3.0);
+    EXPECT_EQ(single.total_relevant, 1);
+    EXPECT_DOUBLE_EQ(single.ap, 1.0);
+
+    auto none = TrueAveragePrecision::computeQueryAPMultiRelevant({0.0, 0.0}, identity_H, grid, distances, 3.0);
+    EXPECT_FALSE(none.has_potential_match);
+    EXPECT_EQ(none.total_relevant, 0);
+}
+
+TEST_F(TrueAveragePrecisionTest, MultiRelevantAPMatchesFullSort) {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> coord(0.0, 60.0);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<TrueAveragePrecision::Point2D> points(400);
+    for (auto& p : points) p = {coord(rng), coord(rng)};
+    const TrueAveragePrecision::KeypointGrid grid(points, 4.0);
+
+    std::vector<double> distances(points.size());
+    for (int i = 0; i < 50; ++i) {
+        for (auto& d : distances) d = unit(rng);
+        const TrueAveragePrecision::Point2D query(coord(rng), coord(rng));
+
+        std::vector<int> order(points.size());
+        for (size_t k = 0; k < order.size(); ++k) order[k] = static_cast<int>(k);
+        std::sort(order.begin(), order.end(), [&](int a, int b) { return distances[a] < distances[b]; });
+        std::vector<int> relevance;
+        for (int k : order) relevance.push_back(TrueAveragePrecision::euclideanDistance(query, points[k]) <= 4.0);
+
+        auto result = TrueAveragePrecision::computeQueryAPMultiRelevant(query, identity_H, grid, distances, 4.0);
+        EXPECT_NEAR(result.ap, TrueAveragePrecision::computeAveragePrecision(relevance), 1e-12);
+    }
+}
+
+TEST_F(TrueAveragePrecisionTest, TopKAPMatchesFullRowWithinK) {
+    // Counts give the same rank as the full-row scan (3 closer, 2 ties -> rank 1 + 3 + 1)
+    const std::vector<double> distances = {0.5, 0.1, 0.2, 0.3, 0.5, 0.5, 0.9};
+    const std::vector<TrueAveragePrecision::Point2D> points = {
+        {110.0, 205.0}, {0.0, 0.0}, {20.0, 0.0}, {40.0, 0.0}, {60.0, 0.0}, {80.0, 0.0}, {100.0, 0.0}};
+    auto full = TrueAveragePrecision::computeQueryAP(keypoints_A[0], translation_H, points, distances, 3.0);
+    auto counted = TrueAveragePrecision::computeQueryAPFromCounts(3, 2);
+    EXPECT_EQ(counted.rank_of_true_match, full.rank_of_true_match);
+    EXPECT_DOUBLE_EQ(counted.ap, full.ap);
+    EXPECT_EQ(counted.total_relevant, 1);
+
+    // AP@K equals full AP when every relevant item is inside K, and is a lower bound otherwise
+    const std::vector<int> ranked = {4, 9, 2, 7, -1};
+    auto within = TrueAveragePrecision::computeQueryAPFromTopK(ranked.data(), 4, {2, 4});
+    EXPECT_EQ(within.rank_of_true_match, 1);
+    EXPECT_NEAR(within.ap, TrueAveragePrecision::computeAveragePrecision({1, 0, 1, 0}), 1e-12);
+
+    auto truncated = TrueAveragePrecision::computeQueryAPFromTopK(ranked.data(), 5, {2, 4, 30});
+    EXPECT_EQ(truncated.total_relevant, 3);
+    EXPECT_NEAR(truncated.ap, (1.0 + 2.0 / 3.0) / 3.0, 1e-12);
+
+    auto missed = TrueAveragePrecision::computeQueryAPFromTopK(ranked.data(), 5, {30});
+    EXPECT_TRUE(missed.has_potential_match);
+    EXPECT_EQ(missed.rank_of_true_match, TrueAveragePrecision::kRankBeyondTopK);  // beyond K: a miss for every P@k
+    EXPECT_DOUBLE_EQ(missed.ap, 0.0);
+
+    EXPECT_FALSE(TrueAveragePrecision::computeQueryAPFromTopK(ranked.data(), 5, {}).has_potential_match);
+}
+
+TEST_F(TrueAveragePrecisionTest, PRCurveMergeMatchesGlobalSort) {
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<PrecisionRecallCurve::Stream> streams(5);
+    std::vector<std::pair<double, bool>> all;
+    for (int i = 0; i < 1000; ++i) {
+        const double score = std::round(unit(rng) * 200.0) / 200.0;  // plenty of ties
+        const bool relevant = unit(rng) < 0.4 + 0.4 * (1.0 - score);
+        streams[(i * 3) % streams.size()].add(score, relevant);
+        all.emplace_back(score, relevant);
+    }
+    for (auto& s : streams) s.finish();
+    const long positives = 500;
+
+    std::sort(all.begin(), all.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first || (a.first == b.first && a.second > b.second);
+    });
+    long tp = 0;
+    double ap = 0.0;
+    for (size_t i = 0; i < all.size(); ++i) {
+        if (all[i].second) ap += static_cast<double>(++tp) / static_cast<double>(i + 1);
+    }
+
+    const auto curve = PrecisionRecallCurve::merge(streams, positives, 20);
+    EXPECT_EQ(curve.scored, 1000);
+    EXPECT_NEAR(curve.average_precision, ap / positives, 1e-12);
+    ASSERT_FALSE(curve.points.empty());
+    EXPECT_LE(curve.points.size(), 21u);
+    EXPECT_DOUBLE_EQ(curve.points.back().recall, static_cast<double>(tp) / positives);
+    EXPECT_DOUBLE_EQ(curve.points.back().threshold, all.back().first);
+    for (size_t i = 1; i < curve.points.size(); ++i) {
+        EXPECT_LT(curve.points[i - 1].threshold, curve.points[i].threshold);
+        EXPECT_LE(curve.points[i - 1].recall, curve.points[i].recall);
+    }
+
+    EXPECT_TRUE(PrecisionRecallCurve::merge({}, positives).points.empty());
+}
+
 // Parameterized test for precision@k scenarios  
 class AveragePrecisionParameterizedTest : public ::testing::TestWithParam<std::tuple<std::vector<int>, double>> {};
 
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+
+#include "src/core/pooling/NoPooling.hpp"
+#include "src/core/pooling/DomainSizePooling.hpp"
+#include "src/core/descriptor/extractors/wrappers/SIFTWrapper.hpp"
+#include "src/core/config/ExperimentConfig.hpp"
+
+using thesis_project::config::ExperimentConfig;
+using thesis_project::pooling::DomainSizePooling;
+using thesis_project::pooling::NoPooling;
+using thesis_project::wrappers::SIFTWrapper;
+
+namespace {
+cv::Mat makeGray(int w, int h, int seed) {
+    cv::Mat img(h, w, CV_8UC1, cv::Scalar(0));
+    cv::circle(img, {w/2 + seed, h/2 - seed}, std::min(w,h)/4, cv::Scalar(200), -1);
+    cv::rectangle(img, {10 + seed, 10}, {50, 40 + seed}, cv::Scalar(120), -1);
+    return img;
+}
+std::vector<cv::KeyPoint> gridKps(int w, int h, int step=24, int margin=24) {
+    std::vector<cv::KeyPoint> kps;
+    for (int y=margin;y<h-margin;y+=step) for (int x=margin;x<w-margin;x+=step) kps.emplace_back((float)x,(float)y,12.0f);
+    return kps;
+}
+void expectNear(const cv::Mat& a, const cv::Mat& b, double atol=1e-4) {
+    ASSERT_EQ(a.type(), b.type()); ASSERT_EQ(a.rows,b.rows); ASSERT_EQ(a.cols,b.cols);
+    EXPECT_LE(cv::norm(a, b, cv::NORM_INF), atol);
+}
+void makeScene(std::vector<cv::Mat>& images, std::vector<std::vector<cv::KeyPoint>>& kps) {
+    for (int i = 0; i < 4; ++i) {
+        images.push_back(makeGray(220, 160, 3 * i));
+        kps.push_back(gridKps(220, 160, 24 + 2 * i, 28));
+    }
+}
+}
+
+TEST(PoolingBatchTest, NoPoolingBatchMatchesPerImage) {
+    std::vector<cv::Mat> images; std::vector<std::vector<cv::KeyPoint>> kps;
+    makeScene(images, kps);
+    ExperimentConfig::DescriptorConfig cfg;
+    cfg.type = thesis_project::DescriptorType::SIFT;
+    cfg.params.pooling = thesis_project::PoolingStrategy::NONE;
+
+    SIFTWrapper sift;
+    NoPooling none;
+    auto batch = none.computeDescriptorsBatch(images, kps, sift, cfg);
+    ASSERT_EQ(batch.size(), images.size());
+    for (size_t i = 0; i < images.size(); ++i) {
+        expectNear(batch[i], none.computeDescriptors(images[i], kps[i], sift, cfg));
+    }
+}
+
+TEST(PoolingBatchTest, DomainSizePoolingBatchMatchesPerImage) {
+    std::vector<cv::Mat> images; std::vector<std::vector<cv::KeyPoint>> kps;
+    makeScene(images, kps);
+    ExperimentConfig::DescriptorConfig cfg;
+    cfg.type = thesis_project::DescriptorType::SIFT;
+    cfg.params.pooling = thesis_project::PoolingStrategy::DOMAIN_SIZE_POOLING;
+    cfg.params.scales = {0.75f, 1.0f, 1.5f};
+    cfg.params.scale_weighting = thesis_project::ScaleWeighting::GAUSSIAN;
+
+    SIFTWrapper sift;
+    DomainSizePooling dsp;
+    auto batch = dsp.computeDescriptorsBatch(images, kps, sift, cfg);
+    ASSERT_EQ(batch.size(), images.size());
+    for (size_t i = 0; i < images.size(); ++i) {
+        expectNear(batch[i], dsp.computeDescriptors(images[i], kps[i], sift, cfg));
+    }
+}
+
+TEST(PoolingBatchTest, MismatchedBatchThrows) {
+    std::vector<cv::Mat> images(2, makeGray(64, 64, 0));
+    std::vector<std::vector<cv::KeyPoint>> kps(1);
+    SIFTWrapper sift;
+    EXPECT_THROW(sift.extractBatch(images, kps), std::invalid_argument);
+}
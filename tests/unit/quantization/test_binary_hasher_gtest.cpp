@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+#include <filesystem>
+
+#include "src/core/descriptor/quantization/BinaryHasher.hpp"
+
+using thesis_project::BinaryProjection;
+using thesis_project::quantization::BinaryHasher;
+using thesis_project::quantization::BinaryHashParams;
+
+namespace {
+cv::Mat randomFloat(int rows, int cols, int seed) {
+    cv::Mat m(rows, cols, CV_32F);
+    cv::RNG rng(seed);
+    rng.fill(m, cv::RNG::UNIFORM, 0.0f, 1.0f);
+    return m;
+}
+
+BinaryHashParams params(int bits, BinaryProjection projection) {
+    BinaryHashParams p;
+    p.bits = bits;
+    p.projection = projection;
+    return p;
+}
+
+int hamming(const cv::Mat& a, const cv::Mat& b) {
+    return static_cast<int>(cv::norm(a, b, cv::NORM_HAMMING));
+}
+}
+
+TEST(BinaryHasherTest, PacksOneBitPerProjection) {
+    cv::Mat train = randomFloat(300, 64, 1);
+    auto hasher = BinaryHasher::fit(train, params(128, BinaryProjection::RANDOM));
+    cv::Mat codes = hasher.encode(train);
+    ASSERT_EQ(codes.type(), CV_8U);
+    EXPECT_EQ(codes.rows, 300);
+    EXPECT_EQ(codes.cols, 16);
+    EXPECT_EQ(hasher.codeBytes(), 16);
+}
+
+TEST(BinaryHasherTest, MirroredDescriptorsFlipEveryBit) {
+    // x and 2*mean - x are opposite after centering, so every sign flips
+    cv::Mat train = randomFloat(200, 32, 2);
+    cv::Mat mean;
+    cv::reduce(train, mean, 0, cv::REDUCE_AVG, CV_32F);
+    for (auto projection : {BinaryProjection::RANDOM, BinaryProjection::ITQ}) {
+        auto hasher = BinaryHasher::fit(train, params(32, projection));
+        cv::Mat x = train.rowRange(0, 10);
+        cv::Mat tiled;
+        cv::repeat(mean, x.rows, 1, tiled);
+        cv::Mat mirrored = tiled * 2.0 - x;
+        cv::Mat a = hasher.encode(x);
+        cv::Mat b = hasher.encode(mirrored);
+        for (int r = 0; r < x.rows; ++r) EXPECT_EQ(hamming(a.row(r), b.row(r)), 32);
+    }
+}
+
+TEST(BinaryHasherTest, ItqKeepsNearDuplicatesClose) {
+    cv::Mat train = randomFloat(400, 64, 3);
+    cv::Mat noise(train.size(), CV_32F);
+    cv::RNG(4).fill(noise, cv::RNG::NORMAL, 0.0f, 0.01f);
+    cv::Mat query = train + noise;
+
+    auto hasher = BinaryHasher::fit(train, params(64, BinaryProjection::ITQ));
+    cv::Mat ct = hasher.encode(train);
+    cv::Mat cq = hasher.encode(query);
+    int closer = 0;
+    for (int r = 0; r < 100; ++r) {
+        const int own = hamming(cq.row(r), ct.row(r));
+        const int other = hamming(cq.row(r), ct.row((r + 200) % ct.rows));
+        if (own < other) ++closer;
+    }
+    EXPECT_GE(closer, 95);
+}
+
+TEST(BinaryHasherTest, RejectsInvalidParameters) {
+    cv::Mat train = randomFloat(100, 32, 5);
+    EXPECT_THROW(BinaryHasher::fit(train, params(12, BinaryProjection::RANDOM)), std::invalid_argument);
+    EXPECT_THROW(BinaryHasher::fit(train, params(64, BinaryProjection::ITQ)), std::invalid_argument);
+    EXPECT_THROW(BinaryHasher::fit(cv::Mat(), params(32, BinaryProjection::RANDOM)), std::invalid_argument);
+    auto hasher = BinaryHasher::fit(train, params(64, BinaryProjection::RANDOM));  // random allows bits > width
+    EXPECT_THROW(hasher.encode(randomFloat(2, 16, 6)), std::invalid_argument);
+}
+
+TEST(BinaryHasherTest, SaveLoadRoundTrip) {
+    cv::Mat train = randomFloat(200, 32, 7);
+    auto hasher = BinaryHasher::fit(train, params(32, BinaryProjection::ITQ));
+    const auto path = (std::filesystem::temp_directory_path() / "binary_hasher_test.yml").string();
+    ASSERT_TRUE(hasher.save(path));
+
+    BinaryHasher loaded;
+    ASSERT_TRUE(loaded.load(path));
+    EXPECT_EQ(loaded.bits(), 32);
+    EXPECT_EQ(cv::norm(loaded.encode(train), hasher.encode(train), cv::NORM_INF), 0.0);
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+#include <filesystem>
+
+#include "src/core/descriptor/quantization/ProductQuantizer.hpp"
+
+using thesis_project::quantization::ProductQuantizer;
+using thesis_project::quantization::PQParams;
+
+namespace {
+cv::Mat randomFloat(int rows, int cols, int seed) {
+    cv::Mat m(rows, cols, CV_32F);
+    cv::RNG rng(seed);
+    rng.fill(m, cv::RNG::UNIFORM, 0.0f, 1.0f);
+    return m;
+}
+
+PQParams params(int m, int bits) {
+    PQParams p;
+    p.m = m;
+    p.bits = bits;
+    return p;
+}
+}
+
+TEST(ProductQuantizerTest, EncodesToOneBytePerSubspace) {
+    cv::Mat train = randomFloat(600, 64, 1);
+    auto pq = ProductQuantizer::fit(train, params(8, 6));
+    EXPECT_EQ(pq.centroids(), 64);
+    cv::Mat codes = pq.encode(train);
+    ASSERT_EQ(codes.type(), CV_8U);
+    EXPECT_EQ(codes.rows, 600);
+    EXPECT_EQ(codes.cols, 8);
+    double maxCode = 0.0;
+    cv::minMaxLoc(codes, nullptr, &maxCode);
+    EXPECT_LT(maxCode, 64.0);
+}
+
+TEST(ProductQuantizerTest, AsymmetricDistanceEqualsDistanceToReconstruction) {
+    cv::Mat train = randomFloat(400, 32, 2);
+    cv::Mat query = randomFloat(10, 32, 3);
+    auto pq = ProductQuantizer::fit(train, params(4, 5));
+    cv::Mat codes = pq.encode(train);
+    cv::Mat recon = pq.decode(codes);
+
+    std::vector<float> table(pq.subspaces() * pq.centroids());
+    for (int q = 0; q < query.rows; ++q) {
+        pq.distanceTable(query.ptr<float>(q), table.data());
+        for (int t = 0; t < 50; ++t) {
+            const double expected = cv::norm(query.row(q), recon.row(t), cv::NORM_L2SQR);
+            EXPECT_NEAR(pq.adcDistance(table.data(), codes.ptr<uchar>(t)), expected, 1e-3);
+        }
+    }
+}
+
+TEST(ProductQuantizerTest, MoreSubspacesReconstructBetter) {
+    cv::Mat train = randomFloat(500, 32, 4);
+    auto coarse = ProductQuantizer::fit(train, params(2, 6));
+    auto fine = ProductQuantizer::fit(train, params(8, 6));
+    const double coarseErr = cv::norm(coarse.decode(coarse.encode(train)), train, cv::NORM_L2SQR);
+    const double fineErr = cv::norm(fine.decode(fine.encode(train)), train, cv::NORM_L2SQR);
+    EXPECT_LT(fineErr, coarseErr);
+}
+
+TEST(ProductQuantizerTest, SmallTrainingSetShrinksCodebook) {
+    cv::Mat train = randomFloat(30, 16, 5);
+    auto pq = ProductQuantizer::fit(train, params(4, 8));
+    EXPECT_EQ(pq.centroids(), 30);
+}
+
+TEST(ProductQuantizerTest, RejectsInvalidParameters) {
+    cv::Mat train = randomFloat(100, 30, 6);
+    EXPECT_THROW(ProductQuantizer::fit(train, params(4, 8)), std::invalid_argument);   // 30 % 4 != 0
+    EXPECT_THROW(ProductQuantizer::fit(train, params(5, 9)), std::invalid_argument);   // bits > 8
+    EXPECT_THROW(ProductQuantizer::fit(cv::Mat(), params(5, 8)), std::invalid_argument);
+    auto pq = ProductQuantizer::fit(train, params(5, 4));
+    EXPECT_THROW(pq.encode(randomFloat(3, 20, 7)), std::invalid_argument);
+}
+
+TEST(ProductQuantizerTest, SaveLoadRoundTrip) {
+    cv::Mat train = randomFloat(300, 32, 8);
+    auto pq = ProductQuantizer::fit(train, params(8, 4));
+    const auto path = (std::filesystem::temp_directory_path() / "pq_codebook_test.yml").string();
+    ASSERT_TRUE(pq.save(path));
+
+    ProductQuantizer loaded;
+    ASSERT_TRUE(loaded.load(path));
+    EXPECT_EQ(loaded.dims(), 32);
+    EXPECT_EQ(loaded.subspaces(), 8);
+    EXPECT_EQ(cv::norm(loaded.encode(train), pq.encode(train), cv::NORM_INF), 0.0);
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+
+#include "src/core/descriptor/quantization/ScalarQuantizer.hpp"
+#include "src/core/matching/DistanceKernels.hpp"
+
+using thesis_project::quantization::ScalarQuantizer;
+namespace kernels = thesis_project::matching::kernels;
+
+namespace {
+cv::Mat randomFloat(int rows, int cols, float lo, float hi, int seed) {
+    cv::Mat m(rows, cols, CV_32F);
+    cv::RNG rng(seed);
+    rng.fill(m, cv::RNG::UNIFORM, lo, hi);
+    return m;
+}
+}
+
+TEST(ScalarQuantizerTest, RawSiftValuesAreLossless) {
+    cv::Mat sift(20, 128, CV_32F);
+    cv::RNG(1).fill(sift, cv::RNG::UNIFORM, 0, 200);
+    sift.convertTo(sift, CV_8U);
+    sift.convertTo(sift, CV_32F);  // integral values as produced by cv::SIFT
+
+    auto q = ScalarQuantizer::fit(sift);
+    EXPECT_FLOAT_EQ(q.scale(), 1.0f);
+    EXPECT_FALSE(q.centered());
+    cv::Mat codes = q.quantize(sift);
+    ASSERT_EQ(codes.type(), CV_8U);
+    EXPECT_EQ(cv::norm(q.dequantize(codes), sift, cv::NORM_INF), 0.0);
+}
+
+TEST(ScalarQuantizerTest, NormalizedDescriptorsUseFullRange) {
+    cv::Mat desc = randomFloat(50, 64, 0.0f, 0.25f, 2);
+    auto q = ScalarQuantizer::fit(desc);
+    cv::Mat codes = q.quantize(desc);
+    double maxCode = 0.0;
+    cv::minMaxLoc(codes, nullptr, &maxCode);
+    EXPECT_EQ(maxCode, 255.0);
+    // Reconstruction error is at most half a quantization step
+    EXPECT_LE(cv::norm(q.dequantize(codes), desc, cv::NORM_INF), 0.5 / q.scale() + 1e-6);
+}
+
+TEST(ScalarQuantizerTest, SignedDescriptorsAreCentered) {
+    cv::Mat desc = randomFloat(80, 32, -1.0f, 1.0f, 3) + cv::Scalar(0.3);
+    auto q = ScalarQuantizer::fit(desc);
+    EXPECT_TRUE(q.centered());
+    cv::Mat a = q.quantize(desc.rowRange(0, 40));
+    cv::Mat b = q.quantize(desc.rowRange(40, 80));
+    // Integer distances equal float distances times the scale (within rounding)
+    for (int r = 0; r < 40; ++r) {
+        const double fd = cv::norm(desc.row(r), desc.row(40 + r), cv::NORM_L2);
+        const double qd = cv::norm(a.row(r), b.row(r), cv::NORM_L2) / q.scale();
+        EXPECT_NEAR(qd, fd, 0.05 * fd + 0.05);
+    }
+}
+
+TEST(ScalarQuantizerTest, WidthMismatchThrows) {
+    auto q = ScalarQuantizer::fit(randomFloat(4, 8, 0.0f, 1.0f, 4));
+    EXPECT_THROW(q.quantize(randomFloat(4, 16, 0.0f, 1.0f, 5)), std::invalid_argument);
+    EXPECT_THROW(ScalarQuantizer::fit(cv::Mat()), std::invalid_argument);
+}
+
+TEST(ScalarQuantizerTest, IntegerKernelsMatchOpenCVNorms) {
+    cv::Mat a(70, 131, CV_8U), b(90, 131, CV_8U);  // odd width exercises the scalar tail
+    cv::RNG rng(6);
+    rng.fill(a, cv::RNG::UNIFORM, 0, 256);
+    rng.fill(b, cv::RNG::UNIFORM, 0, 256);
+
+    cv::Mat l2sq = kernels::distanceMatrix(a, b, cv::NORM_L2SQR);
+    cv::Mat l1 = kernels::distanceMatrix(a, b, cv::NORM_L1);
+    for (int r = 0; r < a.rows; r += 7) {
+        for (int c = 0; c < b.rows; c += 5) {
+            EXPECT_EQ(l2sq.at<float>(r, c), static_cast<float>(cv::norm(a.row(r), b.row(c), cv::NORM_L2SQR)));
+            EXPECT_EQ(l1.at<float>(r, c), static_cast<float>(cv::norm(a.row(r), b.row(c), cv::NORM_L1)));
+        }
+    }
+}